@@ -0,0 +1,809 @@
+#include "CodeGenerator.h"
+#include "ConversionKey.h"
+#include "HlslToGlsl.h"
+#include "MappedFile.h"
+#include "ShaderGenerator.h"
+#include "SymbolTable.h"
+#include "SyntaxTree.h"
+#include "Tokenizer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory_resource>
+#include <sstream>
+#include <string>
+#include <vector>
+using namespace std;
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+// Measures the stages of a conversion on the shaders of a directory and on synthetic shaders of increasing size,
+// and writes the results as JSON, one result per line. Given the results of a previous run, flags the stages
+// which got slower or allocate more, and the stages whose time grows faster than the size of the input.
+
+// Counts what the conversion allocates. Every stage takes a memory resource, so this sees all of their allocations
+// but the output string, which the benchmark reuses.
+class CountingResource : public pmr::memory_resource
+{
+public:
+    void ResetCounters()
+    {
+        m_Allocations = 0;
+        m_PeakSizeInBytes = m_LiveSizeInBytes;
+        m_StartSizeInBytes = m_LiveSizeInBytes;
+    }
+
+    size_t GetAllocations() const { return m_Allocations; }
+    size_t GetPeakSizeInBytes() const { return m_PeakSizeInBytes - m_StartSizeInBytes; }
+
+private:
+    size_t m_Allocations = 0;
+    size_t m_LiveSizeInBytes = 0;
+    size_t m_PeakSizeInBytes = 0;
+    size_t m_StartSizeInBytes = 0;
+
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        m_Allocations += 1;
+        m_LiveSizeInBytes += bytes;
+        m_PeakSizeInBytes = max(m_PeakSizeInBytes, m_LiveSizeInBytes);
+
+        return pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* pointer, size_t bytes, size_t alignment) override
+    {
+        m_LiveSizeInBytes -= bytes;
+        pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+    }
+
+    bool do_is_equal(const pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+struct BenchmarkInput
+{
+    string m_Name;
+    string m_Source;
+    bool m_IsVertexShader;
+    string m_Filename;                      // Of the source, read by the read stages
+};
+
+struct BenchmarkResult
+{
+    string m_Input;
+    string m_Stage;
+    size_t m_SizeInBytes = 0;
+    size_t m_Lexemes = 0;
+    double m_Seconds = 0.0;                 // Per conversion, the fastest of the repetitions
+    double m_MegabytesPerSecond = 0.0;
+    double m_LexemesPerSecond = 0.0;
+    double m_AllocationsPerKilobyte = 0.0;
+    size_t m_PeakSizeInBytes = 0;
+
+    // Of the read stages: the resident memory of the process the read added, and the part of it which is a copy
+    // of the file rather than its pages in the page cache
+    size_t m_ResidentBytes = 0;
+    size_t m_AnonymousBytes = 0;
+};
+
+// How the time of a stage grows from a synthetic shader to the next larger one: time grows as size ^ exponent
+struct ScalingResult
+{
+    string m_Stage;
+    string m_From;
+    string m_To;
+    double m_Exponent;
+};
+
+// Cache misses make large inputs a bit slower per byte, so only a clearly steeper growth counts
+const double SUPERLINEAR_EXPONENT = 1.25;
+
+struct BenchmarkSettings
+{
+    double m_MinimumSeconds = 0.2;          // Of each repetition, which converts the input as many times as it takes
+    size_t m_Repetitions = 3;
+    double m_Tolerance = 0.1;               // Relative change above which a comparison reports a regression
+};
+
+// A stage converts the input once, allocating from the resource
+typedef void (*Stage_t)(const BenchmarkInput& input, const HlslToGlsl::LexemeStream& lexemes, CountingResource& resource, string& outputGlsl);
+
+void Tokenize(const BenchmarkInput& input, const HlslToGlsl::LexemeStream& lexemes, CountingResource& resource, string& outputGlsl)
+{
+    HlslToGlsl::SymbolTable symbolTable(false, &resource);
+    HlslToGlsl::LexemeStream stream = HlslToGlsl::ParseIntoLexemes(input.m_Source, symbolTable, &resource);
+}
+
+// What tokenize produced before LexemeStream: a vector<Lexeme> owning a copy of every token, grown one lexeme at a
+// time. The tokens still come from a LexemeStream, which isn't counted, so the time is that of tokenize plus the
+// copies, and the allocations and peak bytes those of the vector alone.
+struct OwnedLexeme
+{
+    HlslToGlsl::TokenClass_t m_TokenClass;
+    pmr::string m_Token;
+};
+
+void TokenizeIntoVector(const BenchmarkInput& input, const HlslToGlsl::LexemeStream& lexemes, CountingResource& resource, string& outputGlsl)
+{
+    HlslToGlsl::SymbolTable symbolTable(false, pmr::new_delete_resource());
+    HlslToGlsl::LexemeStream stream = HlslToGlsl::ParseIntoLexemes(input.m_Source, symbolTable, pmr::new_delete_resource());
+
+    pmr::vector<OwnedLexeme> ownedLexemes(&resource);
+    for (size_t i = 0; i < stream.size(); i++)
+    {
+        ownedLexemes.push_back(OwnedLexeme{ stream.GetTokenClass(i), pmr::string(stream.GetToken(i), &resource) });
+    }
+}
+
+void Preprocess(const BenchmarkInput& input, const HlslToGlsl::LexemeStream& lexemes, CountingResource& resource, string& outputGlsl)
+{
+    const string entryFunctionName = "main";
+    const HlslToGlsl::SyntaxTree syntaxTree = HlslToGlsl::ParseSyntaxTree(lexemes, &resource);
+
+    HlslToGlsl::ConversionContext context(&resource);
+    HlslToGlsl::InitializeConversionContext(lexemes, syntaxTree, entryFunctionName, input.m_IsVertexShader, HlslToGlsl::ConversionOptions(), context);
+
+    pmr::string declarations(&resource);
+    HlslToGlsl::OutputWriter output(declarations);
+    HlslToGlsl::PreprocessTextures(lexemes, context, output);
+}
+
+void Generate(const BenchmarkInput& input, const HlslToGlsl::LexemeStream& lexemes, CountingResource& resource, string& outputGlsl)
+{
+    outputGlsl.clear();
+    HlslToGlsl::ConvertLexemesIntoGlsl(lexemes, "main", input.m_IsVertexShader, outputGlsl, HlslToGlsl::ConversionOptions(), &resource);
+}
+
+void Convert(const BenchmarkInput& input, const HlslToGlsl::LexemeStream& lexemes, CountingResource& resource, string& outputGlsl)
+{
+    outputGlsl.clear();
+    HlslToGlsl::ConvertHlslToGlslFromSource(input.m_Source, "main", input.m_IsVertexShader, outputGlsl, HlslToGlsl::ConversionOptions(), &resource);
+}
+
+// Both emitters write every token between spaces and start a line after each semicolon and curly bracket, into
+// a string allocated from the resource. The first one concatenates temporary strings into an output it never
+// reserves, like the code generator did before OutputWriter. The second one is how it writes now.
+void EmitConcatenated(const BenchmarkInput& input, const HlslToGlsl::LexemeStream& lexemes, CountingResource& resource, string& outputGlsl)
+{
+    pmr::string output(&resource);
+    size_t indentationLevel = 0;
+
+    for (size_t i = 0; i < lexemes.size(); i++)
+    {
+        const HlslToGlsl::TokenClass_t tokenClass = lexemes.GetTokenClass(i);
+        indentationLevel -= (tokenClass == HlslToGlsl::CLOSED_CURLY_BRACKET && indentationLevel > 0) ? 1 : 0;
+
+        output += pmr::string(" ", &resource) + pmr::string(lexemes.GetToken(i), &resource) + " ";
+
+        if (tokenClass == HlslToGlsl::SEMICOLUMN || tokenClass == HlslToGlsl::OPENED_CURLY_BRACKET || tokenClass == HlslToGlsl::CLOSED_CURLY_BRACKET)
+        {
+            indentationLevel += (tokenClass == HlslToGlsl::OPENED_CURLY_BRACKET) ? 1 : 0;
+            output += "\n" + pmr::string(indentationLevel * 4, ' ', &resource);
+        }
+    }
+}
+
+void EmitWithWriter(const BenchmarkInput& input, const HlslToGlsl::LexemeStream& lexemes, CountingResource& resource, string& outputGlsl)
+{
+    pmr::string output(&resource);
+    HlslToGlsl::OutputWriter writer(output);
+    writer.Reserve(lexemes.GetSource().size());
+    writer.SetIndentation("    ");
+
+    for (size_t i = 0; i < lexemes.size(); i++)
+    {
+        const HlslToGlsl::TokenClass_t tokenClass = lexemes.GetTokenClass(i);
+        if (tokenClass == HlslToGlsl::CLOSED_CURLY_BRACKET)
+        {
+            writer.Unindent();
+        }
+
+        writer.Append(" ", lexemes.GetToken(i), " ");
+
+        if (tokenClass == HlslToGlsl::SEMICOLUMN || tokenClass == HlslToGlsl::OPENED_CURLY_BRACKET || tokenClass == HlslToGlsl::CLOSED_CURLY_BRACKET)
+        {
+            if (tokenClass == HlslToGlsl::OPENED_CURLY_BRACKET)
+            {
+                writer.Indent();
+            }
+
+            writer.NewLine();
+        }
+    }
+}
+
+// The generation includes the preprocessing, and the conversion includes everything
+const struct
+{
+    const char* m_Name;
+    Stage_t m_Stage;
+} stages[] = {
+    { "tokenize",           Tokenize },
+    { "tokenize_vector",    TokenizeIntoVector },
+    { "emit_concatenated",  EmitConcatenated },
+    { "emit_writer",        EmitWithWriter },
+    { "preprocess",         Preprocess },
+    { "generate",           Generate },
+    { "convert",            Convert },
+};
+
+// Runs the function as many times as each repetition takes, and returns the time of a run in the fastest repetition
+template <typename Function>
+double MeasureSeconds(const BenchmarkSettings& settings, Function function)
+{
+    double fastestSeconds = 0.0;
+
+    for (size_t repetition = 0; repetition < settings.m_Repetitions; repetition++)
+    {
+        const auto start = chrono::steady_clock::now();
+        double seconds = 0.0;
+        size_t iterations = 0;
+
+        do
+        {
+            function();
+            iterations += 1;
+            seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        }
+        while (seconds < settings.m_MinimumSeconds);
+
+        const double secondsPerIteration = seconds / iterations;
+        if (repetition == 0 || secondsPerIteration < fastestSeconds)
+        {
+            fastestSeconds = secondsPerIteration;
+        }
+    }
+
+    return fastestSeconds;
+}
+
+BenchmarkResult MeasureStage(const BenchmarkInput& input, const HlslToGlsl::LexemeStream& lexemes, const char* stageName, Stage_t stage,
+                             const BenchmarkSettings& settings)
+{
+    CountingResource resource;
+    string outputGlsl;
+
+    BenchmarkResult result;
+    result.m_Input = input.m_Name;
+    result.m_Stage = stageName;
+    result.m_SizeInBytes = input.m_Source.size();
+    result.m_Lexemes = lexemes.size();
+
+    // Counted on a conversion of its own, after a first one which warmed up the output string
+    stage(input, lexemes, resource, outputGlsl);
+    resource.ResetCounters();
+    stage(input, lexemes, resource, outputGlsl);
+
+    const double kilobytes = max(input.m_Source.size() / 1024.0, 1.0 / 1024.0);
+    result.m_AllocationsPerKilobyte = resource.GetAllocations() / kilobytes;
+    result.m_PeakSizeInBytes = resource.GetPeakSizeInBytes();
+
+    result.m_Seconds = MeasureSeconds(settings, [&] () { stage(input, lexemes, resource, outputGlsl); });
+    result.m_MegabytesPerSecond = input.m_Source.size() / (1024.0 * 1024.0) / result.m_Seconds;
+    result.m_LexemesPerSecond = lexemes.size() / result.m_Seconds;
+
+    return result;
+}
+
+// Resident memory of the process, all of it and the part which isn't backed by a file. Both stay at 0 without
+// /proc/self/status.
+struct ResidentMemory
+{
+    size_t m_Total = 0;
+    size_t m_Anonymous = 0;
+};
+
+ResidentMemory GetResidentMemory()
+{
+    ResidentMemory memory;
+
+    ifstream status("/proc/self/status");
+    string line;
+    while (getline(status, line))
+    {
+        if (line.compare(0, 6, "VmRSS:") == 0)
+        {
+            memory.m_Total = (size_t) atoll(line.c_str() + 6) * 1024;
+        }
+        else if (line.compare(0, 8, "RssAnon:") == 0)
+        {
+            memory.m_Anonymous = (size_t) atoll(line.c_str() + 8) * 1024;
+        }
+    }
+
+    return memory;
+}
+
+// Keeps the compiler from dropping the reads
+volatile size_t readChecksum = 0;
+
+// A read stage reads the file and touches every byte, as the tokenizer would. If asked, it also gives the resident
+// memory the read added, sampled while it still holds the content.
+typedef void (*ReadStage_t)(const string& filename, ResidentMemory* addedMemory);
+
+void TouchContent(string_view content, const ResidentMemory& before, ResidentMemory* addedMemory)
+{
+    size_t checksum = 0;
+    for (char c : content)
+    {
+        checksum += (unsigned char) c;
+    }
+
+    readChecksum = readChecksum + checksum;
+
+    if (addedMemory != nullptr)
+    {
+        const ResidentMemory after = GetResidentMemory();
+        addedMemory->m_Total = (after.m_Total > before.m_Total) ? after.m_Total - before.m_Total : 0;
+        addedMemory->m_Anonymous = (after.m_Anonymous > before.m_Anonymous) ? after.m_Anonymous - before.m_Anonymous : 0;
+    }
+}
+
+// How ConvertHlslToGlslFromFile reads its input
+void ReadMapped(const string& filename, ResidentMemory* addedMemory)
+{
+    const ResidentMemory before = (addedMemory != nullptr) ? GetResidentMemory() : ResidentMemory();
+
+    HlslToGlsl::MappedFile file;
+    file.Open(filename);
+    TouchContent(file.GetContent(), before, addedMemory);
+}
+
+// How it read its input before MappedFile: the size from seeking to the end, then the whole file copied into a string
+void ReadWithIfstream(const string& filename, ResidentMemory* addedMemory)
+{
+    const ResidentMemory before = (addedMemory != nullptr) ? GetResidentMemory() : ResidentMemory();
+
+    ifstream file(filename, ios::binary);
+    file.seekg(0, ios::end);
+    const size_t size = (size_t) file.tellg();
+    file.seekg(0, ios::beg);
+
+    string content;
+    content.resize(size);
+    file.read(&content[0], size);
+
+    TouchContent(content, before, addedMemory);
+}
+
+const struct
+{
+    const char* m_Name;
+    ReadStage_t m_Stage;
+} readStages[] = {
+    { "read_mapped",        ReadMapped },
+    { "read_ifstream",      ReadWithIfstream },
+};
+
+BenchmarkResult MeasureRead(const BenchmarkInput& input, const HlslToGlsl::LexemeStream& lexemes, const char* stageName, ReadStage_t stage,
+                            const BenchmarkSettings& settings)
+{
+    BenchmarkResult result;
+    result.m_Input = input.m_Name;
+    result.m_Stage = stageName;
+    result.m_SizeInBytes = input.m_Source.size();
+    result.m_Lexemes = lexemes.size();
+
+    // Sampled on a read of its own, once the file is in the page cache. The memory the other stages freed goes
+    // back to the system first, or a copy would reuse pages which are already resident.
+    ResidentMemory addedMemory;
+    stage(input.m_Filename, nullptr);
+#ifdef __GLIBC__
+    malloc_trim(0);
+#endif
+    stage(input.m_Filename, &addedMemory);
+    result.m_ResidentBytes = addedMemory.m_Total;
+    result.m_AnonymousBytes = addedMemory.m_Anonymous;
+
+    result.m_Seconds = MeasureSeconds(settings, [&] () { stage(input.m_Filename, nullptr); });
+    result.m_MegabytesPerSecond = input.m_Source.size() / (1024.0 * 1024.0) / result.m_Seconds;
+    result.m_LexemesPerSecond = lexemes.size() / result.m_Seconds;
+
+    return result;
+}
+
+// Also written to the temporary directory for the read stages, main deletes the file once done
+BenchmarkInput MakeScaledShader(size_t numberOfFunctions)
+{
+    BenchmarkInput input{ "scaled_" + to_string(numberOfFunctions), GenerateShader(GetScaledSettings(numberOfFunctions)), false };
+
+    error_code error;
+    input.m_Filename = (filesystem::temp_directory_path(error) / ("hlsl-to-glsl-benchmark-" + input.m_Name + ".hlsl")).string();
+
+    ofstream file(input.m_Filename, ios::binary);
+    file << input.m_Source;
+    file.close();
+
+    if (error || file.fail())
+    {
+        input.m_Filename.clear();
+    }
+
+    return input;
+}
+
+// Shaders are named *.vs.hlsl for vertex shaders and *.hlsl for fragment shaders, with main as entry function
+bool ReadShaders(const string& path, vector<BenchmarkInput>& inputs)
+{
+    vector<filesystem::path> filenames;
+    error_code error;
+
+    if (filesystem::is_directory(path, error))
+    {
+        for (const filesystem::directory_entry& entry : filesystem::directory_iterator(path, error))
+        {
+            if (entry.path().extension() == ".hlsl")
+            {
+                filenames.push_back(entry.path());
+            }
+        }
+
+        sort(filenames.begin(), filenames.end());
+    }
+    else
+    {
+        filenames.push_back(path);
+    }
+
+    for (const filesystem::path& filename : filenames)
+    {
+        HlslToGlsl::MappedFile file;
+        if (!file.Open(filename.string()))
+        {
+            cerr << "Couldn't read " << filename.string() << endl;
+            return false;
+        }
+
+        const string name = filename.filename().string();
+        const bool isVertexShader = (name.size() > 8 && name.compare(name.size() - 8, 8, ".vs.hlsl") == 0);
+        inputs.push_back(BenchmarkInput{ name, string(file.GetContent()), isVertexShader, filename.string() });
+    }
+
+    return true;
+}
+
+// Compares the synthetic shaders of consecutive scales, stage by stage
+vector<ScalingResult> ComputeScaling(const vector<BenchmarkResult>& results)
+{
+    vector<ScalingResult> scaling;
+
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        if (results[i].m_Input.compare(0, 7, "scaled_") != 0)
+        {
+            continue;
+        }
+
+        // The next synthetic shader measured with the same stage
+        for (size_t j = i + 1; j < results.size(); j++)
+        {
+            if (results[j].m_Stage == results[i].m_Stage && results[j].m_Input.compare(0, 7, "scaled_") == 0)
+            {
+                const double sizeRatio = (double) results[j].m_SizeInBytes / results[i].m_SizeInBytes;
+                if (sizeRatio > 1.0)
+                {
+                    const double exponent = log(results[j].m_Seconds / results[i].m_Seconds) / log(sizeRatio);
+                    scaling.push_back(ScalingResult{ results[i].m_Stage, results[i].m_Input, results[j].m_Input, exponent });
+                }
+
+                break;
+            }
+        }
+    }
+
+    return scaling;
+}
+
+void WriteResults(const vector<BenchmarkResult>& results, const vector<ScalingResult>& scaling, ostream& output)
+{
+    output << "{\n\"converter_version\": " << HlslToGlsl::CONVERTER_VERSION << ",\n\"results\": [\n";
+
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const BenchmarkResult& result = results[i];
+
+        output << "{\"input\": \"" << result.m_Input << "\", \"stage\": \"" << result.m_Stage << "\", \"bytes\": " << result.m_SizeInBytes
+               << ", \"lexemes\": " << result.m_Lexemes << ", \"seconds\": " << result.m_Seconds << ", \"mb_per_second\": " << result.m_MegabytesPerSecond
+               << ", \"lexemes_per_second\": " << result.m_LexemesPerSecond << ", \"allocations_per_kb\": " << result.m_AllocationsPerKilobyte
+               << ", \"peak_bytes\": " << result.m_PeakSizeInBytes << ", \"resident_bytes\": " << result.m_ResidentBytes << ", \"anonymous_bytes\": "
+               << result.m_AnonymousBytes << "}" << ((i + 1 < results.size()) ? ",\n" : "\n");
+    }
+
+    output << "],\n\"scaling\": [\n";
+
+    for (size_t i = 0; i < scaling.size(); i++)
+    {
+        output << "{\"stage\": \"" << scaling[i].m_Stage << "\", \"from\": \"" << scaling[i].m_From << "\", \"to\": \"" << scaling[i].m_To
+               << "\", \"exponent\": " << scaling[i].m_Exponent << "}" << ((i + 1 < scaling.size()) ? ",\n" : "\n");
+    }
+
+    output << "]\n}\n";
+}
+
+bool FindField(const string& line, const char* name, string& value)
+{
+    const string key = string("\"") + name + "\": ";
+    const size_t start = line.find(key);
+    if (start == string::npos)
+    {
+        return false;
+    }
+
+    size_t begin = start + key.size();
+    size_t end = line.find_first_of(",}", begin);
+    if (begin < line.size() && line[begin] == '"')
+    {
+        begin += 1;
+        end = line.find('"', begin);
+    }
+
+    if (end == string::npos)
+    {
+        return false;
+    }
+
+    value = line.substr(begin, end - begin);
+    return true;
+}
+
+// Reads the results written by WriteResults, one per line
+bool ReadResults(const string& filename, vector<BenchmarkResult>& results)
+{
+    ifstream file(filename);
+    if (!file.is_open())
+    {
+        cerr << "Couldn't read " << filename << endl;
+        return false;
+    }
+
+    string line;
+    while (getline(file, line))
+    {
+        BenchmarkResult result;
+        string megabytesPerSecond;
+        string allocationsPerKilobyte;
+        string peakSizeInBytes;
+
+        if (FindField(line, "input", result.m_Input) && FindField(line, "stage", result.m_Stage) && FindField(line, "mb_per_second", megabytesPerSecond) &&
+            FindField(line, "allocations_per_kb", allocationsPerKilobyte) && FindField(line, "peak_bytes", peakSizeInBytes))
+        {
+            result.m_MegabytesPerSecond = atof(megabytesPerSecond.c_str());
+            result.m_AllocationsPerKilobyte = atof(allocationsPerKilobyte.c_str());
+            result.m_PeakSizeInBytes = (size_t) atoll(peakSizeInBytes.c_str());
+
+            // Not in the results of older versions
+            string anonymousBytes;
+            if (FindField(line, "anonymous_bytes", anonymousBytes))
+            {
+                result.m_AnonymousBytes = (size_t) atoll(anonymousBytes.c_str());
+            }
+
+            results.push_back(result);
+        }
+    }
+
+    return true;
+}
+
+// Prints the stages of the baseline which are slower, allocate more often or use more memory, beyond the
+// tolerance. Returns the number of regressions.
+size_t CompareResults(const vector<BenchmarkResult>& baseline, const vector<BenchmarkResult>& results, double tolerance)
+{
+    size_t numberOfRegressions = 0;
+
+    for (const BenchmarkResult& result : results)
+    {
+        auto previous = find_if(baseline.begin(), baseline.end(), [&result](const BenchmarkResult& candidate) {
+            return candidate.m_Input == result.m_Input && candidate.m_Stage == result.m_Stage;
+        });
+
+        if (previous == baseline.end())
+        {
+            continue;
+        }
+
+        const string name = result.m_Input + " " + result.m_Stage + ": ";
+        if (result.m_MegabytesPerSecond < previous->m_MegabytesPerSecond * (1.0 - tolerance))
+        {
+            cerr << "Regression " << name << previous->m_MegabytesPerSecond << " -> " << result.m_MegabytesPerSecond << " MB/s" << endl;
+            numberOfRegressions += 1;
+        }
+
+        // The counts are exact, a small absolute margin keeps tiny inputs from flagging a single allocation
+        if (result.m_AllocationsPerKilobyte > previous->m_AllocationsPerKilobyte * (1.0 + tolerance) + 0.5)
+        {
+            cerr << "Regression " << name << previous->m_AllocationsPerKilobyte << " -> " << result.m_AllocationsPerKilobyte << " allocations per KB" << endl;
+            numberOfRegressions += 1;
+        }
+
+        if (result.m_PeakSizeInBytes > previous->m_PeakSizeInBytes * (1.0 + tolerance) + 1024)
+        {
+            cerr << "Regression " << name << previous->m_PeakSizeInBytes << " -> " << result.m_PeakSizeInBytes << " peak bytes" << endl;
+            numberOfRegressions += 1;
+        }
+
+        // Resident memory is counted in pages, and the allocator may already have some of them
+        if (result.m_AnonymousBytes > previous->m_AnonymousBytes * (1.0 + tolerance) + 64 * 1024)
+        {
+            cerr << "Regression " << name << previous->m_AnonymousBytes << " -> " << result.m_AnonymousBytes << " anonymous resident bytes" << endl;
+            numberOfRegressions += 1;
+        }
+    }
+
+    return numberOfRegressions;
+}
+
+void PrintUsage(const char* programName)
+{
+    cerr << "Usage: " << programName << " [options] [shader.hlsl | directory]..." << endl;
+    cerr << "Measures tokenize, tokenize_vector (tokenize into a vector<Lexeme> of owned strings instead), emit_concatenated and emit_writer" << endl;
+    cerr << "(every token written by concatenating temporary strings, or with an OutputWriter), preprocess (syntax tree and" << endl;
+    cerr << "PreprocessTextures), generate (ConvertLexemesIntoGlsl), convert (all of them), and read_mapped and read_ifstream (reading the file" << endl;
+    cerr << "with MappedFile or into a string with an ifstream, which also report the resident memory they add)" << endl;
+    cerr << "on the given shaders, the benchmark corpus by default, and on synthetic shaders. *.vs.hlsl files are vertex shaders." << endl;
+    cerr << "Options:" << endl;
+    cerr << "  --output file.json     Write the results there instead of the standard output" << endl;
+    cerr << "  --compare file.json    Report the stages slower or allocating more than in these results, and fail if any or if a" << endl;
+    cerr << "                         stage grows superlinearly with the size of the synthetic shaders" << endl;
+    cerr << "  --tolerance percent    Change tolerated by --compare (default 10)" << endl;
+    cerr << "  --scale N              Also measure a synthetic shader of N functions, can be repeated (default 16, 256 and 4096)," << endl;
+    cerr << "                         see hlsl-to-glsl-generate --scale" << endl;
+    cerr << "  --min-time seconds     Minimum duration of each repetition (default 0.2)" << endl;
+    cerr << "  --repetitions N        Repetitions of each measure, the fastest is kept (default 3)" << endl;
+}
+
+int main(int argc, char** argv)
+{
+    BenchmarkSettings settings;
+    const char* outputFilename = nullptr;
+    const char* baselineFilename = nullptr;
+    vector<size_t> scales;
+    vector<string> paths;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const bool hasValue = (i + 1 < argc);
+
+        if (strcmp(argv[i], "--output") == 0 && hasValue)
+        {
+            outputFilename = argv[++i];
+        }
+        else if (strcmp(argv[i], "--compare") == 0 && hasValue)
+        {
+            baselineFilename = argv[++i];
+        }
+        else if (strcmp(argv[i], "--tolerance") == 0 && hasValue)
+        {
+            settings.m_Tolerance = atof(argv[++i]) / 100.0;
+        }
+        else if (strcmp(argv[i], "--scale") == 0 && hasValue)
+        {
+            scales.push_back(max((size_t) atoll(argv[++i]), (size_t) 1));
+        }
+        else if (strcmp(argv[i], "--min-time") == 0 && hasValue)
+        {
+            settings.m_MinimumSeconds = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--repetitions") == 0 && hasValue)
+        {
+            settings.m_Repetitions = max((size_t) atoll(argv[++i]), (size_t) 1);
+        }
+        else if (strncmp(argv[i], "--", 2) == 0)
+        {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+        else
+        {
+            paths.push_back(argv[i]);
+        }
+    }
+
+    if (paths.empty())
+    {
+        paths.push_back(BENCHMARK_SHADER_DIRECTORY);
+    }
+
+    if (scales.empty())
+    {
+        scales = { 16, 256, 4096 };
+    }
+
+    vector<BenchmarkInput> inputs;
+    for (const string& path : paths)
+    {
+        if (!ReadShaders(path, inputs))
+        {
+            return 1;
+        }
+    }
+
+    for (size_t scale : scales)
+    {
+        inputs.push_back(MakeScaledShader(scale));
+    }
+
+    vector<BenchmarkResult> results;
+    for (const BenchmarkInput& input : inputs)
+    {
+        HlslToGlsl::SymbolTable symbolTable;
+        const HlslToGlsl::LexemeStream lexemes = HlslToGlsl::ParseIntoLexemes(input.m_Source, symbolTable);
+
+        for (const auto& stage : stages)
+        {
+            results.push_back(MeasureStage(input, lexemes, stage.m_Name, stage.m_Stage, settings));
+
+            const BenchmarkResult& result = results.back();
+            cerr << input.m_Name << " " << result.m_Stage << ": " << result.m_MegabytesPerSecond << " MB/s, " << result.m_LexemesPerSecond << " lexemes/s, "
+                 << result.m_AllocationsPerKilobyte << " allocations per KB, " << result.m_PeakSizeInBytes << " peak bytes" << endl;
+        }
+
+        for (const auto& stage : readStages)
+        {
+            if (input.m_Filename.empty())
+            {
+                break;
+            }
+
+            results.push_back(MeasureRead(input, lexemes, stage.m_Name, stage.m_Stage, settings));
+
+            const BenchmarkResult& result = results.back();
+            cerr << input.m_Name << " " << result.m_Stage << ": " << result.m_MegabytesPerSecond << " MB/s, " << result.m_ResidentBytes << " resident bytes, "
+                 << result.m_AnonymousBytes << " of them anonymous" << endl;
+        }
+
+        if (input.m_Name.compare(0, 7, "scaled_") == 0 && !input.m_Filename.empty())
+        {
+            error_code error;
+            filesystem::remove(input.m_Filename, error);
+        }
+    }
+
+    const vector<ScalingResult> scaling = ComputeScaling(results);
+
+    size_t numberOfSuperlinearStages = 0;
+    for (const ScalingResult& result : scaling)
+    {
+        cerr << result.m_Stage << " from " << result.m_From << " to " << result.m_To << ": time grows as size ^ " << result.m_Exponent << endl;
+
+        if (result.m_Exponent > SUPERLINEAR_EXPONENT)
+        {
+            cerr << "Superlinear " << result.m_Stage << " from " << result.m_From << " to " << result.m_To << endl;
+            numberOfSuperlinearStages += 1;
+        }
+    }
+
+    if (outputFilename != nullptr)
+    {
+        ofstream outputFile(outputFilename);
+        WriteResults(results, scaling, outputFile);
+    }
+    else
+    {
+        WriteResults(results, scaling, cout);
+    }
+
+    if (baselineFilename != nullptr)
+    {
+        vector<BenchmarkResult> baseline;
+        if (!ReadResults(baselineFilename, baseline))
+        {
+            return 1;
+        }
+
+        const size_t numberOfRegressions = CompareResults(baseline, results, settings.m_Tolerance) + numberOfSuperlinearStages;
+        cerr << numberOfRegressions << " regressions against " << baselineFilename << endl;
+
+        return (numberOfRegressions == 0) ? 0 : 1;
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include "ShaderGenerator.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+using namespace std;
+
+// Writes a synthetic shader, see ShaderGenerator.h. The same options always write the same file.
+
+void PrintUsage(const char* programName)
+{
+    cerr << "Usage: " << programName << " [options] output_file.hlsl" << endl;
+    cerr << "Options:" << endl;
+    cerr << "  --seed N               Seed of the random choices (default 1)" << endl;
+    cerr << "  --scale N              Start from the settings the benchmark uses for N functions, before the options below" << endl;
+    cerr << "  --vertex               Generate a vertex shader instead of a fragment shader" << endl;
+    cerr << "  --functions N          Number of functions, each one calling the previous one (default 64)" << endl;
+    cerr << "  --statements N         Statements per function (default 4)" << endl;
+    cerr << "  --mul-depth N          Nesting of mul(mul(...)) expressions (default 3)" << endl;
+    cerr << "  --expression-depth N   Nesting of the other expressions (default 3)" << endl;
+    cerr << "  --cbuffers N           Number of cbuffers (default 4)" << endl;
+    cerr << "  --members N            Members of each cbuffer besides its matrix (default 4)" << endl;
+    cerr << "  --textures N           Number of Texture2D (default 4)" << endl;
+    cerr << "  --sampler-states N     Number of SamplerState (default 2)" << endl;
+}
+
+int main(int argc, char** argv)
+{
+    ShaderGeneratorSettings settings;
+    const char* outputFilename = nullptr;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const bool hasValue = (i + 1 < argc);
+        const size_t value = hasValue ? (size_t) atoll(argv[i + 1]) : 0;
+
+        if (strcmp(argv[i], "--vertex") == 0)
+        {
+            settings.m_IsVertexShader = true;
+            continue;
+        }
+        else if (strncmp(argv[i], "--", 2) != 0 && outputFilename == nullptr)
+        {
+            outputFilename = argv[i];
+            continue;
+        }
+        else if (!hasValue)
+        {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+
+        if (strcmp(argv[i], "--seed") == 0)
+        {
+            settings.m_Seed = (uint64_t) strtoull(argv[i + 1], nullptr, 10);
+        }
+        else if (strcmp(argv[i], "--scale") == 0)
+        {
+            const bool isVertexShader = settings.m_IsVertexShader;
+            settings = GetScaledSettings(value, settings.m_Seed);
+            settings.m_IsVertexShader = isVertexShader;
+        }
+        else if (strcmp(argv[i], "--functions") == 0)
+        {
+            settings.m_NumberOfFunctions = value;
+        }
+        else if (strcmp(argv[i], "--statements") == 0)
+        {
+            settings.m_StatementsPerFunction = value;
+        }
+        else if (strcmp(argv[i], "--mul-depth") == 0)
+        {
+            settings.m_MulDepth = value;
+        }
+        else if (strcmp(argv[i], "--expression-depth") == 0)
+        {
+            settings.m_ExpressionDepth = value;
+        }
+        else if (strcmp(argv[i], "--cbuffers") == 0)
+        {
+            settings.m_NumberOfCbuffers = value;
+        }
+        else if (strcmp(argv[i], "--members") == 0)
+        {
+            settings.m_MembersPerCbuffer = value;
+        }
+        else if (strcmp(argv[i], "--textures") == 0)
+        {
+            settings.m_NumberOfTextures = value;
+        }
+        else if (strcmp(argv[i], "--sampler-states") == 0)
+        {
+            settings.m_NumberOfSamplerStates = value;
+        }
+        else
+        {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+
+        i += 1;
+    }
+
+    if (outputFilename == nullptr)
+    {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    ofstream outputFile(outputFilename);
+    outputFile << GenerateShader(settings);
+
+    return outputFile.good() ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,394 @@
+#include "ShaderGenerator.h"
+
+#include <algorithm>
+#include <sstream>
+using namespace std;
+
+// SplitMix64. Unlike the engines and distributions of <random>, it gives the same numbers with every standard
+// library, so a seed names the same shader everywhere.
+class Random
+{
+public:
+    explicit Random(uint64_t seed) : m_State(seed) {}
+
+    uint64_t Next()
+    {
+        uint64_t z = (m_State += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    // In [0, bound), 0 if bound is 0
+    size_t Below(size_t bound) { return (bound == 0) ? 0 : (size_t) (Next() % bound); }
+
+private:
+    uint64_t m_State;
+};
+
+const size_t NUMBER_OF_STATIC_CONSTANTS = 4;
+
+struct GeneratorState
+{
+    const ShaderGeneratorSettings& m_Settings;
+    Random m_Random;
+    ostringstream m_Source;
+
+    // Function being generated, which can call any function before it, and the locals it declared so far
+    size_t m_Function = 0;
+    size_t m_NumberOfLocals = 0;
+};
+
+// Members of cbuffer i: transform<i>, then vector<i>_<j> (float4), scalar<i>_<j> (float), vector<i>_<j> and
+// normal<i>_<j> (float3), repeating. Expressions use the matrices, vectors and scalars.
+bool IsVectorMember(size_t memberIndex)
+{
+    return memberIndex % 4 == 0 || memberIndex % 4 == 2;
+}
+
+void AppendScalar(GeneratorState& state)
+{
+    const ShaderGeneratorSettings& settings = state.m_Settings;
+
+    switch (state.m_Random.Below(3))
+    {
+    case 0:
+        state.m_Source << "K" << state.m_Random.Below(NUMBER_OF_STATIC_CONSTANTS);
+        break;
+
+    case 1:
+        if (settings.m_MembersPerCbuffer > 1)
+        {
+            const size_t member = 1 + 4 * state.m_Random.Below((settings.m_MembersPerCbuffer + 2) / 4);
+            state.m_Source << "scalar" << state.m_Random.Below(settings.m_NumberOfCbuffers) << "_" << member;
+            break;
+        }
+        // Fall through, there are no scalar members
+
+    default:
+        state.m_Source << "0." << (1 + state.m_Random.Below(9));
+        break;
+    }
+}
+
+void AppendVectorMember(GeneratorState& state)
+{
+    const ShaderGeneratorSettings& settings = state.m_Settings;
+
+    if (settings.m_MembersPerCbuffer == 0)
+    {
+        state.m_Source << "float4(0.25, 0.5, 0.75, 1.0)";
+        return;
+    }
+
+    size_t member = state.m_Random.Below(settings.m_MembersPerCbuffer);
+    while (!IsVectorMember(member))
+    {
+        member -= 1;
+    }
+
+    state.m_Source << "vector" << state.m_Random.Below(settings.m_NumberOfCbuffers) << "_" << member;
+}
+
+void AppendVector(GeneratorState& state, size_t depth);
+
+void AppendLeafVector(GeneratorState& state)
+{
+    const ShaderGeneratorSettings& settings = state.m_Settings;
+
+    switch (state.m_Random.Below(6))
+    {
+    case 0:
+        if (state.m_NumberOfLocals > 0)
+        {
+            state.m_Source << "v" << state.m_Random.Below(state.m_NumberOfLocals);
+            break;
+        }
+        // Fall through, there is no local yet
+
+    case 1:
+        state.m_Source << "color";
+        break;
+
+    case 2:
+        state.m_Source << "float4(uv, ";
+        AppendScalar(state);
+        state.m_Source << ", 1.0)";
+        break;
+
+    case 3:
+        // Vertex shaders can't sample without a level of detail, which the converter doesn't support
+        if (!settings.m_IsVertexShader && settings.m_NumberOfTextures > 0 && settings.m_NumberOfSamplerStates > 0)
+        {
+            state.m_Source << "colorTexture" << state.m_Random.Below(settings.m_NumberOfTextures) << ".Sample(samplerState"
+                           << state.m_Random.Below(settings.m_NumberOfSamplerStates) << ", uv)";
+            break;
+        }
+        // Fall through, there is nothing to sample
+
+    case 4:
+        if (state.m_Function > 1)
+        {
+            state.m_Source << "Function" << state.m_Random.Below(state.m_Function - 1) << "(color, uv)";
+            break;
+        }
+        // Fall through, there is no function to call besides the previous one
+
+    default:
+        AppendVectorMember(state);
+        break;
+    }
+}
+
+// mul(mul(mul(x, transform0), transform3), transform1)
+void AppendMul(GeneratorState& state, size_t depth)
+{
+    state.m_Source << "mul(";
+    if (depth > 1)
+    {
+        AppendMul(state, depth - 1);
+    }
+    else
+    {
+        AppendLeafVector(state);
+    }
+
+    state.m_Source << ", transform" << state.m_Random.Below(state.m_Settings.m_NumberOfCbuffers) << ")";
+}
+
+void AppendVector(GeneratorState& state, size_t depth)
+{
+    if (depth == 0)
+    {
+        AppendLeafVector(state);
+        return;
+    }
+
+    switch (state.m_Random.Below(7))
+    {
+    case 0:
+        state.m_Source << "saturate(";
+        AppendVector(state, depth - 1);
+        state.m_Source << ")";
+        break;
+
+    case 1:
+        state.m_Source << "lerp(";
+        AppendVector(state, depth - 1);
+        state.m_Source << ", ";
+        AppendVector(state, depth - 1);
+        state.m_Source << ", ";
+        AppendScalar(state);
+        state.m_Source << ")";
+        break;
+
+    case 2:
+        state.m_Source << "(";
+        AppendVector(state, depth - 1);
+        state.m_Source << " * ";
+        AppendScalar(state);
+        state.m_Source << ")";
+        break;
+
+    case 3:
+        state.m_Source << "(";
+        AppendVector(state, depth - 1);
+        state.m_Source << " + ";
+        AppendVector(state, depth - 1);
+        state.m_Source << ")";
+        break;
+
+    case 4:
+        state.m_Source << "max(";
+        AppendVector(state, depth - 1);
+        state.m_Source << ", ";
+        AppendVector(state, depth - 1);
+        state.m_Source << ")";
+        break;
+
+    case 5:
+        state.m_Source << "abs(";
+        AppendVector(state, depth - 1);
+        state.m_Source << ")";
+        break;
+
+    default:
+        AppendMul(state, max(state.m_Settings.m_MulDepth, (size_t) 1));
+        break;
+    }
+}
+
+void AppendStatement(GeneratorState& state)
+{
+    const ShaderGeneratorSettings& settings = state.m_Settings;
+    const size_t local = (state.m_NumberOfLocals > 0) ? state.m_Random.Below(state.m_NumberOfLocals) : 0;
+
+    switch ((state.m_NumberOfLocals == 0) ? 0 : state.m_Random.Below(4))
+    {
+    case 0:
+        state.m_Source << "    float4 v" << state.m_NumberOfLocals << " = ";
+        AppendVector(state, settings.m_ExpressionDepth);
+        state.m_Source << ";\n";
+        state.m_NumberOfLocals += 1;
+        break;
+
+    case 1:
+        state.m_Source << "    if (v" << local << ".x > ";
+        AppendScalar(state);
+        state.m_Source << ")\n    {\n        v" << local << ".y = v" << local << ".z * ";
+        AppendScalar(state);
+        state.m_Source << ";\n    }\n";
+        break;
+
+    case 2:
+        state.m_Source << "    for (int i" << local << " = 0; i" << local << " < 4; i" << local << "++)\n    {\n        v" << local << " += ";
+        AppendVector(state, 1);
+        state.m_Source << ";\n    }\n";
+        break;
+
+    default:
+        state.m_Source << "    v" << local << " = ";
+        AppendMul(state, max(settings.m_MulDepth, (size_t) 1));
+        state.m_Source << ";\n";
+        break;
+    }
+}
+
+// Every function calls the one before it, which makes the entry function reach all of them
+void AppendFunction(GeneratorState& state, size_t functionIndex)
+{
+    state.m_Function = functionIndex;
+    state.m_NumberOfLocals = 0;
+
+    state.m_Source << "float4 Function" << functionIndex << "(float4 color, float2 uv)\n{\n";
+
+    for (size_t i = 0; i < state.m_Settings.m_StatementsPerFunction; i++)
+    {
+        AppendStatement(state);
+    }
+
+    state.m_Source << "    return ";
+    if (functionIndex > 0)
+    {
+        state.m_Source << "Function" << (functionIndex - 1) << "(";
+        AppendVector(state, state.m_Settings.m_ExpressionDepth);
+        state.m_Source << ", uv * 0.5)";
+    }
+    else
+    {
+        AppendVector(state, state.m_Settings.m_ExpressionDepth);
+    }
+
+    state.m_Source << ";\n}\n\n";
+}
+
+void AppendDeclarations(GeneratorState& state)
+{
+    const ShaderGeneratorSettings& settings = state.m_Settings;
+
+    if (!settings.m_IsVertexShader)
+    {
+        for (size_t i = 0; i < settings.m_NumberOfTextures; i++)
+        {
+            state.m_Source << "Texture2D colorTexture" << i << " : register(t" << i << ");\n";
+        }
+
+        for (size_t i = 0; i < settings.m_NumberOfSamplerStates; i++)
+        {
+            state.m_Source << "SamplerState samplerState" << i << " : register(s" << i << ");\n";
+        }
+
+        state.m_Source << "\n";
+    }
+
+    for (size_t i = 0; i < settings.m_NumberOfCbuffers; i++)
+    {
+        state.m_Source << "cbuffer Constants" << i << " : register(b" << i << ")\n{\n    float4x4 transform" << i << ";\n";
+
+        for (size_t j = 0; j < settings.m_MembersPerCbuffer; j++)
+        {
+            switch (j % 4)
+            {
+            case 1:     state.m_Source << "    float scalar" << i << "_" << j << ";\n"; break;
+            case 3:     state.m_Source << "    float3 normal" << i << "_" << j << ";\n"; break;
+            default:    state.m_Source << "    float4 vector" << i << "_" << j << ";\n"; break;
+            }
+        }
+
+        state.m_Source << "};\n\n";
+    }
+
+    for (size_t i = 0; i < NUMBER_OF_STATIC_CONSTANTS; i++)
+    {
+        state.m_Source << "static const float K" << i << " = 0." << (1 + state.m_Random.Below(9)) << ";\n";
+    }
+
+    state.m_Source << "\n";
+
+    // Members become plain inputs and outputs, so the outputs of a stage don't reuse the names of its inputs. The
+    // outputs of the vertex shader are the inputs of the fragment shader.
+    if (settings.m_IsVertexShader)
+    {
+        state.m_Source << "struct VS_INPUT\n{\n    float3 position : POSITION;\n    float2 uv : TEXCOORD0;\n    float4 color : COLOR0;\n};\n\n";
+        state.m_Source << "struct VS_OUTPUT\n{\n    float4 position : SV_POSITION;\n    float2 texcoord : TEXCOORD0;\n    float4 vertexColor : COLOR0;\n};\n\n";
+    }
+    else
+    {
+        state.m_Source << "struct PS_INPUT\n{\n    float4 position : SV_POSITION;\n    float2 texcoord : TEXCOORD0;\n    float4 vertexColor : COLOR0;\n};\n\n";
+        state.m_Source << "struct PS_OUTPUT\n{\n    float4 target : SV_TARGET0;\n};\n\n";
+    }
+}
+
+void AppendEntryFunction(GeneratorState& state)
+{
+    const size_t lastFunction = state.m_Settings.m_NumberOfFunctions - 1;
+
+    if (state.m_Settings.m_IsVertexShader)
+    {
+        state.m_Source << "VS_OUTPUT main(VS_INPUT input)\n{\n    VS_OUTPUT output;\n";
+        state.m_Source << "    output.position = mul(float4(input.position, 1.0), transform0);\n";
+        state.m_Source << "    output.texcoord = input.uv;\n";
+        state.m_Source << "    output.vertexColor = Function" << lastFunction << "(input.color, input.uv);\n";
+    }
+    else
+    {
+        state.m_Source << "PS_OUTPUT main(PS_INPUT input)\n{\n    PS_OUTPUT output;\n";
+        state.m_Source << "    output.target = Function" << lastFunction << "(input.vertexColor, input.texcoord);\n";
+    }
+
+    state.m_Source << "    return output;\n}\n";
+}
+
+ShaderGeneratorSettings GetScaledSettings(size_t numberOfFunctions, uint64_t seed)
+{
+    ShaderGeneratorSettings settings;
+    settings.m_Seed = seed;
+    settings.m_NumberOfFunctions = max(numberOfFunctions, (size_t) 1);
+    settings.m_NumberOfCbuffers = max(numberOfFunctions / 16, (size_t) 1);
+    settings.m_NumberOfTextures = max(numberOfFunctions / 32, (size_t) 1);
+    settings.m_NumberOfSamplerStates = min(max(numberOfFunctions / 256, (size_t) 1), (size_t) 16);
+
+    return settings;
+}
+
+string GenerateShader(const ShaderGeneratorSettings& settings)
+{
+    // Every cbuffer has a matrix and there is at least the entry function and the one it calls
+    ShaderGeneratorSettings validSettings = settings;
+    validSettings.m_NumberOfCbuffers = max(settings.m_NumberOfCbuffers, (size_t) 1);
+    validSettings.m_NumberOfFunctions = max(settings.m_NumberOfFunctions, (size_t) 1);
+
+    GeneratorState state{ validSettings, Random(settings.m_Seed) };
+    state.m_Source << "// Generated by hlsl-to-glsl-generate, seed " << settings.m_Seed << "\n";
+
+    AppendDeclarations(state);
+
+    for (size_t i = 0; i < validSettings.m_NumberOfFunctions; i++)
+    {
+        AppendFunction(state, i);
+    }
+
+    AppendEntryFunction(state);
+
+    return state.m_Source.str();
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+#ifndef SHADER_GENERATOR_H
+#define SHADER_GENERATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+using namespace std;
+
+// Size and mix of constructs of a generated shader. Every function is reached from the entry function, so none
+// of them is dropped by the converter.
+struct ShaderGeneratorSettings
+{
+    uint64_t m_Seed = 1;
+    bool m_IsVertexShader = false;
+
+    size_t m_NumberOfFunctions = 64;
+    size_t m_StatementsPerFunction = 4;
+    size_t m_MulDepth = 3;                  // Nesting of the mul(mul(...)) expressions
+    size_t m_ExpressionDepth = 3;           // Nesting of the other expressions
+
+    size_t m_NumberOfCbuffers = 4;
+    size_t m_MembersPerCbuffer = 4;         // Besides the matrix every cbuffer has
+
+    // Fragment shaders sample the textures with any of the sampler states, so they get up to
+    // m_NumberOfTextures * m_NumberOfSamplerStates combined samplers. Vertex shaders don't sample.
+    size_t m_NumberOfTextures = 4;
+    size_t m_NumberOfSamplerStates = 2;
+};
+
+// Settings whose shader grows with the number of functions, with cbuffers, textures and sampler states in
+// proportion, i.e. 256 cbuffers and 128 textures for 4096 functions
+ShaderGeneratorSettings GetScaledSettings(size_t numberOfFunctions, uint64_t seed = 1);
+
+// Valid HLSL using only what the converter supports: cbuffers, structs with semantics, Texture2D and SamplerState
+// pairs, static const globals, builtin functions, if and for. The same settings always give the same shader.
+string GenerateShader(const ShaderGeneratorSettings& settings);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,126 @@
+// Forward lighting with a few point lights, normal mapping and fog
+Texture2D albedoTexture : register(t0);
+Texture2D normalTexture : register(t1);
+Texture2D roughnessTexture : register(t2);
+Texture2D shadowTexture : register(t3);
+SamplerState linearSampler : register(s0);
+SamplerState pointSampler : register(s1);
+
+cbuffer Camera : register(b0)
+{
+    float4x4 viewProjection;
+    float3 cameraPosition;
+    float time;
+};
+
+cbuffer Lights : register(b1)
+{
+    float4 lightPositions[4];
+    float4 lightColors[4];
+    float3 ambientColor;
+    float fogDensity;
+    float3 fogColor;
+    float exposure;
+};
+
+struct PS_INPUT
+{
+    float4 position : SV_POSITION;
+    float3 worldPosition : POSITION0;
+    float3 normal : NORMAL;
+    float3 tangent : TANGENT;
+    float2 uv : TEXCOORD0;
+};
+
+struct PS_OUTPUT
+{
+    float4 color : SV_TARGET0;
+};
+
+static const float PI = 3.14159265;
+static const float INVERSE_PI = 1.0 / PI;
+
+float DistributionGgx(float nDotH, float roughness)
+{
+    float a = roughness * roughness;
+    float a2 = a * a;
+    float d = nDotH * nDotH * (a2 - 1.0) + 1.0;
+    return a2 * INVERSE_PI / max(d * d, 0.0001);
+}
+
+float GeometrySchlick(float nDotV, float roughness)
+{
+    float k = (roughness + 1.0) * (roughness + 1.0) / 8.0;
+    return nDotV / (nDotV * (1.0 - k) + k);
+}
+
+float3 FresnelSchlick(float cosTheta, float3 f0)
+{
+    return f0 + (1.0 - f0) * pow(saturate(1.0 - cosTheta), 5.0);
+}
+
+float Attenuation(float distance, float radius)
+{
+    float ratio = saturate(1.0 - pow(distance / radius, 4.0));
+    return ratio * ratio * rcp(distance * distance + 1.0);
+}
+
+float3 ShadeLight(float3 n, float3 v, float3 albedo, float roughness, float3 lightPosition, float3 lightColor, float3 worldPosition)
+{
+    float3 toLight = lightPosition - worldPosition;
+    float distance = length(toLight);
+    float3 l = toLight / distance;
+    float3 h = normalize(v + l);
+
+    float nDotL = saturate(dot(n, l));
+    float nDotV = saturate(dot(n, v)) + 0.0001;
+    float nDotH = saturate(dot(n, h));
+
+    float3 f = FresnelSchlick(saturate(dot(h, v)), lerp(float3(0.04, 0.04, 0.04), albedo, 0.5));
+    float specular = DistributionGgx(nDotH, roughness) * GeometrySchlick(nDotV, roughness) * GeometrySchlick(nDotL, roughness);
+    specular = specular / (4.0 * nDotV * nDotL + 0.0001);
+
+    float3 diffuse = (1.0 - f) * albedo * INVERSE_PI;
+    return (diffuse + f * specular) * lightColor * nDotL * Attenuation(distance, 10.0);
+}
+
+float3 ApplyFog(float3 color, float distance)
+{
+    float fog = 1.0 - exp(-fogDensity * distance);
+    return lerp(color, fogColor, saturate(fog));
+}
+
+float3 ToneMap(float3 color)
+{
+    color = color * exposure;
+    return color / (color + 1.0);
+}
+
+PS_OUTPUT main(PS_INPUT input)
+{
+    PS_OUTPUT output;
+
+    float4 albedo = albedoTexture.Sample(linearSampler, input.uv);
+    float3 normalSample = normalTexture.Sample(linearSampler, input.uv).xyz * 2.0 - 1.0;
+    float roughness = roughnessTexture.Sample(linearSampler, input.uv).r;
+    float shadow = shadowTexture.Sample(pointSampler, input.uv).r;
+
+    float3 bitangent = cross(input.normal, input.tangent);
+    float3 n = normalize(normalSample.x * input.tangent + normalSample.y * bitangent + normalSample.z * input.normal);
+    float3 v = normalize(cameraPosition - input.worldPosition);
+
+    float3 color = ambientColor * albedo.rgb;
+    for (int i = 0; i < 4; i++)
+    {
+        float3 light = ShadeLight(n, v, albedo.rgb, roughness, lightPositions[i].xyz, lightColors[i].rgb, input.worldPosition);
+        if (i == 0)
+        {
+            light = light * shadow;
+        }
+        color += light;
+    }
+
+    color = ApplyFog(color, length(cameraPosition - input.worldPosition));
+    output.color = float4(ToneMap(color), albedo.a);
+    return output;
+}
\ No newline at end of file
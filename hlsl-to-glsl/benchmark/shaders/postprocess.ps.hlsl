@@ -0,0 +1,99 @@
+// Bloom threshold, vignette, chromatic aberration and film grain in a single pass
+Texture2D sceneTexture : register(t0);
+Texture2D bloomTexture : register(t1);
+Texture2D lutTexture : register(t2);
+SamplerState linearClampSampler : register(s0);
+SamplerState pointClampSampler : register(s1);
+
+cbuffer PostProcess : register(b0)
+{
+    float2 inverseResolution;
+    float bloomIntensity;
+    float bloomThreshold;
+    float vignetteStrength;
+    float aberration;
+    float grainAmount;
+    float frameIndex;
+};
+
+struct PS_INPUT
+{
+    float4 position : SV_POSITION;
+    float2 uv : TEXCOORD0;
+};
+
+struct PS_OUTPUT
+{
+    float4 color : SV_TARGET0;
+};
+
+float Luminance(float3 color)
+{
+    return dot(color, float3(0.2126, 0.7152, 0.0722));
+}
+
+float Hash(float2 p)
+{
+    float h = dot(p, float2(127.1, 311.7));
+    return frac(sin(h) * 43758.5453);
+}
+
+float3 Threshold(float3 color)
+{
+    float brightness = Luminance(color);
+    float contribution = max(brightness - bloomThreshold, 0.0) / max(brightness, 0.0001);
+    return color * contribution;
+}
+
+float3 SampleAberrated(float2 uv)
+{
+    float2 direction = (uv - 0.5) * aberration;
+    float r = sceneTexture.Sample(linearClampSampler, uv + direction).r;
+    float g = sceneTexture.Sample(linearClampSampler, uv).g;
+    float b = sceneTexture.Sample(linearClampSampler, uv - direction).b;
+    return float3(r, g, b);
+}
+
+float3 Blur(float2 uv)
+{
+    float3 sum = float3(0.0, 0.0, 0.0);
+    float weightSum = 0.0;
+    for (int x = -2; x <= 2; x++)
+    {
+        for (int y = -2; y <= 2; y++)
+        {
+            float weight = exp(-(x * x + y * y) * 0.25);
+            sum += bloomTexture.Sample(linearClampSampler, uv + float2(x, y) * inverseResolution).rgb * weight;
+            weightSum += weight;
+        }
+    }
+    return sum / weightSum;
+}
+
+float Vignette(float2 uv)
+{
+    float2 centered = uv * 2.0 - 1.0;
+    return saturate(1.0 - dot(centered, centered) * vignetteStrength);
+}
+
+float3 Grade(float3 color)
+{
+    float3 clamped = saturate(color);
+    float2 lutUv = float2(clamped.r * 0.9375 + 0.03125, clamped.g * 0.9375 + 0.03125);
+    return lerp(color, lutTexture.Sample(pointClampSampler, lutUv).rgb, 0.8);
+}
+
+PS_OUTPUT main(PS_INPUT input)
+{
+    PS_OUTPUT output;
+
+    float3 color = SampleAberrated(input.uv);
+    color += Threshold(Blur(input.uv)) * bloomIntensity;
+    color = Grade(color) * Vignette(input.uv);
+
+    float grain = Hash(input.uv * 1000.0 + frameIndex) - 0.5;
+    color += grain * grainAmount;
+
+    output.color = float4(color, 1.0);
+    return output;
+}
\ No newline at end of file
@@ -0,0 +1,84 @@
+// Skinned mesh with four bone influences and a wind sway
+cbuffer Camera : register(b0)
+{
+    float4x4 viewProjection;
+    float3 cameraPosition;
+    float time;
+};
+
+cbuffer Skeleton : register(b2)
+{
+    float4x4 bones[32];
+};
+
+cbuffer Wind : register(b3)
+{
+    float3 windDirection;
+    float windStrength;
+    float windFrequency;
+    float2 swayScale;
+};
+
+struct VS_INPUT
+{
+    float3 position : POSITION;
+    float3 normal : NORMAL;
+    float3 tangent : TANGENT;
+    float2 uv : TEXCOORD0;
+    float4 boneWeights : BLENDWEIGHT;
+    float4 boneIndices : BLENDINDICES;
+};
+
+struct VS_OUTPUT
+{
+    float4 position : SV_POSITION;
+    float3 worldPosition : POSITION0;
+    float3 normal : NORMAL;
+    float3 tangent : TANGENT;
+    float2 uv : TEXCOORD0;
+};
+
+float4x4 BlendBones(float4 weights, float4 indices)
+{
+    float4x4 skin = bones[(int)indices.x] * weights.x;
+    skin += bones[(int)indices.y] * weights.y;
+    skin += bones[(int)indices.z] * weights.z;
+    skin += bones[(int)indices.w] * weights.w;
+    return skin;
+}
+
+float3 Sway(float3 position, float height)
+{
+    float phase = dot(position, float3(0.1, 0.0, 0.1)) + time * windFrequency;
+    float offset = sin(phase) * 0.5 + sin(phase * 2.3) * 0.25;
+    return position + windDirection * offset * windStrength * height * swayScale.x;
+}
+
+float3 SafeNormalize(float3 v)
+{
+    float lengthSquared = dot(v, v);
+    if (lengthSquared <= 0.000001)
+    {
+        return float3(0.0, 1.0, 0.0);
+    }
+    return v * rsqrt(lengthSquared);
+}
+
+VS_OUTPUT main(VS_INPUT input)
+{
+    VS_OUTPUT output;
+
+    float4x4 skin = BlendBones(input.boneWeights, input.boneIndices);
+    float4 skinnedPosition = mul(float4(input.position, 1.0), skin);
+    float3 skinnedNormal = mul(input.normal, (float3x3)skin);
+    float3 skinnedTangent = mul(input.tangent, (float3x3)skin);
+
+    float3 worldPosition = Sway(skinnedPosition.xyz, saturate(input.position.y * swayScale.y));
+
+    output.position = mul(float4(worldPosition, 1.0), viewProjection);
+    output.worldPosition = worldPosition;
+    output.normal = SafeNormalize(skinnedNormal);
+    output.tangent = SafeNormalize(skinnedTangent);
+    output.uv = input.uv;
+    return output;
+}
\ No newline at end of file
@@ -0,0 +1,64 @@
+#ifndef BATCH_CONVERSION_H
+#define BATCH_CONVERSION_H
+
+#include "ConversionOptions.h"
+#include "ConversionStatistics.h"
+
+#include <string>
+#include <vector>
+using namespace std;
+
+namespace HlslToGlsl
+{
+
+// One line of a batch manifest: input_file.hlsl output_file.glsl entryFunctionName {vertex|fragment} [program]
+struct BatchEntry
+{
+    string m_InputFilename;
+    string m_OutputFilename;
+    string m_EntryFunctionName;
+    bool m_IsVertexShader;
+
+    // Entries with the same program are stages linked together: they share a SamplerBindingTable, so that a pair
+    // of sampler state and texture they all use gets a single texture unit. Empty for an entry on its own.
+    string m_Program;
+
+    // If not empty, the combined samplers of the entry and their texture units are written there, see
+    // SamplerBindingTable::WriteMetadata. For a program, those of all of its stages.
+    string m_SamplerMetadataFilename;
+};
+
+struct BatchResult
+{
+    bool m_Succeeded;
+    string m_Error;
+
+    // Sizes before and after the minification, if the options minify and the entry wasn't found in the cache
+    MinificationStatistics m_Minification;
+
+    // Whether the output was loaded from the cache rather than converted
+    bool m_LoadedFromCache;
+
+    // Phases, lexemes and allocations of the conversion of the entry, if the options have conversion statistics
+    ConversionStatistics m_Statistics;
+};
+
+// Reads a manifest, one entry per line. Empty lines and lines starting with # are skipped.
+bool ReadBatchManifest(const string& filename, vector<BatchEntry>& entries, string& error);
+
+class DiskCache;
+class SymbolTable;
+
+// Converts every entry on numberOfThreads threads (0 to use every hardware thread) and writes the outputs.
+// Results are returned in the same order as the entries, no matter which thread converted them. The stages of a
+// program are converted in manifest order by the same thread, as their sampler binding table isn't thread safe.
+// They don't use the cache, since their texture units depend on each other.
+// The same options apply to every entry, without statistics but the minification and the conversion statistics of each
+// entry in its result. The conversion statistics of the options, if any, receive the sum of them all. If given, the
+// symbol table must be shared: every conversion interns its identifiers in it.
+vector<BatchResult> ConvertBatch(const vector<BatchEntry>& entries, size_t numberOfThreads, const ConversionOptions& options = ConversionOptions(),
+                                 DiskCache* cache = nullptr, SymbolTable* sharedSymbolTable = nullptr);
+
+}
+
+#endif
\ No newline at end of file
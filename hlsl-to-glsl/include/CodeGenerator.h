@@ -1,19 +1,119 @@
 #ifndef CODE_GENERATOR_H
 #define CODE_GENERATOR_h
 
+#include "ConstantFolding.h"
+#include "ConversionOptions.h"
+#include "OutputWriter.h"
+#include "SamplerBindings.h"
+#include "SyntaxTree.h"
 #include "Tokenizer.h"
+#include "UniformBlockLayout.h"
 
-#include <vector>
+#include <cstdint>
+#include <memory_resource>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 using namespace std;
 
 namespace HlslToGlsl
 {
 
-void ConvertLexemesIntoGlsl(const vector<Lexeme>& lexemes, const string& entryFunctionName, bool isVertexShader, string& outputGlsl);
+// What the code generator knows about a symbol of the conversion
+enum SymbolFlag_t : uint8_t
+{
+    SYMBOL_STRUCT_NAME = 1 << 0,
+    SYMBOL_SEMANTIC_STRUCT_NAME = 1 << 1,
+    SYMBOL_SEMANTIC_STRUCT_VARIABLE = 1 << 2,
+    SYMBOL_TEXTURE_NAME = 1 << 3,
+    SYMBOL_UV_NAME = 1 << 4,
+};
+
+// Layout of a cbuffer the entry function reaches
+struct UniformBlock
+{
+    LexemeIndex_t m_Name;
+    LexemeIndex_t m_OpenedCurlyBracket;
+    bool m_IsAnalyzed;                  // False if the layout of some member isn't known, the block is then declared as is
+    UniformBlockLayout m_Layout;
+};
+
+// State of one conversion. Each call to ConvertLexemesIntoGlsl owns its own context, which makes conversions
+// independent from each other and safe to run concurrently. Everything in it is allocated from the memory
+// resource of the conversion.
+struct ConversionContext
+{
+    explicit ConversionContext(pmr::memory_resource* memoryResource = pmr::get_default_resource());
+
+    pmr::memory_resource* m_MemoryResource;
+    const SyntaxTree* m_SyntaxTree = nullptr;
+
+    // Top level declarations the entry function doesn't reach, which aren't emitted
+    pmr::vector<LexemeRange> m_UnreachableCode;
+
+    // Lexemes emitted as something else, such as the value of a constant expression
+    pmr::vector<LexemeReplacement> m_Replacements;
+
+    // Reachable cbuffers, in order. Their layouts are computed before the code is generated, as the members read
+    // from a register are replaced by the read wherever they are used.
+    pmr::vector<UniformBlock> m_UniformBlocks;
+
+    // Flags of each symbol of the lexeme stream, indexed by symbol identifier
+    pmr::vector<uint8_t> m_SymbolFlags;
+    SymbolId_t m_SampleSymbol = INVALID_SYMBOL_ID;
+    SymbolId_t m_EntryFunctionSymbol = INVALID_SYMBOL_ID;
+
+    // Body of the entry function and the name of its first parameter, whose members are the only UV coordinates
+    // it declares inverted copies of
+    LexemeRange m_EntryFunctionBody = { 0, 0 };
+    SymbolId_t m_EntryFunctionInputSymbol = INVALID_SYMBOL_ID;
+
+    bool m_InsideOfStruct = false;
+    bool m_HadAnySemanticsInStruct = false;
+    SymbolId_t m_CurrentStructSymbol = INVALID_SYMBOL_ID;
+    bool m_IsOutputSemanticStruct = false;
+
+    pmr::string m_StructBufferIfNoSemanticsInStruct;
+    pmr::vector<pmr::string> m_Semantics;
+
+    bool m_MightAddSemanticStructNameToIgnore = false;
+    bool m_IsInEntryFunction = false;
+    size_t m_EntryFunctionLevel = 0;
+
+    // GLSL name of the combined sampler declared for each sampler state and texture pair of symbols
+    pmr::unordered_map<uint64_t, pmr::string> m_SamplerStateTextureNames;
+
+    pmr::vector<SymbolId_t> m_UvNames;
+    pmr::vector<pmr::string> m_SemanticsForUvNames;
+
+    SymbolId_t m_GlPositionSymbol = INVALID_SYMBOL_ID;
+    SymbolId_t m_EntryFunctionParameterSymbol = INVALID_SYMBOL_ID;
+
+    // Flavor of the generated GLSL, which decides how intrinsics are lowered and how resources are bound
+    const GlslProfile* m_Profile = nullptr;
+    bool m_PrecisionQualifiers = false;
+
+    // Texture units of the combined samplers, shared with other conversions if not null
+    SamplerBindingTable* m_SamplerBindings = nullptr;
+
+    // Receives the layout of each cbuffer, if not null
+    vector<UniformBlockStatistics>* m_UniformBlockStatistics = nullptr;
+
+    // Arguments of ConvertLexemesIntoGlsl, for the parts of an expression which are converted on their own
+    const string* m_EntryFunctionName = nullptr;
+    bool m_IsVertexShader = false;
+};
+
+void ConvertLexemesIntoGlsl(const LexemeStream& lexemes, const string& entryFunctionName, bool isVertexShader, string& outputGlsl,
+                            const ConversionOptions& options = ConversionOptions(), pmr::memory_resource* memoryResource = pmr::get_default_resource());
 
-vector<string> PreprocessTextures(const vector<Lexeme>& lexemes, string& outputGlsl);
-void InterpretLexeme(const vector<Lexeme>& lexemes, const string& entryFunctionName, const vector<string>& originalTextureNames, size_t& lexemeIndex, bool isVertexShader, string& outputGlsl);
+// The first stages of ConvertLexemesIntoGlsl, for the tools which measure them on their own. The context then refers
+// to the syntax tree, which must outlive it.
+void InitializeConversionContext(const LexemeStream& lexemes, const SyntaxTree& syntaxTree, const string& entryFunctionName, bool isVertexShader,
+                                 const ConversionOptions& options, ConversionContext& context);
+void PreprocessTextures(const LexemeStream& lexemes, ConversionContext& context, OutputWriter& output);
+void InterpretLexeme(const LexemeStream& lexemes, ConversionContext& context, const string& entryFunctionName, size_t& lexemeIndex, bool isVertexShader, OutputWriter& output);
 
 }
 
@@ -0,0 +1,42 @@
+#ifndef CONSTANT_FOLDING_H
+#define CONSTANT_FOLDING_H
+
+#include "ConversionOptions.h"
+#include "SyntaxTree.h"
+
+#include <memory_resource>
+#include <string>
+#include <vector>
+using namespace std;
+
+namespace HlslToGlsl
+{
+
+// Lexemes the code generator emits as the given GLSL instead, which is empty for removed lexemes
+struct LexemeReplacement
+{
+    LexemeRange m_Range;
+    pmr::string m_Glsl;
+};
+
+// Finds the expressions of the reachable code whose value is known, and the operations which don't change
+// their operand:
+//  - Constant expressions made of literals, static const globals, +, -, *, /, casts and constructors of scalars,
+//    and of the builtin functions abs, ceil, floor, max, min, rsqrt, saturate and sqrt, become their value
+//  - x * 1, x / 1, x + 0, x - 0, 1 * x and 0 + x become x, when the operators around them keep the same meaning
+//  - The initializers of static const scalar globals are evaluated, and their value is then known wherever the
+//    name isn't redeclared
+// Expressions are only folded as a whole: the right hand side of an assignation, a returned value, the content
+// of a paranthesis or of an angle bracket, or an argument of a call. Arithmetic on floats is done on 32 bits,
+// as the GPU would, and an expression whose value isn't finite is left as is.
+//
+// Returns the replacements in order of lexemes.
+pmr::vector<LexemeReplacement> FoldConstants(const LexemeStream& lexemes, const SyntaxTree& syntaxTree, const pmr::vector<LexemeRange>& unreachableCode,
+                                             ConstantFoldingStatistics* statistics, pmr::memory_resource* memoryResource = pmr::get_default_resource());
+
+// Replacement starting at a lexeme, nullptr if there is none
+const LexemeReplacement* FindReplacement(const pmr::vector<LexemeReplacement>& replacements, size_t lexemeIndex);
+
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,46 @@
+#ifndef CONVERSION_ARENA_H
+#define CONVERSION_ARENA_H
+
+#include <memory>
+#include <memory_resource>
+#include <vector>
+using namespace std;
+
+namespace HlslToGlsl
+{
+
+// Monotonic arena for everything a conversion allocates. Nothing is freed during the conversion, and Reset
+// releases it all in one shot. A long running process keeps one arena per thread and resets it between
+// conversions: the arena grows its block to the largest conversion seen so far, so once it is warm a
+// conversion doesn't allocate from the heap at all.
+class ConversionArena
+{
+public:
+    explicit ConversionArena(size_t initialSizeInBytes = 64 * 1024);
+
+    pmr::memory_resource* GetResource() { return m_Resource.get(); }
+    void Reset();
+
+    size_t GetBlockSize() const { return m_Block.size(); }
+
+private:
+    // Keeps track of how much the arena had to take from the heap once its block was full
+    class OverflowResource : public pmr::memory_resource
+    {
+    public:
+        size_t m_AllocatedSizeInBytes = 0;
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void* pointer, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const pmr::memory_resource& other) const noexcept override { return this == &other; }
+    };
+
+    vector<char> m_Block;
+    OverflowResource m_Overflow;
+    unique_ptr<pmr::monotonic_buffer_resource> m_Resource;
+};
+
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,80 @@
+#ifndef CONVERSION_CACHE_H
+#define CONVERSION_CACHE_H
+
+#include "ConversionKey.h"
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+using namespace std;
+
+namespace HlslToGlsl
+{
+
+struct ConversionCacheStatistics
+{
+    size_t m_Hits;
+    size_t m_Misses;
+    size_t m_Evictions;
+    size_t m_SizeInBytes;
+};
+
+// In memory cache of conversion results, for programs converting shaders at runtime. Results are shared,
+// immutable strings: a hit hands out the same buffer to every caller instead of copying it. The cache is
+// split in shards, each with its own lock and its own least recently used list, so that threads converting
+// different shaders rarely wait for each other.
+class ConversionCache
+{
+public:
+    ConversionCache(size_t maximumSizeInBytes, size_t numberOfShards = 16);
+
+    // Returns the GLSL for the source, converting it only if it isn't cached already. Returns nullptr if the
+    // conversion fails. The conversion itself runs outside of any lock. Conversions given a sampler binding table
+    // or gathering the statistics of the uniform blocks always run, and aren't cached.
+    shared_ptr<const string> Convert(string_view hlslSource, const string& entryFunctionName, bool isVertexShader,
+                                     const ConversionOptions& options = ConversionOptions());
+
+    shared_ptr<const string> Find(const ConversionKey& key);
+    void Insert(const ConversionKey& key, const shared_ptr<const string>& outputGlsl);
+
+    void Clear();
+    ConversionCacheStatistics GetStatistics() const;
+
+private:
+    struct KeyHasher
+    {
+        size_t operator()(const ConversionKey& key) const { return (size_t) key.m_Hash[1]; }
+    };
+
+    struct Entry
+    {
+        ConversionKey m_Key;
+        shared_ptr<const string> m_OutputGlsl;
+    };
+
+    // Most recently used entries are at the front of the list
+    struct Shard
+    {
+        mutable mutex m_Mutex;
+        list<Entry> m_Entries;
+        unordered_map<ConversionKey, list<Entry>::iterator, KeyHasher> m_EntriesByKey;
+        size_t m_SizeInBytes = 0;
+        size_t m_Hits = 0;
+        size_t m_Misses = 0;
+        size_t m_Evictions = 0;
+    };
+
+    Shard& GetShard(const ConversionKey& key) { return m_Shards[key.m_Hash[0] % m_Shards.size()]; }
+    static size_t GetEntrySize(const Entry& entry);
+
+    size_t m_MaximumShardSizeInBytes;
+    vector<Shard> m_Shards;
+};
+
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,35 @@
+#ifndef CONVERSION_KEY_H
+#define CONVERSION_KEY_H
+
+#include "ConversionOptions.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+using namespace std;
+
+namespace HlslToGlsl
+{
+
+// Must be incremented by every change that modifies the GLSL generated for a given input, so that
+// results cached by an older converter are never returned
+const uint32_t CONVERTER_VERSION = 10;
+
+// Identifies the result of a conversion: a 128 bits hash of the source bytes, of every parameter of the
+// conversion and of the converter version
+struct ConversionKey
+{
+    uint64_t m_Hash[2];
+
+    bool operator==(const ConversionKey& other) const { return m_Hash[0] == other.m_Hash[0] && m_Hash[1] == other.m_Hash[1]; }
+    bool operator!=(const ConversionKey& other) const { return !(*this == other); }
+
+    string ToString() const;
+};
+
+ConversionKey ComputeConversionKey(string_view hlslSource, const string& entryFunctionName, bool isVertexShader,
+                                   const ConversionOptions& options = ConversionOptions());
+
+}
+
+#endif
\ No newline at end of file
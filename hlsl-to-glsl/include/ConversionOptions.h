@@ -0,0 +1,96 @@
+#ifndef CONVERSION_OPTIONS_H
+#define CONVERSION_OPTIONS_H
+
+#include "GlslProfile.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+using namespace std;
+
+namespace HlslToGlsl
+{
+
+// What the constant folding stage did. Operations are arithmetic operators, builtin function calls, casts and
+// constructors, counted in the code reachable from the entry function.
+struct ConstantFoldingStatistics
+{
+    size_t m_Operations = 0;
+    size_t m_RemovedOperations = 0;
+    size_t m_FoldedExpressions = 0;
+    size_t m_RemovedIdentities = 0;
+    size_t m_EvaluatedConstants = 0;    // static const globals whose value is known
+};
+
+// What the minification did. Sizes are those of the generated code, without the #version line.
+struct MinificationStatistics
+{
+    size_t m_OriginalSize = 0;
+    size_t m_MinifiedSize = 0;
+    size_t m_RenamedIdentifiers = 0;
+};
+
+// Layout of a cbuffer. HLSL packs its members in registers of 16 bytes, and the uniform block gets padding members,
+// or reads some members from a vec4 holding their register, so that std140 gives them the same offsets.
+struct UniformBlockStatistics
+{
+    string m_Name;
+    bool m_IsAnalyzed = false;          // False if the layout of some member isn't known, the block is then declared as is
+    bool m_MatchesHlsl = false;         // False if std140 places some members elsewhere than HLSL does
+    size_t m_Size = 0;                  // Size of the constant buffer
+    size_t m_WastedBytes = 0;           // Bytes of m_Size no member uses
+    size_t m_PackedSize = 0;            // Size of the constant buffer with its members reordered to fill the registers
+    size_t m_PaddingMembers = 0;
+    size_t m_RegisterMembers = 0;       // Members read from a vec4
+};
+
+// Optional stages of a conversion. Every option that changes the generated GLSL is part of the ConversionKey.
+class SamplerBindingTable;
+struct ConversionStatistics;
+
+struct ConversionOptions
+{
+    // Version and flavor of the generated GLSL
+    GlslProfile_t m_Profile = GLSL_PROFILE_420;
+
+    // Evaluates constant expressions and removes identity operations such as x * 1.0
+    bool m_FoldConstants = false;
+
+    // Receives what the constant folding did, if not null. Not part of the key: a result found in a cache
+    // reports nothing.
+    ConstantFoldingStatistics* m_ConstantFoldingStatistics = nullptr;
+
+    // Declares half, min16float and the other reduced precision types mediump or lowp instead of full precision,
+    // below a header which makes everything else highp. Meant for GLSL ES GPUs, desktop GLSL ignores them. GLSL ES
+    // profiles always get the header.
+    bool m_PrecisionQualifiers = false;
+
+    // Receives the combined samplers and their texture units, if not null. Pairs of sampler state and texture
+    // already in the table keep their unit, so it can be shared by the stages of a program. The generated GLSL
+    // then depends on the table, and the conversion doesn't use the cache.
+    SamplerBindingTable* m_SamplerBindings = nullptr;
+
+    // Drops comments and the whitespace GLSL doesn't need, and with m_RenameLocals also shortens the names of
+    // parameters and local variables
+    bool m_Minify = false;
+    bool m_RenameLocals = false;
+
+    // Receives what the minification did, if not null. Not part of the key either.
+    MinificationStatistics* m_MinificationStatistics = nullptr;
+
+    // Receives the layout of each cbuffer the entry function reaches, if not null. Not part of the key either, the
+    // conversion doesn't use the cache.
+    vector<UniformBlockStatistics>* m_UniformBlockStatistics = nullptr;
+
+    // Set to whether ConvertHlslToGlslFromFile loaded the output from its cache instead of converting, if not null.
+    // Not part of the key either. A loaded output comes without the folding and minification statistics.
+    bool* m_LoadedFromCache = nullptr;
+
+    // Receives the time of each phase, the lexemes and the allocations, if not null. Not part of the key either.
+    // Without statistics a conversion neither reads the clock nor counts anything.
+    ConversionStatistics* m_ConversionStatistics = nullptr;
+};
+
+}
+
+#endif
\ No newline at end of file
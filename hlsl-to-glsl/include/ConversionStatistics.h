@@ -0,0 +1,100 @@
+#ifndef CONVERSION_STATISTICS_H
+#define CONVERSION_STATISTICS_H
+
+#include "Tokenizer.h"
+
+#include <chrono>
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+using namespace std;
+
+namespace HlslToGlsl
+{
+
+const size_t NUMBER_OF_TOKEN_CLASSES = TEXTURE + 1;
+
+// Where the time of conversions went and what they produced. Every field adds up, so the same statistics can
+// gather the conversions of a thread. The phases run in this order, and a phase a conversion skips stays at 0.
+struct ConversionStatistics
+{
+    size_t m_Conversions = 0;
+    size_t m_CacheHits = 0;                 // Conversions whose output came from the cache, they have no other phase
+
+    double m_ReadSeconds = 0.0;             // Mapping the file
+    double m_CacheSeconds = 0.0;            // Hashing the source and options, loading or storing the output
+    double m_TokenizeSeconds = 0.0;         // Splitting the source, classifying and interning the tokens, in a single pass
+    double m_AnalysisSeconds = 0.0;         // Syntax tree, dead code elimination and constant folding
+    double m_PreprocessSeconds = 0.0;       // PreprocessTextures and the helper functions of the intrinsics
+    double m_EmissionSeconds = 0.0;
+    double m_MinificationSeconds = 0.0;
+
+    size_t m_SourceBytes = 0;
+    size_t m_OutputBytes = 0;
+    size_t m_Lexemes = 0;
+    size_t m_LexemesPerTokenClass[NUMBER_OF_TOKEN_CLASSES] = {};
+
+    // Taken from the memory resource of the conversions, the output string not included
+    size_t m_Allocations = 0;
+    size_t m_AllocatedBytes = 0;
+
+    double GetTotalSeconds() const;
+    void Add(const ConversionStatistics& other);
+};
+
+// Measures consecutive phases: each lap adds the time since the previous one to a phase. Without statistics
+// the clock is never read.
+class PhaseClock
+{
+public:
+    explicit PhaseClock(ConversionStatistics* statistics)
+        : m_Statistics(statistics)
+    {
+        if (m_Statistics != nullptr)
+        {
+            m_LastLap = chrono::steady_clock::now();
+        }
+    }
+
+    void Lap(double ConversionStatistics::*phase)
+    {
+        if (m_Statistics != nullptr)
+        {
+            const chrono::steady_clock::time_point now = chrono::steady_clock::now();
+            m_Statistics->*phase += chrono::duration<double>(now - m_LastLap).count();
+            m_LastLap = now;
+        }
+    }
+
+private:
+    ConversionStatistics* m_Statistics;
+    chrono::steady_clock::time_point m_LastLap;
+};
+
+// Counts what a conversion allocates from the memory resource it was given
+class CountingMemoryResource : public pmr::memory_resource
+{
+public:
+    CountingMemoryResource(pmr::memory_resource* upstream, ConversionStatistics& statistics)
+        : m_Upstream(upstream)
+        , m_Statistics(statistics)
+    {
+    }
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* pointer, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    pmr::memory_resource* m_Upstream;
+    ConversionStatistics& m_Statistics;
+};
+
+string_view GetTokenClassName(TokenClass_t tokenClass);
+
+// One JSON object, with the phases in seconds and the lexemes by token class
+void WriteConversionStatisticsAsJson(const ConversionStatistics& statistics, string& json);
+
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,32 @@
+#ifndef DEAD_CODE_ELIMINATION_H
+#define DEAD_CODE_ELIMINATION_H
+
+#include "SyntaxTree.h"
+
+#include <memory_resource>
+#include <vector>
+using namespace std;
+
+namespace HlslToGlsl
+{
+
+// Finds the top level declarations which the entry function never reaches: functions, structs, cbuffers,
+// textures, sampler states and global variables. A declaration is reached if the entry function, or
+// anything it reaches, uses one of the names it declares. Declarations which don't declare any name are
+// always kept.
+//
+// cbuffers are kept or dropped as a whole: removing one of their members would change the layout of the
+// uniform block, which has to match the buffer the application binds.
+//
+// Returns the lexemes of the unreachable declarations, in order. Nothing is unreachable if the entry
+// function isn't defined.
+pmr::vector<LexemeRange> FindUnreachableCode(const LexemeStream& lexemes, const SyntaxTree& syntaxTree, SymbolId_t entryFunctionSymbol,
+                                             pmr::memory_resource* memoryResource = pmr::get_default_resource());
+
+// First lexeme at or after lexemeIndex which isn't unreachable. The cursor is the first range that might
+// still be ahead, start it at 0 and walk the lexemes in order.
+size_t SkipUnreachableCode(const pmr::vector<LexemeRange>& unreachableCode, size_t& cursor, size_t lexemeIndex);
+
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,55 @@
+#ifndef DISK_CACHE_H
+#define DISK_CACHE_H
+
+#include "ConversionKey.h"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+using namespace std;
+
+namespace HlslToGlsl
+{
+
+struct DiskCacheStatistics
+{
+    size_t m_Hits;
+    size_t m_Misses;
+    size_t m_Stores;
+    size_t m_Evictions;
+};
+
+// Content addressed cache of conversion results, stored as one file per ConversionKey in a directory.
+// Several threads and several processes can share the same directory: files are written to a temporary
+// name and renamed in place, so readers only ever see complete results. When the directory grows above
+// its maximum size, the least recently used results are deleted.
+class DiskCache
+{
+public:
+    DiskCache(const string& directory, uint64_t maximumSizeInBytes);
+
+    bool Load(const ConversionKey& key, string& outputGlsl);
+    void Store(const ConversionKey& key, const string& outputGlsl);
+
+    DiskCacheStatistics GetStatistics() const;
+
+private:
+    void EvictLeastRecentlyUsed();
+
+    string m_Directory;
+    uint64_t m_MaximumSizeInBytes;
+
+    // Estimate of the size of the directory, recomputed every time entries are evicted
+    atomic<uint64_t> m_SizeInBytes;
+    mutex m_EvictionMutex;
+
+    atomic<size_t> m_Hits;
+    atomic<size_t> m_Misses;
+    atomic<size_t> m_Stores;
+    atomic<size_t> m_Evictions;
+};
+
+}
+
+#endif
\ No newline at end of file
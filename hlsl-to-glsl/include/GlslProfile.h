@@ -0,0 +1,40 @@
+#ifndef GLSL_PROFILE_H
+#define GLSL_PROFILE_H
+
+#include <cstdint>
+#include <string_view>
+using namespace std;
+
+namespace HlslToGlsl
+{
+
+// Flavors of GLSL the converter can generate
+enum GlslProfile_t : uint8_t
+{
+    GLSL_PROFILE_330,
+    GLSL_PROFILE_420,
+    GLSL_PROFILE_450,
+    GLSL_PROFILE_ES_300,
+    GLSL_PROFILE_ES_310,
+    GLSL_PROFILE_ES_320,
+    GLSL_PROFILE_VULKAN,
+};
+
+struct GlslProfile
+{
+    string_view m_Name;                 // Name of the profile on the command line
+    string_view m_VersionDirective;
+    uint32_t m_Version;                 // Desktop GLSL version with the same builtin functions, which decides how intrinsics are lowered
+    bool m_IsEs;                        // Needs a default precision for floats
+    bool m_HasBindings;                 // Supports layout(binding = N) on uniform blocks
+    bool m_IsVulkan;                    // Needs a set and a binding on every uniform block and sampler, and a location on every input and output
+};
+
+const GlslProfile& GetGlslProfile(GlslProfile_t profile);
+
+// Returns false if no profile has this name
+bool FindGlslProfile(string_view name, GlslProfile_t& profile);
+
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,22 @@
+#ifndef HASH_H
+#define HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+using namespace std;
+
+namespace HlslToGlsl
+{
+
+// Fast non-cryptographic 64 bits hash (MurmurHash64A), used to key the conversion caches
+uint64_t HashBytes(const void* data, size_t size, uint64_t seed);
+
+inline uint64_t HashBytes(string_view bytes, uint64_t seed)
+{
+    return HashBytes(bytes.data(), bytes.size(), seed);
+}
+
+}
+
+#endif
\ No newline at end of file
@@ -1,13 +1,29 @@
 #ifndef HLSL_TO_GLSL_H
 #define HLSL_TO_GLSL_H
 
+#include "ConversionOptions.h"
+
+#include <memory_resource>
 #include <string>
+#include <string_view>
 using namespace std;
 
 namespace HlslToGlsl
 {
-bool ConvertHlslToGlslFromFile(const string& filename, const string& entryFunctionName, bool isVertexShader, string& outputGlsl);
-bool ConvertHlslToGlslFromSource(const string& hlslSource, const string& entryFunctionName, bool isVertexShader, string& outputGlsl);
+class DiskCache;
+class SymbolTable;
+
+// If a cache is given, it is looked up before converting the file and it receives the result of the conversion otherwise.
+// The cache isn't used when the options have a sampler binding table, which the result depends on, nor when they ask
+// for the layout of the uniform blocks, which only a conversion computes. A cache hit doesn't fill the other statistics.
+// Everything the conversion needs besides the output is allocated from the memory resource, typically a ConversionArena.
+// Identifiers are interned in a symbol table of the conversion, unless a shared one is given.
+bool ConvertHlslToGlslFromFile(const string& filename, const string& entryFunctionName, bool isVertexShader, string& outputGlsl,
+                               const ConversionOptions& options = ConversionOptions(), DiskCache* cache = nullptr,
+                               pmr::memory_resource* memoryResource = pmr::get_default_resource(), SymbolTable* sharedSymbolTable = nullptr);
+bool ConvertHlslToGlslFromSource(string_view hlslSource, const string& entryFunctionName, bool isVertexShader, string& outputGlsl,
+                                 const ConversionOptions& options = ConversionOptions(), pmr::memory_resource* memoryResource = pmr::get_default_resource(),
+                                 SymbolTable* sharedSymbolTable = nullptr);
 }
 
 #endif
\ No newline at end of file
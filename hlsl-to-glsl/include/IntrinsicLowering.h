@@ -0,0 +1,36 @@
+#ifndef INTRINSIC_LOWERING_H
+#define INTRINSIC_LOWERING_H
+
+#include "OutputWriter.h"
+
+#include <cstdint>
+#include <string_view>
+using namespace std;
+
+namespace HlslToGlsl
+{
+
+const size_t MAXIMUM_NUMBER_OF_INTRINSIC_ARGUMENTS = 3;
+
+// GLSL form of an HLSL intrinsic whose call can't simply be renamed. An intrinsic can have several forms, the
+// cheapest one which the targeted GLSL version supports is used. Arguments can be used more than once, and operands
+// are only put in parentheses if they aren't a single name, literal or call.
+struct IntrinsicLowering
+{
+    string_view m_Hlsl;
+    size_t m_NumberOfArguments;
+    uint32_t m_MinimumGlslVersion;
+    string_view m_Glsl;         // $0 to $2 stand for the arguments, @0 to @2 for the arguments as operands of an operator
+    string_view m_Helper;       // GLSL functions the form calls, declared once before the code. Empty if none.
+};
+
+// Returns the form of an intrinsic called with the given number of arguments for a GLSL version, or nullptr
+// if the intrinsic only has to be renamed
+const IntrinsicLowering* FindIntrinsicLowering(string_view hlsl, size_t numberOfArguments, uint32_t glslVersion);
+
+// Appends the form with its arguments, already converted to GLSL
+void AppendIntrinsicLowering(const IntrinsicLowering& lowering, const string_view* arguments, OutputWriter& output);
+
+}
+
+#endif
\ No newline at end of file
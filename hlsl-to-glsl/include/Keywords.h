@@ -0,0 +1,42 @@
+#ifndef KEYWORDS_H
+#define KEYWORDS_H
+
+#include <cstdint>
+#include <string_view>
+using namespace std;
+
+namespace HlslToGlsl
+{
+
+enum KeywordClass_t : uint8_t
+{
+    KEYWORD_TYPE,
+    KEYWORD_BUILTIN_FUNCTION,
+    KEYWORD_FLOW_CONTROL,
+    KEYWORD_CBUFFER,
+    KEYWORD_REGISTER,
+    KEYWORD_STRUCT,
+    KEYWORD_SAMPLER_STATE,
+    KEYWORD_TEXTURE,
+    KEYWORD_TO_IGNORE,
+};
+
+struct Keyword
+{
+    string_view m_Hlsl;
+    KeywordClass_t m_Class;
+    string_view m_Glsl;     // Spelling of the keyword in GLSL, for types and builtin functions
+    string_view m_Precision = "";   // GLSL precision qualifier of the reduced precision types, empty for the others
+};
+
+typedef uint16_t KeywordId_t;
+const KeywordId_t INVALID_KEYWORD_ID = 0xFFFF;
+
+// Returns the identifier of the keyword spelled by token, or INVALID_KEYWORD_ID if token isn't a keyword.
+// The lookup is a perfect hash computed at compile time: it costs two hashes of the token and one comparison.
+KeywordId_t FindKeyword(string_view token);
+const Keyword& GetKeyword(KeywordId_t keywordId);
+
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,39 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+using namespace std;
+
+namespace HlslToGlsl
+{
+
+// Read-only view of a whole file. Where mmap is available the file is mapped rather than copied,
+// otherwise it is read once into a buffer owned by the object.
+class MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const string& filename);
+    void Close();
+
+    bool IsOpen() const { return m_IsOpen; }
+    string_view GetContent() const { return string_view(m_Data, m_Size); }
+
+private:
+    bool m_IsOpen;
+    const char* m_Data;
+    size_t m_Size;
+    bool m_IsMapped;
+    vector<char> m_Buffer;
+};
+
+}
+
+#endif
\ No newline at end of file
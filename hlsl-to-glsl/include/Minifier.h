@@ -0,0 +1,27 @@
+#ifndef MINIFIER_H
+#define MINIFIER_H
+
+#include "ConversionOptions.h"
+
+#include <memory_resource>
+#include <string>
+#include <string_view>
+using namespace std;
+
+namespace HlslToGlsl
+{
+
+// Appends the GLSL without its comments and without the whitespace it doesn't need: a space is only kept between
+// two names or numbers, or between two operators which would otherwise read as another one, and preprocessor
+// directives keep their own line.
+//
+// If renameLocals is set, the parameters and local variables of every function are also given the shortest
+// names no other identifier uses, the most used first. Names which also appear outside of a function body, such
+// as inputs, outputs, uniforms, samplers and struct members, are never renamed, so the interface of the shader
+// stays the same.
+void MinifyGlsl(string_view glsl, bool renameLocals, pmr::string& output, MinificationStatistics* statistics = nullptr,
+                pmr::memory_resource* memoryResource = pmr::get_default_resource());
+
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,62 @@
+#ifndef OUTPUT_WRITER_H
+#define OUTPUT_WRITER_H
+
+#include <memory_resource>
+#include <string>
+#include <string_view>
+using namespace std;
+
+namespace HlslToGlsl
+{
+
+// Append only writer over a string, used by the code generator for all of its output. Several pieces can be
+// appended in one call without building temporary strings, and the indentation is written at the start of
+// every line.
+class OutputWriter
+{
+public:
+    explicit OutputWriter(pmr::string& output) : m_Output(output) {}
+
+    void Reserve(size_t capacity);
+
+    template <typename... Pieces>
+    void Append(const Pieces&... pieces)
+    {
+        const string_view views[] = { string_view(pieces)... };
+
+        size_t size = 0;
+        for (const string_view& view : views)
+        {
+            size += view.size();
+        }
+
+        BeginAppend(size);
+
+        for (const string_view& view : views)
+        {
+            m_Output.append(view.data(), view.size());
+        }
+    }
+
+    void AppendInteger(size_t value);
+    void NewLine();
+
+    void SetIndentation(string_view indentation) { m_Indentation = indentation; }
+    void Indent() { m_IndentationLevel += 1; }
+    void Unindent();
+
+    const pmr::string& GetOutput() const { return m_Output; }
+
+private:
+    void BeginAppend(size_t size);
+
+    pmr::string& m_Output;
+
+    string_view m_Indentation;
+    size_t m_IndentationLevel = 0;
+    bool m_StartOfLine = true;
+};
+
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,50 @@
+#ifndef SAMPLER_BINDINGS_H
+#define SAMPLER_BINDINGS_H
+
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+using namespace std;
+
+namespace HlslToGlsl
+{
+
+// A combined sampler of the GLSL, with the texture unit it is bound to and the HLSL sampler state and texture
+// it comes from. The runtime creates one sampler object per sampler state register and binds it to the unit
+// with glBindSampler, next to the texture of the texture register.
+struct CombinedSamplerBinding
+{
+    pmr::string m_Name;
+    uint32_t m_Binding;
+    uint32_t m_SamplerStateRegister;
+    uint32_t m_TextureRegister;
+    uint32_t m_Dimension;
+};
+
+// Texture units of combined samplers. Each pair of sampler state and texture registers gets the next free unit
+// the first time it is seen, so units are packed, and the stages of a program converted with the same table
+// give a pair used by several of them a single unit. A table isn't thread safe: conversions running at the same
+// time, such as the workers of a batch, can't share one, and the stages of a program are converted one after the
+// other.
+class SamplerBindingTable
+{
+public:
+    explicit SamplerBindingTable(pmr::memory_resource* memoryResource = pmr::get_default_resource());
+
+    uint32_t Allocate(string_view name, uint32_t samplerStateRegister, uint32_t textureRegister, uint32_t dimension);
+
+    const pmr::vector<CombinedSamplerBinding>& GetBindings() const { return m_Bindings; }
+    void Clear() { m_Bindings.clear(); }
+
+    // One line per binding: unit name sampler_state_register texture_register dimension, i.e. 0 texture_0_00 s0 t0 2D
+    void WriteMetadata(string& output) const;
+
+private:
+    pmr::vector<CombinedSamplerBinding> m_Bindings;
+};
+
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,52 @@
+#ifndef SYMBOL_TABLE_H
+#define SYMBOL_TABLE_H
+
+#include <cstdint>
+#include <deque>
+#include <memory_resource>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+using namespace std;
+
+namespace HlslToGlsl
+{
+
+typedef uint32_t SymbolId_t;
+const SymbolId_t INVALID_SYMBOL_ID = 0xFFFFFFFF;
+
+// Interns identifiers: every distinct name is stored once and gets a small integer identifier, so that names
+// can be compared and looked up as integers. Identifiers are dense, starting at 0.
+//
+// A conversion normally owns its table, allocated from the conversion's memory resource. A table created as
+// shared can instead be given to several conversions running at the same time, which then agree on the
+// identifiers of their names; it must use a memory resource that outlives all of them.
+class SymbolTable
+{
+public:
+    explicit SymbolTable(bool isShared = false, pmr::memory_resource* memoryResource = pmr::get_default_resource());
+
+    SymbolId_t Intern(string_view name);
+
+    // Unlike Intern, never adds the name: returns INVALID_SYMBOL_ID if it isn't in the table
+    SymbolId_t Find(string_view name) const;
+    string_view GetName(SymbolId_t symbolId) const;
+
+    size_t size() const;
+
+private:
+    SymbolId_t InternLocked(string_view name);
+    SymbolId_t FindLocked(string_view name) const;
+
+    // The keys of the map are views into the names, which a deque never moves
+    pmr::deque<pmr::string> m_Names;
+    pmr::unordered_map<string_view, SymbolId_t> m_SymbolIds;
+
+    bool m_IsShared;
+    mutable shared_mutex m_Mutex;
+};
+
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,100 @@
+#ifndef SYNTAX_TREE_H
+#define SYNTAX_TREE_H
+
+#include "Tokenizer.h"
+
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+using namespace std;
+
+namespace HlslToGlsl
+{
+
+typedef uint32_t LexemeIndex_t;
+const LexemeIndex_t INVALID_LEXEME_INDEX = 0xFFFFFFFF;
+const uint32_t INVALID_NODE_INDEX = 0xFFFFFFFF;
+
+// What the node starting at a lexeme is, which tells in which array its index is
+enum NodeKind_t : uint8_t
+{
+    NODE_NONE,
+    NODE_CALL,                          // Index in SyntaxTree::m_Calls, at the opened paranthesis of the call
+    NODE_DECLARATION,                   // Index in SyntaxTree::m_Declarations, at the keyword of the declaration
+};
+
+// Lexemes from m_Begin up to, but not including, m_End
+struct LexemeRange
+{
+    LexemeIndex_t m_Begin;
+    LexemeIndex_t m_End;
+
+    bool empty() const { return m_Begin >= m_End; }
+    size_t size() const { return empty() ? 0 : m_End - m_Begin; }
+};
+
+// A name followed by a paranthesis: a call to a function, a builtin function or a constructor, or the signature
+// of a function definition, whose arguments are then its parameters
+struct CallNode
+{
+    LexemeIndex_t m_Function;
+    LexemeIndex_t m_OpenedParanthesis;
+    LexemeIndex_t m_ClosedParanthesis;
+    uint32_t m_FirstArgument;           // Index of the first argument in SyntaxTree::m_Arguments
+    uint32_t m_NumberOfArguments;
+    uint32_t m_FunctionDefinition;      // Index in SyntaxTree::m_Functions if this is a signature, INVALID_NODE_INDEX otherwise
+};
+
+// Declaration of a cbuffer, texture or sampler state, i.e. Texture2D name : register(t0);
+struct DeclarationNode
+{
+    LexemeIndex_t m_Keyword;
+    LexemeIndex_t m_Name;
+    LexemeIndex_t m_Register;           // Slot of the register, i.e. t0, or INVALID_LEXEME_INDEX if there is none
+    LexemeIndex_t m_End;                // Semicolon, or last lexeme before the body of a cbuffer
+};
+
+struct FunctionNode
+{
+    LexemeIndex_t m_ReturnType;
+    uint32_t m_Signature;               // Index in SyntaxTree::m_Calls
+    LexemeIndex_t m_OpenedCurlyBracket;
+    LexemeIndex_t m_ClosedCurlyBracket;
+    uint32_t m_FirstCall;               // Calls made in the body, which are consecutive in SyntaxTree::m_Calls
+    uint32_t m_NumberOfCalls;
+};
+
+// Structure of a lexeme stream, built in one linear pass. Nodes refer to lexemes by their index in the stream,
+// which lets the code generator find the parts of a construct wherever they are instead of at fixed offsets.
+// Everything is allocated from the memory resource of the conversion.
+struct SyntaxTree
+{
+    explicit SyntaxTree(pmr::memory_resource* memoryResource = pmr::get_default_resource());
+
+    LexemeIndex_t GetMatchingBracket(size_t lexemeIndex) const { return m_MatchingBrackets[lexemeIndex]; }
+
+    // Node starting at a lexeme: the call of a function name, the declaration of a keyword. nullptr if there is none.
+    const CallNode* FindCall(size_t functionLexemeIndex) const;
+    const DeclarationNode* FindDeclaration(size_t keywordLexemeIndex) const;
+
+    LexemeRange GetArgument(const CallNode& call, size_t argumentIndex) const { return m_Arguments[call.m_FirstArgument + argumentIndex]; }
+
+    // Per lexeme
+    pmr::vector<LexemeIndex_t> m_MatchingBrackets;
+    pmr::vector<uint32_t> m_Nodes;
+    pmr::vector<uint8_t> m_NodeKinds;
+
+    pmr::vector<CallNode> m_Calls;
+    pmr::vector<LexemeRange> m_Arguments;
+    pmr::vector<DeclarationNode> m_Declarations;
+    pmr::vector<FunctionNode> m_Functions;
+};
+
+bool IsOpenedBracket(TokenClass_t tokenClass);
+bool IsClosedBracket(TokenClass_t tokenClass);
+
+SyntaxTree ParseSyntaxTree(const LexemeStream& lexemes, pmr::memory_resource* memoryResource = pmr::get_default_resource());
+
+}
+
+#endif
\ No newline at end of file
@@ -1,7 +1,13 @@
 #ifndef TOKENIZER_H
 #define TOKENIZER_H
 
+#include "Keywords.h"
+#include "SymbolTable.h"
+
+#include <cstdint>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <vector>
 using namespace std;
 
@@ -40,10 +46,51 @@ enum TokenClass_t
 struct Lexeme
 {
     TokenClass_t m_TokenClass;
-    string m_Token;
+    string_view m_Token;
+    KeywordId_t m_KeywordId;    // Resolved by the tokenizer, INVALID_KEYWORD_ID if the token isn't a keyword
+    SymbolId_t m_SymbolId;      // Interned by the tokenizer for identifiers, INVALID_SYMBOL_ID otherwise
+};
+
+// The lexemes of a source, stored as parallel compact arrays. Tokens are not copied: each one is an offset
+// and a length into the source, which must therefore outlive the stream. The arrays come from the given
+// memory resource, which lets a conversion allocate them from its arena. Identifiers are interned in the
+// symbol table, which must outlive the stream as well.
+class LexemeStream
+{
+public:
+    LexemeStream(string_view source, SymbolTable& symbolTable, pmr::memory_resource* memoryResource = pmr::get_default_resource());
+
+    size_t size() const { return m_TokenClasses.size(); }
+    bool empty() const { return m_TokenClasses.empty(); }
+
+    Lexeme operator[](size_t index) const { return Lexeme{ GetTokenClass(index), GetToken(index), GetKeywordId(index), GetSymbolId(index) }; }
+
+    TokenClass_t GetTokenClass(size_t index) const { return (TokenClass_t) m_TokenClasses[index]; }
+    string_view GetToken(size_t index) const { return m_Source.substr(m_Spans[index].m_Offset, m_Spans[index].m_Length); }
+    KeywordId_t GetKeywordId(size_t index) const { return m_KeywordIds[index]; }
+    SymbolId_t GetSymbolId(size_t index) const { return m_SymbolIds[index]; }
+    string_view GetSource() const { return m_Source; }
+    SymbolTable& GetSymbolTable() const { return *m_SymbolTable; }
+
+    void Reserve(size_t numberOfLexemes);
+    void Add(TokenClass_t tokenClass, size_t offset, size_t length, KeywordId_t keywordId = INVALID_KEYWORD_ID, SymbolId_t symbolId = INVALID_SYMBOL_ID);
+
+private:
+    struct Span
+    {
+        uint32_t m_Offset;
+        uint32_t m_Length;
+    };
+
+    string_view m_Source;
+    SymbolTable* m_SymbolTable;
+    pmr::vector<uint8_t> m_TokenClasses;
+    pmr::vector<Span> m_Spans;
+    pmr::vector<KeywordId_t> m_KeywordIds;
+    pmr::vector<SymbolId_t> m_SymbolIds;
 };
 
-vector<Lexeme> ParseIntoLexemes(const string& input);
+LexemeStream ParseIntoLexemes(string_view input, SymbolTable& symbolTable, pmr::memory_resource* memoryResource = pmr::get_default_resource());
 
 }
 
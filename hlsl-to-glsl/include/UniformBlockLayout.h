@@ -0,0 +1,74 @@
+#ifndef UNIFORM_BLOCK_LAYOUT_H
+#define UNIFORM_BLOCK_LAYOUT_H
+
+#include "SyntaxTree.h"
+#include "Tokenizer.h"
+
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+using namespace std;
+
+namespace HlslToGlsl
+{
+
+// HLSL packs the members of a cbuffer in registers of four 32 bit components
+const uint32_t REGISTER_SIZE = 16;
+const uint32_t INVALID_REGISTER = 0xFFFFFFFF;
+
+// A member of a cbuffer, with the offset HLSL gives it and the alignment std140 requires from it
+struct UniformBlockMember
+{
+    LexemeIndex_t m_Type;
+    LexemeIndex_t m_Name;
+    uint32_t m_ArraySize;           // 0 if the member isn't an array
+    uint32_t m_Rows;                // Components of a vector, or of each column of a matrix
+    uint32_t m_Columns;             // 1 for scalars and vectors
+    uint32_t m_Offset;              // In bytes, from packoffset or from the packing rules of HLSL
+    uint32_t m_Size;                // In bytes, without the padding HLSL leaves after the last element of an array
+    uint32_t m_Std140Alignment;
+    uint32_t m_Std140Size;
+};
+
+// What the uniform block declares, in order: a member of the cbuffer, or vec4s holding whole registers whose
+// members std140 can't place at their HLSL offset, which are then read from them. A vec4 array holds the registers
+// of an array or a matrix along with the members sharing its last register. Both follow m_Padding floats which
+// move them to their HLSL offset.
+struct UniformBlockEntry
+{
+    uint32_t m_Member;              // Index in UniformBlockLayout::m_Members, of the first member of the registers for vec4s
+    uint32_t m_Register;            // First register of the vec4s, INVALID_REGISTER for a member declared as is
+    uint32_t m_Padding;
+    uint32_t m_RegisterCount;       // 1 for a single vec4, 0 for a member declared as is
+};
+
+struct UniformBlockLayout
+{
+    explicit UniformBlockLayout(pmr::memory_resource* memoryResource = pmr::get_default_resource());
+
+    // Members, sorted by offset
+    pmr::vector<UniformBlockMember> m_Members;
+    pmr::vector<UniformBlockEntry> m_Entries;
+
+    // First register of the vec4s holding each member read from a register, INVALID_REGISTER for the members
+    // declared as is
+    pmr::vector<uint32_t> m_MemberRegisters;
+
+    uint32_t m_Size = 0;            // Size of the constant buffer, a multiple of REGISTER_SIZE
+    uint32_t m_UsedSize = 0;        // Bytes the members use, the rest of the buffer is padding
+    uint32_t m_PackedSize = 0;      // Size of the buffer with its members reordered to fill the registers
+    bool m_MatchesStd140 = false;   // False if the entries can't give every member its HLSL offset
+};
+
+// Computes the layout of the members between the curly brackets of a cbuffer, and how to declare them so that
+// std140 gives them their HLSL offsets. Returns false if the layout of a member isn't known: structures,
+// doubles, row_major matrices or arrays whose size is a name.
+bool ComputeUniformBlockLayout(const LexemeStream& lexemes, const SyntaxTree& syntaxTree, LexemeIndex_t openedCurlyBracket, UniformBlockLayout& layout);
+
+// Gives up on the HLSL offsets: every member is declared as is, and std140 then places some of them elsewhere
+// unless the layout already matched
+void DeclareMembersAsIs(UniformBlockLayout& layout);
+
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,235 @@
+#include "BatchConversion.h"
+
+#include "ConversionArena.h"
+#include "HlslToGlsl.h"
+#include "MappedFile.h"
+#include "SamplerBindings.h"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+using namespace std;
+
+namespace HlslToGlsl
+{
+
+bool ReadBatchManifest(const string& filename, vector<BatchEntry>& entries, string& error)
+{
+    ifstream manifest(filename);
+    if (!manifest.is_open())
+    {
+        error = "Couldn't open manifest " + filename;
+        return false;
+    }
+
+    set<string> outputFilenames;
+
+    string line;
+    size_t lineNumber = 0;
+    while (getline(manifest, line))
+    {
+        lineNumber += 1;
+
+        istringstream fields(line);
+        BatchEntry entry;
+        string stage;
+
+        if (!(fields >> entry.m_InputFilename) || entry.m_InputFilename[0] == '#')
+        {
+            continue;
+        }
+
+        string extraField;
+        if (!(fields >> entry.m_OutputFilename >> entry.m_EntryFunctionName >> stage) || ((fields >> entry.m_Program) && (fields >> extraField)))
+        {
+            error = filename + ":" + to_string(lineNumber) + ": expected input_file.hlsl output_file.glsl entryFunctionName {vertex|fragment} [program]";
+            return false;
+        }
+
+        if (stage == "vertex")
+        {
+            entry.m_IsVertexShader = true;
+        }
+        else if (stage == "fragment")
+        {
+            entry.m_IsVertexShader = false;
+        }
+        else
+        {
+            error = filename + ":" + to_string(lineNumber) + ": invalid stage " + stage + " ! Reconized values are vertex or fragment";
+            return false;
+        }
+
+        // Two entries writing the same file would race with each other
+        if (!outputFilenames.insert(entry.m_OutputFilename).second)
+        {
+            error = filename + ":" + to_string(lineNumber) + ": " + entry.m_OutputFilename + " is already the output of another entry";
+            return false;
+        }
+
+        entries.push_back(entry);
+    }
+
+    return true;
+}
+
+BatchResult ConvertBatchEntry(const BatchEntry& entry, const ConversionOptions& options, DiskCache* cache, SymbolTable* sharedSymbolTable,
+                              SamplerBindingTable* samplerBindings, ConversionArena& arena)
+{
+    BatchResult result;
+    result.m_Succeeded = false;
+    result.m_LoadedFromCache = false;
+
+    ConversionOptions entryOptions = options;
+    entryOptions.m_MinificationStatistics = &result.m_Minification;
+    entryOptions.m_LoadedFromCache = &result.m_LoadedFromCache;
+    entryOptions.m_SamplerBindings = samplerBindings;
+
+    if (options.m_ConversionStatistics != nullptr)
+    {
+        entryOptions.m_ConversionStatistics = &result.m_Statistics;
+    }
+
+    string outputGlsl;
+    if (!ConvertHlslToGlslFromFile(entry.m_InputFilename, entry.m_EntryFunctionName, entry.m_IsVertexShader, outputGlsl, entryOptions, cache, arena.GetResource(),
+                                   sharedSymbolTable))
+    {
+        // The conversion only says that it failed, a file which opens wasn't read by it but couldn't be converted
+        MappedFile inputFile;
+        result.m_Error = (inputFile.Open(entry.m_InputFilename) ? "Couldn't convert " : "Couldn't read ") + entry.m_InputFilename;
+        return result;
+    }
+
+    ofstream outputFile(entry.m_OutputFilename);
+    outputFile << outputGlsl;
+    outputFile.close();
+
+    if (outputFile.fail())
+    {
+        result.m_Error = "Couldn't write " + entry.m_OutputFilename;
+        return result;
+    }
+
+    result.m_Succeeded = true;
+    return result;
+}
+
+// Converts the stages of a program one after the other with the same sampler binding table, or an entry on its own
+void ConvertBatchGroup(const vector<BatchEntry>& entries, const vector<size_t>& group, const ConversionOptions& options, DiskCache* cache,
+                       SymbolTable* sharedSymbolTable, ConversionArena& arena, vector<BatchResult>& results)
+{
+    SamplerBindingTable samplerBindings;
+
+    for (size_t i : group)
+    {
+        const bool usesBindings = !entries[i].m_Program.empty() || !entries[i].m_SamplerMetadataFilename.empty();
+        results[i] = ConvertBatchEntry(entries[i], options, cache, sharedSymbolTable, usesBindings ? &samplerBindings : nullptr, arena);
+        arena.Reset();
+    }
+
+    // Every stage gets the units of the whole program
+    string metadata;
+    samplerBindings.WriteMetadata(metadata);
+
+    for (size_t i : group)
+    {
+        if (!results[i].m_Succeeded || entries[i].m_SamplerMetadataFilename.empty())
+        {
+            continue;
+        }
+
+        ofstream metadataFile(entries[i].m_SamplerMetadataFilename);
+        metadataFile << metadata;
+        metadataFile.close();
+
+        if (metadataFile.fail())
+        {
+            results[i].m_Succeeded = false;
+            results[i].m_Error = "Couldn't write " + entries[i].m_SamplerMetadataFilename;
+        }
+    }
+}
+
+vector<BatchResult> ConvertBatch(const vector<BatchEntry>& entries, size_t numberOfThreads, const ConversionOptions& options, DiskCache* cache,
+                                 SymbolTable* sharedSymbolTable)
+{
+    vector<BatchResult> results(entries.size());
+
+    // Statistics and sampler bindings would be written by every thread at once. Conversion statistics go to the
+    // result of each entry instead, and are summed once the threads are done.
+    ConversionOptions entryOptions = options;
+    entryOptions.m_ConstantFoldingStatistics = nullptr;
+    entryOptions.m_LoadedFromCache = nullptr;
+    entryOptions.m_SamplerBindings = nullptr;
+    entryOptions.m_UniformBlockStatistics = nullptr;
+
+    // The stages of a program form a group, in manifest order, and any other entry a group of its own
+    vector<vector<size_t>> groups;
+    unordered_map<string, size_t> groupOfPrograms;
+
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        if (entries[i].m_Program.empty())
+        {
+            groups.push_back({ i });
+            continue;
+        }
+
+        auto group = groupOfPrograms.emplace(entries[i].m_Program, groups.size());
+        if (group.second)
+        {
+            groups.emplace_back();
+        }
+
+        groups[group.first->second].push_back(i);
+    }
+
+    if (numberOfThreads == 0)
+    {
+        numberOfThreads = max(thread::hardware_concurrency(), 1u);
+    }
+
+    numberOfThreads = min(numberOfThreads, groups.size());
+
+    // Groups are independent, so the threads simply take the next group nobody has started yet.
+    // Each one writes only the slots of the results of its entries, which keeps them in manifest order, and
+    // reuses its own arena from one conversion to the next.
+    atomic<size_t> nextGroup(0);
+    auto worker = [&] () {
+        ConversionArena arena;
+
+        for (size_t i = nextGroup++; i < groups.size(); i = nextGroup++)
+        {
+            ConvertBatchGroup(entries, groups[i], entryOptions, cache, sharedSymbolTable, arena, results);
+        }
+    };
+
+    vector<thread> threads;
+    for (size_t i = 1; i < numberOfThreads; i++)
+    {
+        threads.push_back(thread(worker));
+    }
+
+    worker();
+
+    for (thread& t : threads)
+    {
+        t.join();
+    }
+
+    if (options.m_ConversionStatistics != nullptr)
+    {
+        for (const BatchResult& result : results)
+        {
+            options.m_ConversionStatistics->Add(result.m_Statistics);
+        }
+    }
+
+    return results;
+}
+
+}
\ No newline at end of file
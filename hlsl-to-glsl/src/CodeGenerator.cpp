@@ -1,802 +1,1175 @@
 #include "CodeGenerator.h"
+#include "ConversionStatistics.h"
+#include "DeadCodeElimination.h"
+#include "IntrinsicLowering.h"
+#include "Minifier.h"
+#include "UniformBlockLayout.h"
 
 #include <algorithm>
-#include <iomanip>
-#include <sstream>
+#include <charconv>
+#include <iterator>
+#include <unordered_set>
 #include <utility>
 using namespace std;
 
 namespace HlslToGlsl
 {
 
-// State variable
-size_t currentIndentationLevel = 0;
-bool startOfLine = true;
-bool insideOfStruct = false;
-bool hadAnySemanticsInStruct = false;
-vector<string> structNames;
-bool isOutputSemanticStruct = false;
+ConversionContext::ConversionContext(pmr::memory_resource* memoryResource)
+    : m_MemoryResource(memoryResource)
+    , m_UnreachableCode(memoryResource)
+    , m_Replacements(memoryResource)
+    , m_UniformBlocks(memoryResource)
+    , m_SymbolFlags(memoryResource)
+    , m_StructBufferIfNoSemanticsInStruct(memoryResource)
+    , m_Semantics(memoryResource)
+    , m_SamplerStateTextureNames(memoryResource)
+    , m_UvNames(memoryResource)
+    , m_SemanticsForUvNames(memoryResource)
+{
+}
 
-string structBufferIfNoSemanticsInStruct;
-vector<string> semantics;
+bool HasSymbolFlag(const ConversionContext& context, SymbolId_t symbolId, uint8_t flag)
+{
+    // Also false for INVALID_SYMBOL_ID, the symbol of anything that isn't an identifier
+    return symbolId < context.m_SymbolFlags.size() && (context.m_SymbolFlags[symbolId] & flag) != 0;
+}
 
-vector<string> semanticStructNameToIgnore;
-vector<string> semanticStructVariableToIgnore;
-bool mightAddSemanticStructNameToIgnore = false;
-bool isInEntryFunction = false;
-size_t entryFunctionLevel = 0;
+void AddSymbolFlag(ConversionContext& context, SymbolId_t symbolId, uint8_t flag)
+{
+    if (symbolId == INVALID_SYMBOL_ID)
+    {
+        return;
+    }
 
-vector<string> samplerStateTextureNames;
-vector<string> samplerStateTextureNamesToUse;
+    // A shared symbol table can hand out identifiers past the ones seen when the flags were sized
+    if (symbolId >= context.m_SymbolFlags.size())
+    {
+        context.m_SymbolFlags.resize(symbolId + 1, 0);
+    }
 
-vector<string> uvNames;
-vector<string> semanticsForUvNames;
+    context.m_SymbolFlags[symbolId] |= flag;
+}
 
-string glPositionName = "";
+bool IsSymbol(const Lexeme& lexeme, SymbolId_t symbolId)
+{
+    return symbolId != INVALID_SYMBOL_ID && lexeme.m_SymbolId == symbolId;
+}
 
-void ResetGlobalVariables()
+bool IsStructName(const ConversionContext& context, SymbolId_t symbolId)
 {
-    currentIndentationLevel = 0;
-    startOfLine = true;
-    insideOfStruct = false;
-    hadAnySemanticsInStruct = false;
-    structNames.clear();
-    isOutputSemanticStruct = false;
+    return HasSymbolFlag(context, symbolId, SYMBOL_STRUCT_NAME);
+}
+
+bool IsSemanticStructName(const ConversionContext& context, SymbolId_t symbolId)
+{
+    return HasSymbolFlag(context, symbolId, SYMBOL_SEMANTIC_STRUCT_NAME);
+}
+
+bool IsSemanticStructVariable(const ConversionContext& context, SymbolId_t symbolId)
+{
+    return HasSymbolFlag(context, symbolId, SYMBOL_SEMANTIC_STRUCT_VARIABLE);
+}
+
+uint64_t GetSamplerStateTextureKey(SymbolId_t samplerStateSymbolId, SymbolId_t textureSymbolId)
+{
+    return ((uint64_t) samplerStateSymbolId << 32) | textureSymbolId;
+}
+
+string_view GetSamplerStateTextureName(const ConversionContext& context, SymbolId_t samplerStateSymbolId, SymbolId_t textureSymbolId)
+{
+    auto it = context.m_SamplerStateTextureNames.find(GetSamplerStateTextureKey(samplerStateSymbolId, textureSymbolId));
+    if (it == context.m_SamplerStateTextureNames.end())
+    {
+        return "";
+    }
 
-    structBufferIfNoSemanticsInStruct = "";
-    semantics.clear();
+    return it->second;
+}
 
-    semanticStructNameToIgnore.clear();
-    semanticStructVariableToIgnore.clear();
-    mightAddSemanticStructNameToIgnore = false;
-    isInEntryFunction = false;
-    entryFunctionLevel = 0;
+// Register slots and the indices in combined sampler state and texture names are small decimal numbers
+size_t ParseIndex(string_view digits)
+{
+    size_t value = 0;
+    from_chars(digits.data(), digits.data() + digits.size(), value);
 
-    samplerStateTextureNames.clear();
-    samplerStateTextureNamesToUse.clear();
+    return value;
+}
 
-    uvNames.clear();
-    semanticsForUvNames.clear();
+// Appends "_<sampler state register>_<texture register on two digits>", which is how both registers are read
+// back from a combined sampler state and texture name
+void AppendSamplerStateTextureIndex(pmr::string& name, size_t samplerStateIndex, size_t textureIndex)
+{
+    OutputWriter writer(name);
 
-    glPositionName = "";
+    writer.Append("_");
+    writer.AppendInteger(samplerStateIndex);
+    writer.Append(textureIndex < 10 ? "_0" : "_");
+    writer.AppendInteger(textureIndex);
 }
 
-bool IsStructName(const string& name)
+// Slot of the register of a declaration, i.e. 0 for t0. Declarations without a register use slot 0.
+size_t GetRegisterSlot(const LexemeStream& lexemes, const DeclarationNode& declaration)
 {
-    for (const string& structName : structNames)
+    if (declaration.m_Register == INVALID_LEXEME_INDEX)
     {
-        if (name == structName)
-        {
-            return true;
-        }
+        return 0;
     }
 
-    return false;
+    return ParseIndex(lexemes.GetToken(declaration.m_Register).substr(1));
 }
 
-bool IsSemanticStructName(const string& name)
+// The UV coordinates of a Sample call are the variable at the start of its second argument, i.e. input.uv in
+// input.uv * 2.0. Only a member of the input of the entry function, sampled in its body, has an inverted copy:
+// the range is empty for anything else, such as the parameter of a helper function.
+LexemeRange GetUvNameRange(const LexemeStream& lexemes, const ConversionContext& context, const CallNode& sampleCall)
 {
-    for (const string& structName : semanticStructNameToIgnore)
+    const LexemeRange& body = context.m_EntryFunctionBody;
+    if (sampleCall.m_NumberOfArguments < 2 || sampleCall.m_OpenedParanthesis <= body.m_Begin || sampleCall.m_OpenedParanthesis >= body.m_End)
     {
-        if (name == structName)
+        return LexemeRange{ 0, 0 };
+    }
+
+    LexemeRange uvNameRange = context.m_SyntaxTree->GetArgument(sampleCall, 1);
+    LexemeIndex_t end = uvNameRange.m_Begin;
+
+    while (end < uvNameRange.m_End && lexemes.GetTokenClass(end) == TokenClass_t::VARIABLE_NAME)
+    {
+        end += 1;
+
+        if (end + 1 >= uvNameRange.m_End || lexemes.GetTokenClass(end) != TokenClass_t::STRUCTURE_OPERATOR)
         {
-            return true;
+            break;
         }
+
+        end += 1;
+    }
+
+    uvNameRange.m_End = end;
+
+    if (uvNameRange.size() != 3 || lexemes.GetSymbolId(uvNameRange.m_Begin) != context.m_EntryFunctionInputSymbol)
+    {
+        return LexemeRange{ 0, 0 };
     }
 
-    return false;
+    return uvNameRange;
 }
 
-bool IsSemanticStructVariable(const string& name)
+void AppendTokens(const LexemeStream& lexemes, LexemeRange range, pmr::string& output)
 {
-    for (const string& structName : semanticStructVariableToIgnore)
+    for (LexemeIndex_t i = range.m_Begin; i < range.m_End; i++)
     {
-        if (name == structName)
-        {
-            return true;
-        }
+        output.append(lexemes.GetToken(i));
+    }
+}
+
+// The Sample call of texture.Sample(...) when lexemeIndex is the texture, nullptr if there is none
+const CallNode* FindSampleCall(const LexemeStream& lexemes, const ConversionContext& context, size_t lexemeIndex)
+{
+    if (lexemeIndex + 2 >= lexemes.size() || lexemes.GetTokenClass(lexemeIndex + 1) != TokenClass_t::STRUCTURE_OPERATOR ||
+        !IsSymbol(lexemes[lexemeIndex + 2], context.m_SampleSymbol))
+    {
+        return nullptr;
     }
 
-    return false;
+    const CallNode* sampleCall = context.m_SyntaxTree->FindCall(lexemeIndex + 2);
+    if (sampleCall == nullptr || sampleCall->m_NumberOfArguments < 2)
+    {
+        return nullptr;
+    }
+
+    return sampleCall;
 }
 
-string GetSamplerStateTextureName(const string& samplerStateName, const string& textureName)
+void DeclareIntrinsicHelpers(const LexemeStream& lexemes, ConversionContext& context, OutputWriter& output);
+void InterpretLexemeOrReplacement(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output);
+void InterpretExpression(const LexemeStream& lexemes, ConversionContext& context, LexemeRange range, OutputWriter& output);
+
+void InterpretArithmeticOperator(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output);
+void InterpretAssignation(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output);
+void InterpretBitwiseOperator(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output);
+void InterpretBuiltinFunction(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output);
+void InterpretCbuffer(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output);
+void IntrepretClosedAngleBracket(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output);
+void InterpretClosedCurlyBracket(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, bool isVertexShader, OutputWriter& output);
+void IntrepretClosedParanthesis(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output);
+void InterpretColon(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, bool isVertexShader, OutputWriter& output);
+void InterpretComma(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output);
+void InterpretComment(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output);
+void InterpretFlowControl(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output);
+void InterpretOpenedAngleBracket(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output);
+void InterpretOpenedCurlyBracket(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output);
+void InterpretOpenedParanthesis(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output);
+void InterpretRegister(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output);
+void InterpretRelationalOperator(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output);
+void InterpretSamplerState(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output);
+void InterpretSemiColumn(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output);
+void InterpretStruct(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output);
+void InterpretStructureOperator(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output);
+void InterpretTernaryOperator(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output);
+void InterpretTexture(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output);
+void InterpretType(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output);
+void InterpretVariableName(const LexemeStream& lexemes, ConversionContext& context, const string& entryFunctionName, bool isVertexShader, size_t& lexemeIndex, OutputWriter& output);
+void PlanUniformBlocks(const LexemeStream& lexemes, ConversionContext& context);
+void AppendRegisterRead(string_view blockName, const UniformBlockMember& member, const UniformBlockEntry& entry, string_view glslType, OutputWriter& output);
+void AppendRegisterArrayReadBegin(string_view blockName, const UniformBlockMember& member, const UniformBlockEntry& entry, string_view glslType,
+                                  OutputWriter& output);
+void AppendRegisterArrayReadEnd(const UniformBlockMember& member, uint32_t firstRegister, string_view glslType, OutputWriter& output);
+
+// Types and builtin functions are keywords, resolved once by the tokenizer, which also know their GLSL spelling
+string_view GetGlslSpelling(const Lexeme& lexeme)
 {
-    for (size_t i = 0; i < samplerStateTextureNames.size(); i++)
+    return (lexeme.m_KeywordId != INVALID_KEYWORD_ID) ? GetKeyword(lexeme.m_KeywordId).m_Glsl : lexeme.m_Token;
+}
+
+void InitializeConversionContext(const LexemeStream& lexemes, const SyntaxTree& syntaxTree, const string& entryFunctionName, bool isVertexShader,
+                                 const ConversionOptions& options, ConversionContext& context)
+{
+    context.m_EntryFunctionName = &entryFunctionName;
+    context.m_IsVertexShader = isVertexShader;
+    context.m_Profile = &GetGlslProfile(options.m_Profile);
+    context.m_PrecisionQualifiers = options.m_PrecisionQualifiers;
+    context.m_SamplerBindings = options.m_SamplerBindings;
+    context.m_UniformBlockStatistics = options.m_UniformBlockStatistics;
+
+    // Names the generator looks for, as symbols. They are invalid if the shader never uses them.
+    const SymbolTable& symbolTable = lexemes.GetSymbolTable();
+    context.m_SampleSymbol = symbolTable.Find("Sample");
+    context.m_EntryFunctionSymbol = symbolTable.Find(entryFunctionName);
+    context.m_SymbolFlags.resize(symbolTable.size(), 0);
+
+    context.m_SyntaxTree = &syntaxTree;
+
+    for (const FunctionNode& function : syntaxTree.m_Functions)
     {
-        string comp = samplerStateName + textureName;
-        if (samplerStateTextureNames[i].substr(0, samplerStateTextureNames[i].size() - 5) == comp)
+        const CallNode& signature = syntaxTree.m_Calls[function.m_Signature];
+        if (lexemes.GetSymbolId(signature.m_Function) == context.m_EntryFunctionSymbol && context.m_EntryFunctionSymbol != INVALID_SYMBOL_ID)
         {
-            return samplerStateTextureNamesToUse[i];
+            context.m_EntryFunctionBody = LexemeRange{ function.m_OpenedCurlyBracket, function.m_ClosedCurlyBracket };
+
+            const LexemeRange parameter = (signature.m_NumberOfArguments > 0) ? syntaxTree.GetArgument(signature, 0) : LexemeRange{ 0, 0 };
+            context.m_EntryFunctionInputSymbol = parameter.empty() ? INVALID_SYMBOL_ID : lexemes.GetSymbolId(parameter.m_End - 1);
         }
     }
 
-    return "";
+    context.m_UnreachableCode = FindUnreachableCode(lexemes, syntaxTree, context.m_EntryFunctionSymbol, context.m_MemoryResource);
+
+    if (options.m_FoldConstants)
+    {
+        context.m_Replacements = FoldConstants(lexemes, syntaxTree, context.m_UnreachableCode, options.m_ConstantFoldingStatistics, context.m_MemoryResource);
+    }
+
+    PlanUniformBlocks(lexemes, context);
 }
 
-void InterpretArithmeticOperator(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl);
-void InterpretAssignation(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl);
-void InterpretBitwiseOperator(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl);
-void InterpretBuiltinFunction(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl);
-void InterpretCbuffer(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl);
-void IntrepretClosedAngleBracket(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl);
-void InterpretClosedCurlyBracket(const vector<Lexeme>& lexemes, size_t& lexemeIndex, bool isVertexShader, string& outputGlsl);
-void IntrepretClosedParanthesis(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl);
-void InterpretColon(const vector<Lexeme>& lexemes, size_t& lexemeIndex, bool isVertexShader, string& outputGlsl);
-void InterpretComma(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl);
-void InterpretComment(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl);
-void InterpretFlowControl(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl);
-void InterpretOpenedAngleBracket(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl);
-void InterpretOpenedCurlyBracket(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl);
-void InterpretOpenedParanthesis(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl);
-void InterpretRegister(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl);
-void InterpretRelationalOperator(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl);
-void InterpretSamplerState(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl);
-void InterpretSemiColumn(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl);
-void InterpretStruct(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl);
-void InterpretStructureOperator(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl);
-void InterpretTernaryOperator(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl);
-void InterpretTexture(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl);
-void InterpretType(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl);
-void InterpretVariableName(const vector<Lexeme>& lexemes, const string& entryFunctionName, bool isVertexShader, const vector<string>& originalTextureNames, size_t& lexemeIndex, string& outputGlsl);
-
-string hlslTypesMappingToGlsl[] = {
-    "bool", "bool",
-    "int", "int",
-    "uint", "uint",
-    "dword", "uint",
-    "half", "float",
-    "float", "float",
-    "double", "double",
-
-    "bool1", "bool",
-    "bool2", "bvec2",
-    "bool3", "bvec3",
-    "bool4", "bvec4",
-
-    "int1", "int",
-    "int2", "ivec2",
-    "int3", "ivec3",
-    "int4", "ivec4",
-
-    "uint1", "uint",
-    "uint2", "uvec2",
-    "uint3", "uvec3",
-    "uint4", "uvec4",
-
-    "half1", "float",
-    "half2", "vec2",
-    "half3", "vec3",
-    "half4", "vec4",
-
-    "float1", "float",
-    "float2", "vec2",
-    "float3", "vec3",
-    "float4", "vec4",
-
-    "double1", "double",
-    "double2", "dvec2",
-    "double3", "dvec3",
-    "double4", "dvec4",
-
-    "float2x2", "mat2",
-    "float3x3", "mat3",
-    "float4x4", "mat4",
-};
-
-string hlslBuiltinFunctionsToGlsl[] = {
-    "abs",              "abs",
-    "acos",             "acos",
-    "all",              "all",
-    "any",              "any",
-    "asin",             "asin",
-    "atan",             "atan",
-    "atan2",            "atan",
-    "ceil",             "ceil",
-    "clamp",            "clamp",
-    "clip",             "clip",         // Custom function for GLSL
-    "cos",              "cos",
-    "cosh",             "cosh",
-    "cross",            "cross",
-    "ddx",              "dFdx",
-    "ddx_coarse",       "dFdxCoarse",
-    "ddx_fine",         "dFdxFine",
-    "ddy",              "dFdy",
-    "ddy_coarse",       "dFdyCoarse",
-    "ddy_fine",         "dFdyFine",
-    "degrees",          "degreese",
-    "determinant",      "determinant",
-    "distance",         "distance",
-    "dot",              "dot",
-    "exp",              "exp",
-    "exp2",             "exp2",
-    "faceforward",      "facefoward",
-    "floor",            "floor",
-    "fma",              "fma",
-    "fmod",             "fmod",         // Custom function for GLSL
-    "frac",             "frac",
-    "frexp",            "frexp",
-    "fwidth",           "fwidth",
-    "isinf",            "isinf",
-    "isnan",            "isnan",
-    "ldexp",            "ldexp",
-    "length",           "length",
-    "lerp",             "mix",
-    "log",              "log",
-    "log10",            "log10",        // Custon function for GLSL
-    "log2",             "log2",
-    "max",              "max",
-    "min",              "min",
-    "modf",             "modf",
-    "mul",              "*",            // Special case, mul in HLSL is simply the * operator in GLSL
-    "noise",            "noise",
-    "normalize",        "normalize",
-    "pow",              "pow",
-    "radians",          "radians",
-    "rcp",              "sqrt",
-    "reflect",          "reflect",
-    "refract",          "refract",
-    "round",            "round",
-    "rsqrt",            "1.0 / sqrt",
-    "saturate",         "min(1.0, max(0.0, ",
-    "sign",             "sign",
-    "sin",              "sin",
-    "sinh",             "sinh",
-    "smoothstep",       "smoothstep",
-    "sqrt",             "sqrt",
-    "step",             "step",
-    "tan",              "tan",
-    "tanh",             "tanh",
-    "tex1D",            "texture",
-    "tex1Dbias",        "texture",
-    "tex1Dgrad",        "textureGrad",
-    "tex1Dlod",         "textureLod",
-    "tex1Dproj",        "textureProj",
-    "tex2D",            "texture",
-    "tex2Dbias",        "texture",
-    "tex2Dgrad",        "textureGrad",
-    "tex2Dlod",         "textureLod",
-    "tex2Dproj",        "textureProj",
-    "tex3D",            "texture",
-    "tex3Dbias",        "texture",
-    "tex3Dgrad",        "textureGrad",
-    "tex3Dlod",         "textureLod",
-    "tex3Dproj",        "textureProj",
-    "texCUBE",          "texture",
-    "texCUBEbias",      "texture",
-    "texCUBEgrad",      "textureGrad",
-    "texCUBElod",       "textureLod",
-    "texCUBEproj",      "textureProj",
-    "transpose",        "transpose",
-    "trunc",            "trunc"
-};
-
-void ConvertLexemesIntoGlsl(const vector<Lexeme>& lexemes, const string& entryFunctionName, bool isVertexShader, string& outputGlsl)
+// Computes the layout of each reachable cbuffer, and replaces the uses of the members read from a register by the
+// read. Those members must have a name nothing else declares, such as a parameter, a local variable or a struct
+// member, since which of the names a use refers to isn't known: their block is declared as is otherwise.
+void PlanUniformBlocks(const LexemeStream& lexemes, ConversionContext& context)
 {
-    ResetGlobalVariables();
-
-    vector<string> originalTextureNames = PreprocessTextures(lexemes, outputGlsl);
+    const SyntaxTree& syntaxTree = *context.m_SyntaxTree;
+    pmr::vector<UniformBlock>& uniformBlocks = context.m_UniformBlocks;
 
-    for (size_t i = 0; i < lexemes.size(); i++)
+    size_t unreachableCodeCursor = 0;
+    for (const DeclarationNode& declaration : syntaxTree.m_Declarations)
     {
-        if (startOfLine)
+        if (lexemes.GetTokenClass(declaration.m_Keyword) != TokenClass_t::CBUFFER || declaration.m_Name == INVALID_LEXEME_INDEX ||
+            declaration.m_End == INVALID_LEXEME_INDEX || SkipUnreachableCode(context.m_UnreachableCode, unreachableCodeCursor, declaration.m_Keyword) != declaration.m_Keyword)
         {
-            startOfLine = false;
+            continue;
         }
 
-        InterpretLexeme(lexemes, entryFunctionName, originalTextureNames, i, isVertexShader, outputGlsl);
+        const LexemeIndex_t openedCurlyBracket = declaration.m_End + 1;
+        if (openedCurlyBracket >= lexemes.size() || lexemes.GetTokenClass(openedCurlyBracket) != TokenClass_t::OPENED_CURLY_BRACKET)
+        {
+            continue;
+        }
+
+        UniformBlock uniformBlock{ declaration.m_Name, openedCurlyBracket, false, UniformBlockLayout(context.m_MemoryResource) };
+        uniformBlock.m_IsAnalyzed = ComputeUniformBlockLayout(lexemes, syntaxTree, openedCurlyBracket, uniformBlock.m_Layout);
+        uniformBlocks.push_back(move(uniformBlock));
     }
-}
 
-vector<string> PreprocessTextures(const vector<Lexeme>& lexemes, string& outputGlsl)
-{
-    vector<string> originalTextureNames;
+    // Block and member of each symbol read from a register
+    const uint32_t NOT_READ_FROM_REGISTER = 0xFFFFFFFF;
+    pmr::vector<pair<uint32_t, uint32_t>> registerMembers(context.m_MemoryResource);
+    pmr::vector<uint32_t> registerMemberOfSymbols(lexemes.GetSymbolTable().size(), NOT_READ_FROM_REGISTER, context.m_MemoryResource);
 
-    // Pair of string and register slot. For textures, additionally store the dimension (1, 2 or 3)
-    vector<pair<string, int>> samplerStateNames;
-    vector<pair<pair<string, int>, int>> textureNames;
+    for (uint32_t i = 0; i < uniformBlocks.size(); i++)
+    {
+        const UniformBlockLayout& layout = uniformBlocks[i].m_Layout;
+        for (uint32_t j = 0; j < layout.m_Members.size(); j++)
+        {
+            const SymbolId_t symbolId = lexemes.GetSymbolId(layout.m_Members[j].m_Name);
+            if (layout.m_MemberRegisters[j] != INVALID_REGISTER && symbolId < registerMemberOfSymbols.size())
+            {
+                registerMemberOfSymbols[symbolId] = (uint32_t) registerMembers.size();
+                registerMembers.emplace_back(i, j);
+            }
+        }
+    }
 
-    for (size_t i = 0; i < lexemes.size(); i++)
+    if (registerMembers.empty())
     {
-        const Lexeme& lexeme = lexemes[i];
-        Lexeme registerLexeme;
+        return;
+    }
 
-        size_t dimension = 0;
-        pair<string, int> nameRegister;
+    // Uses of the members read from a register, outside of the bodies of the blocks where they are declared
+    pmr::vector<pair<LexemeIndex_t, uint32_t>> uses(context.m_MemoryResource);
+    pmr::vector<uint8_t> isBlockDeclaredAsIs(uniformBlocks.size(), 0, context.m_MemoryResource);
+    pmr::vector<TokenClass_t> openedBrackets(context.m_MemoryResource);
+    size_t uniformBlock = 0;
 
-        if (lexeme.m_TokenClass == TokenClass_t::SAMPLER_STATE)
+    unreachableCodeCursor = 0;
+    for (size_t i = SkipUnreachableCode(context.m_UnreachableCode, unreachableCodeCursor, 0); i < lexemes.size();
+         i = SkipUnreachableCode(context.m_UnreachableCode, unreachableCodeCursor, i + 1))
+    {
+        if (uniformBlock < uniformBlocks.size() && i == uniformBlocks[uniformBlock].m_OpenedCurlyBracket)
         {
-            registerLexeme = lexemes[i + 5];
-            nameRegister = pair<string, int>(lexemes[i + 1].m_Token, atoi(registerLexeme.m_Token.substr(1, string::npos).c_str()));
-            samplerStateNames.push_back(nameRegister);
-            i += 1;
+            const LexemeIndex_t closedCurlyBracket = syntaxTree.GetMatchingBracket(i);
+            uniformBlock += 1;
+
+            if (closedCurlyBracket != INVALID_LEXEME_INDEX)
+            {
+                i = closedCurlyBracket;
+                continue;
+            }
         }
-        else if (lexeme.m_TokenClass == TokenClass_t::TEXTURE)
+
+        const TokenClass_t tokenClass = lexemes.GetTokenClass(i);
+        if (IsOpenedBracket(tokenClass))
         {
-            originalTextureNames.push_back(lexemes[i + 1].m_Token);
+            openedBrackets.push_back(tokenClass);
+            continue;
+        }
 
-            registerLexeme = lexemes[i + 5];
+        if (IsClosedBracket(tokenClass))
+        {
+            if (!openedBrackets.empty())
+            {
+                openedBrackets.pop_back();
+            }
 
-            dimension = (size_t)(lexeme.m_Token[lexeme.m_Token.size() - 2] - '0');
+            continue;
+        }
 
-            nameRegister = pair<string, int>(lexemes[i + 1].m_Token, atoi(registerLexeme.m_Token.substr(1, string::npos).c_str()));
-            textureNames.push_back(pair<pair<string, int>, int>(nameRegister, dimension));
-            i += 1;
+        const SymbolId_t symbolId = lexemes.GetSymbolId(i);
+        if (tokenClass != TokenClass_t::VARIABLE_NAME || symbolId >= registerMemberOfSymbols.size() || registerMemberOfSymbols[symbolId] == NOT_READ_FROM_REGISTER)
+        {
+            continue;
         }
-        else if (lexeme.m_TokenClass ==  TokenClass_t::STRUCTURE_OPERATOR)
+
+        // A member of a struct with the same name
+        const TokenClass_t previousTokenClass = (i > 0) ? lexemes.GetTokenClass(i - 1) : TokenClass_t::SEMICOLUMN;
+        if (previousTokenClass == TokenClass_t::STRUCTURE_OPERATOR)
         {
-            // Check if the keyword after that is Sample and if the keyword before that is a texture name
-            const Lexeme& previousLexeme = lexemes[i - 1];
-            const Lexeme& nextLexeme = lexemes[i + 1];
+            continue;
+        }
 
-            auto pred = [&] (pair<pair<string, int>, int> val) {
-                return (val.first.first == previousLexeme.m_Token);
-            };
+        // Another declaration of the name, after its type or after a comma outside of the arguments of a call: float a, name;
+        const bool isArgument = !openedBrackets.empty() && openedBrackets.back() != TokenClass_t::OPENED_CURLY_BRACKET;
+        if (previousTokenClass == TokenClass_t::TYPE || previousTokenClass == TokenClass_t::VARIABLE_NAME || previousTokenClass == TokenClass_t::STRUCT ||
+            (previousTokenClass == TokenClass_t::COMMA && !isArgument))
+        {
+            isBlockDeclaredAsIs[registerMembers[registerMemberOfSymbols[symbolId]].first] = 1;
+            continue;
+        }
 
-            if ( !(find_if(textureNames.begin(), textureNames.end(), pred) != textureNames.end() && nextLexeme.m_Token == "Sample") )
-            {
-                continue;
-            }
+        // An array is read from its registers one element at a time, the whole of it can't be
+        const pair<uint32_t, uint32_t>& registerMember = registerMembers[registerMemberOfSymbols[symbolId]];
+        if (uniformBlocks[registerMember.first].m_Layout.m_Members[registerMember.second].m_ArraySize > 0 &&
+            (i + 1 >= lexemes.size() || lexemes.GetTokenClass(i + 1) != TokenClass_t::OPENED_ANGLE_BRACKET ||
+             syntaxTree.GetMatchingBracket(i + 1) == INVALID_LEXEME_INDEX))
+        {
+            isBlockDeclaredAsIs[registerMember.first] = 1;
+            continue;
+        }
+
+        uses.emplace_back((LexemeIndex_t) i, registerMemberOfSymbols[symbolId]);
+    }
+
+    for (size_t i = 0; i < uniformBlocks.size(); i++)
+    {
+        if (isBlockDeclaredAsIs[i])
+        {
+            DeclareMembersAsIs(uniformBlocks[i].m_Layout);
+        }
+    }
+
+    // Uses inside of a folded expression are already replaced with it
+    pmr::vector<LexemeReplacement> registerReads(context.m_MemoryResource);
+    size_t replacement = 0;
+
+    for (const pair<LexemeIndex_t, uint32_t>& use : uses)
+    {
+        const UniformBlock& useBlock = uniformBlocks[registerMembers[use.second].first];
+        if (isBlockDeclaredAsIs[registerMembers[use.second].first])
+        {
+            continue;
+        }
+
+        while (replacement < context.m_Replacements.size() && context.m_Replacements[replacement].m_Range.m_End <= use.first)
+        {
+            replacement += 1;
+        }
+
+        if (replacement < context.m_Replacements.size() && context.m_Replacements[replacement].m_Range.m_Begin <= use.first)
+        {
+            continue;
+        }
+
+        const UniformBlockLayout& layout = useBlock.m_Layout;
+        const UniformBlockMember& member = layout.m_Members[registerMembers[use.second].second];
+        const uint32_t firstRegister = layout.m_MemberRegisters[registerMembers[use.second].second];
+        const UniformBlockEntry& entry = *find_if(layout.m_Entries.begin(), layout.m_Entries.end(),
+                                                  [firstRegister](const UniformBlockEntry& registerEntry) { return registerEntry.m_Register == firstRegister; });
+
+        const string_view blockName = lexemes.GetToken(useBlock.m_Name);
+        const string_view glslType = GetKeyword(lexemes.GetKeywordId(member.m_Type)).m_Glsl;
+
+        if (member.m_ArraySize > 0)
+        {
+            registerReads.push_back(LexemeReplacement{ LexemeRange{ use.first, use.first + 2 }, pmr::string(context.m_MemoryResource) });
+            OutputWriter readBegin(registerReads.back().m_Glsl);
+            AppendRegisterArrayReadBegin(blockName, member, entry, glslType, readBegin);
+
+            const LexemeIndex_t closedBracket = syntaxTree.GetMatchingBracket(use.first + 1);
+            registerReads.push_back(LexemeReplacement{ LexemeRange{ closedBracket, closedBracket + 1 }, pmr::string(context.m_MemoryResource) });
+            OutputWriter readEnd(registerReads.back().m_Glsl);
+            AppendRegisterArrayReadEnd(member, entry.m_Register, glslType, readEnd);
+            continue;
+        }
+
+        registerReads.push_back(LexemeReplacement{ LexemeRange{ use.first, use.first + 1 }, pmr::string(context.m_MemoryResource) });
+        OutputWriter registerRead(registerReads.back().m_Glsl);
+        AppendRegisterRead(blockName, member, entry, glslType, registerRead);
+    }
+
+    // The end of the read of an array element comes after the reads in its index
+    sort(registerReads.begin(), registerReads.end(),
+         [](const LexemeReplacement& a, const LexemeReplacement& b) { return a.m_Range.m_Begin < b.m_Range.m_Begin; });
+
+    pmr::vector<LexemeReplacement> replacements(context.m_MemoryResource);
+    replacements.reserve(context.m_Replacements.size() + registerReads.size());
+    merge(make_move_iterator(context.m_Replacements.begin()), make_move_iterator(context.m_Replacements.end()), make_move_iterator(registerReads.begin()),
+          make_move_iterator(registerReads.end()), back_inserter(replacements),
+          [](const LexemeReplacement& a, const LexemeReplacement& b) { return a.m_Range.m_Begin < b.m_Range.m_Begin; });
+
+    context.m_Replacements = move(replacements);
+}
+
+void ConvertLexemesIntoGlsl(const LexemeStream& lexemes, const string& entryFunctionName, bool isVertexShader, string& outputGlsl,
+                            const ConversionOptions& options, pmr::memory_resource* memoryResource)
+{
+    PhaseClock clock(options.m_ConversionStatistics);
+
+    const SyntaxTree syntaxTree = ParseSyntaxTree(lexemes, memoryResource);
+
+    ConversionContext context(memoryResource);
+    InitializeConversionContext(lexemes, syntaxTree, entryFunctionName, isVertexShader, options, context);
+
+    clock.Lap(&ConversionStatistics::m_AnalysisSeconds);
+
+    // Whitespace is collapsed but comments are kept, so the GLSL is usually a bit shorter than the HLSL it
+    // comes from. Reserving that much up front means the output is allocated once for most shaders.
+    pmr::string generatedGlsl(memoryResource);
+    OutputWriter output(generatedGlsl);
+    output.Reserve(lexemes.GetSource().size());
+
+    PreprocessTextures(lexemes, context, output);
+    DeclareIntrinsicHelpers(lexemes, context, output);
+
+    clock.Lap(&ConversionStatistics::m_PreprocessSeconds);
+
+    size_t unreachableCodeCursor = 0;
+    for (size_t i = SkipUnreachableCode(context.m_UnreachableCode, unreachableCodeCursor, 0); i < lexemes.size();
+         i = SkipUnreachableCode(context.m_UnreachableCode, unreachableCodeCursor, i + 1))
+    {
+        InterpretLexemeOrReplacement(lexemes, context, i, output);
+    }
+
+    if (options.m_Minify)
+    {
+        clock.Lap(&ConversionStatistics::m_EmissionSeconds);
+
+        pmr::string minifiedGlsl(memoryResource);
+        MinifyGlsl(generatedGlsl, options.m_RenameLocals, minifiedGlsl, options.m_MinificationStatistics, memoryResource);
 
-            size_t samplerStateIndex = 0;
-            size_t textureIndex = 0;
+        outputGlsl.append(minifiedGlsl);
+        clock.Lap(&ConversionStatistics::m_MinificationSeconds);
+        return;
+    }
+
+    outputGlsl.append(generatedGlsl);
+    clock.Lap(&ConversionStatistics::m_EmissionSeconds);
+}
+
+void PreprocessTextures(const LexemeStream& lexemes, ConversionContext& context, OutputWriter& output)
+{
+    SymbolTable& symbolTable = lexemes.GetSymbolTable();
+    const SyntaxTree& syntaxTree = *context.m_SyntaxTree;
+
+    // Register slot of each name. Textures also have their dimension (1, 2 or 3).
+    struct TextureRegister
+    {
+        int m_Slot;
+        int m_Dimension;
+    };
 
-            // Register the name of the UV coordinates first
-            string uvName = lexemes[i + 5].m_Token;
+    pmr::unordered_map<SymbolId_t, int> samplerStateRegisters(context.m_MemoryResource);
+    pmr::unordered_map<SymbolId_t, TextureRegister> textureRegisters(context.m_MemoryResource);
 
-            if (lexemes[i + 6].m_TokenClass != TokenClass_t::CLOSED_PARANTHESIS)
+    // Sampler state and texture pairs used by Sample, each one once
+    struct SamplerStateTexture
+    {
+        uint64_t m_Key;
+        size_t m_SamplerStateIndex;
+        size_t m_TextureIndex;
+        size_t m_Dimension;
+    };
+
+    pmr::vector<SamplerStateTexture> samplerStateTextures(context.m_MemoryResource);
+    pmr::unordered_set<uint64_t> usedSamplerStateTextures(context.m_MemoryResource);
+
+    // Only the textures sampled by reachable code get a combined sampler
+    size_t unreachableCodeCursor = 0;
+    for (size_t i = SkipUnreachableCode(context.m_UnreachableCode, unreachableCodeCursor, 0); i < lexemes.size();
+         i = SkipUnreachableCode(context.m_UnreachableCode, unreachableCodeCursor, i + 1))
+    {
+        const Lexeme& lexeme = lexemes[i];
+
+        if (lexeme.m_TokenClass == TokenClass_t::SAMPLER_STATE || lexeme.m_TokenClass == TokenClass_t::TEXTURE)
+        {
+            const DeclarationNode* declaration = syntaxTree.FindDeclaration(i);
+            if (declaration == nullptr || declaration->m_Name == INVALID_LEXEME_INDEX)
             {
-                uvName += lexemes[i + 6].m_Token + lexemes[i + 7].m_Token;
+                continue;
             }
 
-            bool registerUvName = true;
-            for (size_t j = 0; j < uvNames.size(); j++)
+            const SymbolId_t nameSymbolId = lexemes.GetSymbolId(declaration->m_Name);
+            const int registerSlot = (int) GetRegisterSlot(lexemes, *declaration);
+
+            if (lexeme.m_TokenClass == TokenClass_t::SAMPLER_STATE)
             {
-                if (uvNames[j] == uvName)
-                {
-                    registerUvName = false;
-                    break;
-                }
+                samplerStateRegisters.emplace(nameSymbolId, registerSlot);
             }
-
-            if (registerUvName)
+            else
             {
-                uvNames.push_back(uvName);
+                AddSymbolFlag(context, nameSymbolId, SYMBOL_TEXTURE_NAME);
+
+                int dimension = lexeme.m_Token[lexeme.m_Token.size() - 2] - '0';
+
+                textureRegisters.emplace(nameSymbolId, TextureRegister{ registerSlot, dimension });
             }
 
-            for (size_t j = 0; j < samplerStateNames.size(); j++)
+            i = declaration->m_Name;
+        }
+        else if (lexeme.m_TokenClass == TokenClass_t::VARIABLE_NAME)
+        {
+            // Check if this is a texture name followed by .Sample(
+            auto textureRegister = textureRegisters.find(lexeme.m_SymbolId);
+            if (textureRegister == textureRegisters.end())
             {
-                if (samplerStateNames[j].first == lexemes[i + 3].m_Token)
-                {
-                    samplerStateIndex = samplerStateNames[j].second;
-                    break;
-                }
+                continue;
             }
 
-            for (size_t j = 0; j < textureNames.size(); j++)
+            const CallNode* sampleCall = FindSampleCall(lexemes, context, i);
+            if (sampleCall == nullptr)
             {
-                if (textureNames[j].first.first == previousLexeme.m_Token)
-                {
-                    textureIndex = textureNames[j].first.second;
-                    break;
-                }
+                continue;
             }
 
-            // Add the new texture name if it's not already in the list, in order of sampler register and then texture register slot
-            string samplerStateTextureIndex;
-            stringstream ss;
-            ss << "_" << samplerStateIndex << "_" << setfill('0') << setw(2) << textureIndex;
-            samplerStateTextureIndex = ss.str();
+            // Register the name of the UV coordinates first. It is interned as a whole, i.e. input.uv
+            const LexemeRange uvNameRange = GetUvNameRange(lexemes, context, *sampleCall);
 
-            string samplerStateTextureName = lexemes[i + 3].m_Token + previousLexeme.m_Token + samplerStateTextureIndex;
+            pmr::string uvName(context.m_MemoryResource);
+            AppendTokens(lexemes, uvNameRange, uvName);
 
-            bool isInList = false;
-            for (size_t j = 0; j < samplerStateTextureNames.size(); j++)
+            const SymbolId_t uvSymbolId = uvNameRange.empty() ? INVALID_SYMBOL_ID : symbolTable.Intern(uvName);
+            if (uvSymbolId != INVALID_SYMBOL_ID && !HasSymbolFlag(context, uvSymbolId, SYMBOL_UV_NAME))
             {
-                if (samplerStateTextureNames[j] == samplerStateTextureName)
-                {
-                    isInList = true;
-                    break;
-                }
+                AddSymbolFlag(context, uvSymbolId, SYMBOL_UV_NAME);
+                context.m_UvNames.push_back(uvSymbolId);
             }
 
-            if (isInList)
+            const SymbolId_t samplerStateSymbolId = lexemes.GetSymbolId(syntaxTree.GetArgument(*sampleCall, 0).m_Begin);
+
+            const uint64_t key = GetSamplerStateTextureKey(samplerStateSymbolId, lexeme.m_SymbolId);
+            if (!usedSamplerStateTextures.insert(key).second)
             {
                 continue;
             }
 
-            size_t index = 0;
-            for (; index < samplerStateTextureNames.size(); index++)
-            {
-                const string& name = samplerStateTextureNames[index];
-                size_t tIndex = atoi(name.substr(name.size() - 2, 2).c_str());
-                size_t sIndex = atoi(name.substr(name.size() - 4, 1).c_str());
+            auto samplerStateRegister = samplerStateRegisters.find(samplerStateSymbolId);
 
-                if (samplerStateIndex <= sIndex && textureIndex < tIndex)
-                {
-                    break;
-                }
-            }
-
-            samplerStateTextureNames.insert(samplerStateTextureNames.begin() + index, samplerStateTextureName);
+            SamplerStateTexture samplerStateTexture;
+            samplerStateTexture.m_Key = key;
+            samplerStateTexture.m_SamplerStateIndex = (samplerStateRegister != samplerStateRegisters.end()) ? samplerStateRegister->second : 0;
+            samplerStateTexture.m_TextureIndex = textureRegister->second.m_Slot;
+            samplerStateTexture.m_Dimension = textureRegister->second.m_Dimension;
 
+            samplerStateTextures.push_back(samplerStateTexture);
         }
     }
 
+    // Units are given in the order of the texture registers, so that the units of a shader don't depend on the order
+    // in which it samples its textures
+    sort(samplerStateTextures.begin(), samplerStateTextures.end(), [](const SamplerStateTexture& a, const SamplerStateTexture& b) {
+        return (a.m_TextureIndex != b.m_TextureIndex) ? a.m_TextureIndex < b.m_TextureIndex : a.m_SamplerStateIndex < b.m_SamplerStateIndex;
+    });
+
+    SamplerBindingTable localSamplerBindings(context.m_MemoryResource);
+    SamplerBindingTable& samplerBindings = (context.m_SamplerBindings != nullptr) ? *context.m_SamplerBindings : localSamplerBindings;
+
     // Output the sampler states
-    for (size_t i = 0; i < samplerStateTextureNames.size(); i++)
+    for (const SamplerStateTexture& samplerStateTexture : samplerStateTextures)
     {
-        size_t samplerIndex = atoi(samplerStateTextureNames[i].substr(samplerStateTextureNames[i].size() - 4, 1).c_str());
-        size_t textureIndex = atoi(samplerStateTextureNames[i].substr(samplerStateTextureNames[i].size() - 2, 2).c_str());
-        size_t dimension = textureNames[textureIndex].second;
+        size_t dimension = samplerStateTexture.m_Dimension;
 
-        size_t idx = samplerStateNames[samplerIndex].second * originalTextureNames.size() + textureNames[textureIndex].first.second;
-        
-        string nameIndex = "";
-        stringstream ss;
-        ss << "_" << samplerIndex << "_" << setfill('0') << setw(2) << textureIndex;
-        nameIndex = ss.str();
-        string nameToUse = "texture" + nameIndex;
+        pmr::string nameToUse("texture", context.m_MemoryResource);
+        AppendSamplerStateTextureIndex(nameToUse, samplerStateTexture.m_SamplerStateIndex, samplerStateTexture.m_TextureIndex);
 
-        samplerStateTextureNamesToUse.push_back(nameToUse);
+        const uint32_t unit = samplerBindings.Allocate(nameToUse, (uint32_t) samplerStateTexture.m_SamplerStateIndex, (uint32_t) samplerStateTexture.m_TextureIndex,
+                                                       (uint32_t) dimension);
 
-        outputGlsl += "uniform sampler" + to_string(dimension) + "D " + nameToUse + ";\n";
+        if (context.m_Profile->m_IsVulkan)
+        {
+            output.Append("layout(set = 1, binding = ");
+            output.AppendInteger(unit);
+            output.Append(") ");
+        }
+        else if (context.m_Profile->m_HasBindings)
+        {
+            output.Append("layout(binding = ");
+            output.AppendInteger(unit);
+            output.Append(") ");
+        }
+
+        output.Append("uniform sampler");
+        output.AppendInteger(dimension);
+        output.Append("D ", nameToUse, ";\n");
+
+        context.m_SamplerStateTextureNames.emplace(samplerStateTexture.m_Key, move(nameToUse));
     }
 
-    outputGlsl += "\n";
+    output.Append("\n");
+}
+
+void DeclareIntrinsicHelpers(const LexemeStream& lexemes, ConversionContext& context, OutputWriter& output)
+{
+    // GLSL functions some lowered intrinsics call, declared once if reachable code calls the intrinsic
+    pmr::vector<string_view> declaredHelpers(context.m_MemoryResource);
+    const SyntaxTree& syntaxTree = *context.m_SyntaxTree;
 
-    return originalTextureNames;
+    // Calls are in the order of their lexemes, so the cursor in the unreachable code only moves forward
+    size_t unreachableCodeCursor = 0;
+    for (const CallNode& call : syntaxTree.m_Calls)
+    {
+        if (call.m_NumberOfArguments > MAXIMUM_NUMBER_OF_INTRINSIC_ARGUMENTS ||
+            lexemes.GetTokenClass(call.m_Function) != TokenClass_t::BUILTIN_FUNCTION ||
+            SkipUnreachableCode(context.m_UnreachableCode, unreachableCodeCursor, call.m_Function) != call.m_Function)
+        {
+            continue;
+        }
+
+        const IntrinsicLowering* lowering = FindIntrinsicLowering(lexemes.GetToken(call.m_Function), call.m_NumberOfArguments, context.m_Profile->m_Version);
+        if (lowering == nullptr || lowering->m_Helper.empty() ||
+            find(declaredHelpers.begin(), declaredHelpers.end(), lowering->m_Helper) != declaredHelpers.end())
+        {
+            continue;
+        }
+
+        output.Append(lowering->m_Helper, "\n");
+        declaredHelpers.push_back(lowering->m_Helper);
+    }
 }
 
-void InterpretLexeme(const vector<Lexeme>& lexemes, const string& entryFunctionName, const vector<string>& originalTextureNames, size_t& lexemeIndex,
-                     bool isVertexShader, string& outputGlsl)
+void InterpretLexemeOrReplacement(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output)
 {
-    const Lexeme& lexeme = lexemes[lexemeIndex];
+    const LexemeReplacement* replacement = FindReplacement(context.m_Replacements, lexemeIndex);
+    if (replacement != nullptr)
+    {
+        output.Append(replacement->m_Glsl);
+        lexemeIndex = replacement->m_Range.m_End - 1;
+        return;
+    }
 
-    switch (lexeme.m_TokenClass)
+    InterpretLexeme(lexemes, context, *context.m_EntryFunctionName, lexemeIndex, context.m_IsVertexShader, output);
+}
+
+void InterpretExpression(const LexemeStream& lexemes, ConversionContext& context, LexemeRange range, OutputWriter& output)
+{
+    for (size_t i = range.m_Begin; i < range.m_End; i++)
     {
-    case TokenClass_t::ARITHMETIC_OPERATOR:     InterpretArithmeticOperator(lexemes, lexemeIndex, outputGlsl); break;
-    case TokenClass_t::ASSIGNATION:             InterpretAssignation(lexemes, lexemeIndex, outputGlsl); break;
-    case TokenClass_t::BITWISE_OPERATOR:        InterpretBitwiseOperator(lexemes, lexemeIndex, outputGlsl); break;
-    case TokenClass_t::BUILTIN_FUNCTION:        InterpretBuiltinFunction(lexemes, lexemeIndex, outputGlsl); break;
-    case TokenClass_t::CBUFFER:                 InterpretCbuffer(lexemes, lexemeIndex, outputGlsl); break;
-    case TokenClass_t::CLOSED_ANGLE_BRACKET:    IntrepretClosedAngleBracket(lexemes, lexemeIndex, outputGlsl); break;
-    case TokenClass_t::CLOSED_CURLY_BRACKET:    InterpretClosedCurlyBracket(lexemes, lexemeIndex, isVertexShader, outputGlsl); break;
-    case TokenClass_t::CLOSED_PARANTHESIS:      IntrepretClosedParanthesis(lexemes, lexemeIndex, outputGlsl); break;
-    case TokenClass_t::COLON:                   InterpretColon(lexemes, lexemeIndex, isVertexShader, outputGlsl); break;
-    case TokenClass_t::COMMA:                   InterpretComma(lexemes, lexemeIndex, outputGlsl); break;
-    case TokenClass_t::COMMENT:                 InterpretComment(lexemes, lexemeIndex, outputGlsl); break;
-    case TokenClass_t::FLOW_CONTROL:            InterpretFlowControl(lexemes, lexemeIndex, outputGlsl); break;
-    case TokenClass_t::OPENED_ANGLE_BRACKET:    InterpretOpenedAngleBracket(lexemes, lexemeIndex, outputGlsl); break;
-    case TokenClass_t::OPENED_CURLY_BRACKET:    InterpretOpenedCurlyBracket(lexemes, lexemeIndex, outputGlsl); break;
-    case TokenClass_t::OPENED_PARANTHESIS:      InterpretOpenedParanthesis(lexemes, lexemeIndex, outputGlsl); break;
-    case TokenClass_t::REGISTER:                InterpretRegister(lexemes, lexemeIndex, outputGlsl); break;
-    case TokenClass_t::RELATIONAL_OPERATOR:     InterpretRelationalOperator(lexemes, lexemeIndex, outputGlsl); break;
-    case TokenClass_t::SAMPLER_STATE:           InterpretSamplerState(lexemes, lexemeIndex, outputGlsl); break;
-    case TokenClass_t::SEMICOLUMN:              InterpretSemiColumn(lexemes, lexemeIndex, outputGlsl); break;
-    case TokenClass_t::STRUCT:                  InterpretStruct(lexemes, lexemeIndex, outputGlsl); break;
-    case TokenClass_t::STRUCTURE_OPERATOR:      InterpretStructureOperator(lexemes, lexemeIndex, outputGlsl); break;
-    case TokenClass_t::TEXTURE:                 InterpretTexture(lexemes, lexemeIndex, outputGlsl); break;
-    case TokenClass_t::TERNARY_OPERATOR:        InterpretTernaryOperator(lexemes, lexemeIndex, outputGlsl); break;
-    case TokenClass_t::TYPE:                    InterpretType(lexemes, lexemeIndex, outputGlsl); break;
-    case TokenClass_t::VARIABLE_NAME:           InterpretVariableName(lexemes, entryFunctionName, isVertexShader, originalTextureNames, lexemeIndex, outputGlsl); break;
+        InterpretLexemeOrReplacement(lexemes, context, i, output);
     }
 }
 
-void InterpretArithmeticOperator(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl)
+void InterpretLexeme(const LexemeStream& lexemes, ConversionContext& context, const string& entryFunctionName, size_t& lexemeIndex,
+                     bool isVertexShader, OutputWriter& output)
 {
-    // +, -, *, /, %. Check for assignation on next lexeme, or if prefix increment/decrement
     const Lexeme& lexeme = lexemes[lexemeIndex];
-    
-    // Prefix increment/decrement?
-    if (lexeme.m_Token == "+" || lexeme.m_Token == "-")
-    {
-        if (lexemeIndex < lexemes.size() - 1)
-        {
-            const Lexeme& nextLexeme = lexemes[lexemeIndex + 1];
 
-            if (nextLexeme.m_Token == lexeme.m_Token)
-            {
-                outputGlsl += " " + lexeme.m_Token + lexeme.m_Token;
-                lexemeIndex += 1;
-                return;
-            }
-        }
+    switch (lexeme.m_TokenClass)
+    {
+    case TokenClass_t::ARITHMETIC_OPERATOR:     InterpretArithmeticOperator(lexemes, context, lexemeIndex, output); break;
+    case TokenClass_t::ASSIGNATION:             InterpretAssignation(lexemes, context, lexemeIndex, output); break;
+    case TokenClass_t::BITWISE_OPERATOR:        InterpretBitwiseOperator(lexemes, context, lexemeIndex, output); break;
+    case TokenClass_t::BUILTIN_FUNCTION:        InterpretBuiltinFunction(lexemes, context, lexemeIndex, output); break;
+    case TokenClass_t::CBUFFER:                 InterpretCbuffer(lexemes, context, lexemeIndex, output); break;
+    case TokenClass_t::CLOSED_ANGLE_BRACKET:    IntrepretClosedAngleBracket(lexemes, context, lexemeIndex, output); break;
+    case TokenClass_t::CLOSED_CURLY_BRACKET:    InterpretClosedCurlyBracket(lexemes, context, lexemeIndex, isVertexShader, output); break;
+    case TokenClass_t::CLOSED_PARANTHESIS:      IntrepretClosedParanthesis(lexemes, context, lexemeIndex, output); break;
+    case TokenClass_t::COLON:                   InterpretColon(lexemes, context, lexemeIndex, isVertexShader, output); break;
+    case TokenClass_t::COMMA:                   InterpretComma(lexemes, context, lexemeIndex, output); break;
+    case TokenClass_t::COMMENT:                 InterpretComment(lexemes, context, lexemeIndex, output); break;
+    case TokenClass_t::FLOW_CONTROL:            InterpretFlowControl(lexemes, context, lexemeIndex, output); break;
+    case TokenClass_t::OPENED_ANGLE_BRACKET:    InterpretOpenedAngleBracket(lexemes, context, lexemeIndex, output); break;
+    case TokenClass_t::OPENED_CURLY_BRACKET:    InterpretOpenedCurlyBracket(lexemes, context, lexemeIndex, output); break;
+    case TokenClass_t::OPENED_PARANTHESIS:      InterpretOpenedParanthesis(lexemes, context, lexemeIndex, output); break;
+    case TokenClass_t::REGISTER:                InterpretRegister(lexemes, context, lexemeIndex, output); break;
+    case TokenClass_t::RELATIONAL_OPERATOR:     InterpretRelationalOperator(lexemes, context, lexemeIndex, output); break;
+    case TokenClass_t::SAMPLER_STATE:           InterpretSamplerState(lexemes, context, lexemeIndex, output); break;
+    case TokenClass_t::SEMICOLUMN:              InterpretSemiColumn(lexemes, context, lexemeIndex, output); break;
+    case TokenClass_t::STRUCT:                  InterpretStruct(lexemes, context, lexemeIndex, output); break;
+    case TokenClass_t::STRUCTURE_OPERATOR:      InterpretStructureOperator(lexemes, context, lexemeIndex, output); break;
+    case TokenClass_t::TEXTURE:                 InterpretTexture(lexemes, context, lexemeIndex, output); break;
+    case TokenClass_t::TERNARY_OPERATOR:        InterpretTernaryOperator(lexemes, context, lexemeIndex, output); break;
+    case TokenClass_t::TYPE:                    InterpretType(lexemes, context, lexemeIndex, output); break;
+    case TokenClass_t::VARIABLE_NAME:           InterpretVariableName(lexemes, context, entryFunctionName, isVertexShader, lexemeIndex, output); break;
     }
+}
 
-    // If there's an equal sign, then don't put a space afterwards
-    bool addSpace = true;
-    if (lexemes[lexemeIndex + 1].m_TokenClass == TokenClass_t::ASSIGNATION)
+void InterpretArithmeticOperator(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output)
+{
+    // +, -, *, /, %, their compound assignations and the increment/decrement operators, which the tokenizer
+    // already gives us as a single lexeme
+    const Lexeme& lexeme = lexemes[lexemeIndex];
+    
+    // Increment/decrement?
+    if (lexeme.m_Token == "++" || lexeme.m_Token == "--")
     {
-        addSpace = false;
+        output.Append(" ", lexeme.m_Token);
+        return;
     }
 
     // Simple arithmetic operator
-    outputGlsl += " " + lexeme.m_Token + ((addSpace) ? " " : "");
+    output.Append(" ", lexeme.m_Token, " ");
 }
 
-void InterpretAssignation(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl)
+void InterpretAssignation(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output)
 {
     const Lexeme& lexeme = lexemes[lexemeIndex];
 
     // Simple assignation
-    outputGlsl += lexeme.m_Token + " ";
+    output.Append(lexeme.m_Token, " ");
 }
 
-void InterpretBitwiseOperator(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl)
+void InterpretBitwiseOperator(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output)
 {
-    // ~, |, &, ^
+    // ~, |, &, ^, as well as &&, ||, |=, &=, ^= which the tokenizer gives us as a single lexeme
     const Lexeme& lexeme = lexemes[lexemeIndex];
 
-    // Have to check if it is a relationnal operator (for | and &)
-    if (lexeme.m_Token == "|" || lexeme.m_Token == "&")
+    if (lexeme.m_Token.size() > 1)
     {
-        if (lexemeIndex < lexemes.size() - 1)
-        {
-            const Lexeme& nextLexeme = lexemes[lexemeIndex];
+        output.Append(" ", lexeme.m_Token, " ");
+        return;
+    }
 
-            if (nextLexeme.m_TokenClass == TokenClass_t::BITWISE_OPERATOR)
-            {
-                if (nextLexeme.m_Token == lexeme.m_Token)
-                {
-                    outputGlsl += " " + lexeme.m_Token + lexeme.m_Token + " ";
-                    lexemeIndex += 1;
-                    return;
-                }
-            }
-        }
+    output.Append(" ", lexeme.m_Token);
+}
+
+void InterpretBuiltinFunction(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output)
+{
+    const Lexeme& lexeme = lexemes[lexemeIndex];
+
+    const CallNode* call = context.m_SyntaxTree->FindCall(lexemeIndex);
+    const IntrinsicLowering* lowering = nullptr;
+
+    if (call != nullptr && call->m_NumberOfArguments <= MAXIMUM_NUMBER_OF_INTRINSIC_ARGUMENTS)
+    {
+        lowering = FindIntrinsicLowering(lexeme.m_Token, call->m_NumberOfArguments, context.m_Profile->m_Version);
     }
 
-    // Check for ~=, |=, &=, ^=
-    if (lexemeIndex < lexemes.size() - 1)
+    // Most builtin functions are only renamed, their arguments follow as is
+    if (lowering == nullptr)
     {
-        const Lexeme& nextLexeme = lexemes[lexemeIndex];
+        output.Append(" ", GetGlslSpelling(lexeme));
+        return;
+    }
 
-        if (nextLexeme.m_TokenClass == TokenClass_t::ASSIGNATION)
-        {
-            outputGlsl += " " + lexeme.m_Token + nextLexeme.m_Token + " ";
-            lexemeIndex += 1;
-            return;
-        }
+    // The others are rewritten around their arguments, i.e. mul(a, b) is (a * b). Each argument is converted once
+    // on its own, even when the GLSL form uses it more than once.
+    pmr::string arguments[MAXIMUM_NUMBER_OF_INTRINSIC_ARGUMENTS] = { pmr::string(context.m_MemoryResource), pmr::string(context.m_MemoryResource),
+                                                                     pmr::string(context.m_MemoryResource) };
+    string_view argumentViews[MAXIMUM_NUMBER_OF_INTRINSIC_ARGUMENTS];
+
+    for (size_t i = 0; i < call->m_NumberOfArguments; i++)
+    {
+        OutputWriter argumentOutput(arguments[i]);
+        InterpretExpression(lexemes, context, context.m_SyntaxTree->GetArgument(*call, i), argumentOutput);
+
+        // Arguments don't need the space the generator puts before most lexemes
+        argumentViews[i] = arguments[i];
+        argumentViews[i].remove_prefix(min(argumentViews[i].find_first_not_of(' '), argumentViews[i].size()));
+    }
+
+    output.Append(" ");
+    AppendIntrinsicLowering(*lowering, argumentViews, output);
+
+    lexemeIndex = call->m_ClosedParanthesis;
+}
+
+// Start of the conversion of the floats read from a register to the type of a member. The bits of integers and
+// booleans are stored as they are, which the vec4 sees as floats.
+void AppendRegisterConversionBegin(const UniformBlockMember& member, string_view glslType, OutputWriter& output)
+{
+    const char baseType = glslType[0];
+
+    if (baseType == 'i')
+    {
+        output.Append("(floatBitsToInt(");
+    }
+    else if (baseType == 'u')
+    {
+        output.Append("(floatBitsToUint(");
+    }
+    else if (baseType == 'b')
+    {
+        output.Append((member.m_Rows > 1) ? "notEqual(floatBitsToUint(" : "(floatBitsToUint(");
+    }
+    else
+    {
+        output.Append("(");
+    }
+}
+
+void AppendRegisterConversionEnd(const UniformBlockMember& member, string_view glslType, OutputWriter& output)
+{
+    const char baseType = glslType[0];
+
+    if (baseType == 'b' && member.m_Rows > 1)
+    {
+        output.Append("), uvec");
+        output.AppendInteger(member.m_Rows);
+        output.Append("(0u))");
+    }
+    else
+    {
+        output.Append((baseType == 'b') ? ") != 0u)" : ((baseType == 'i' || baseType == 'u') ? "))" : ")"));
     }
+}
+
+// The vec4 holding a register, i.e. Material_register0, or Material_register1[1] in a vec4 array
+void AppendRegister(string_view blockName, const UniformBlockEntry& entry, uint32_t registerIndex, OutputWriter& output)
+{
+    output.Append(blockName, "_register");
+    output.AppendInteger(entry.m_Register);
 
-    outputGlsl += " " + lexeme.m_Token;
+    if (entry.m_RegisterCount > 1)
+    {
+        output.Append("[");
+        output.AppendInteger(registerIndex - entry.m_Register);
+        output.Append("]");
+    }
 }
 
-void InterpretMulOperation(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl, size_t levelToStartAt, size_t levelToReach)
+// Reads a member from the vec4 holding its register, i.e. Material_register0.yz. A matrix is built from the
+// registers of its columns.
+void AppendRegisterRead(string_view blockName, const UniformBlockMember& member, const UniformBlockEntry& entry, string_view glslType, OutputWriter& output)
 {
-    // Start is the paranthesis
-    outputGlsl += "(";
+    const string_view components = string_view("xyzw").substr(member.m_Offset % REGISTER_SIZE / 4, member.m_Rows);
 
-    size_t idx = 0;
-    size_t level = levelToStartAt;
-    while (true)
+    if (member.m_Columns > 1)
     {
-        const Lexeme& nextLexeme = lexemes[lexemeIndex + 2 + idx];
-        if (nextLexeme.m_TokenClass == TokenClass_t::BUILTIN_FUNCTION)
+        output.Append(glslType, "(");
+
+        for (uint32_t column = 0; column < member.m_Columns; column++)
         {
-            if (nextLexeme.m_Token == "mul")
-            {
-                size_t tempIdx = lexemeIndex + 2 + idx;
-                string mulOutput = "";
+            output.Append((column > 0) ? ", " : "");
+            AppendRegister(blockName, entry, member.m_Offset / REGISTER_SIZE + column, output);
+            output.Append(".", components);
+        }
 
-                InterpretMulOperation(lexemes, tempIdx, mulOutput, level + 1, level + 1);
-                level += 1;
+        output.Append(")");
+        return;
+    }
 
-                outputGlsl += mulOutput;
+    AppendRegisterConversionBegin(member, glslType, output);
+    AppendRegister(blockName, entry, member.m_Offset / REGISTER_SIZE, output);
+    output.Append(".", components);
+    AppendRegisterConversionEnd(member, glslType, output);
+}
 
-                idx += (tempIdx - (lexemeIndex + 2 + idx)) + 1;
-            }
-            else
-            {
-                size_t index = 0;
-                size_t size = _countof(hlslBuiltinFunctionsToGlsl);
-                for (; index < size; index++)
-                {
-                    if (nextLexeme.m_Token == hlslBuiltinFunctionsToGlsl[index])
-                    {
-                        break;
-                    }
-                }
+// Reads an element of an array from the vec4 array holding its registers, one per element: the name and the opened
+// bracket of a[i] become Material_register1[, and the closed one ].x
+void AppendRegisterArrayReadBegin(string_view blockName, const UniformBlockMember& member, const UniformBlockEntry& entry, string_view glslType,
+                                  OutputWriter& output)
+{
+    AppendRegisterConversionBegin(member, glslType, output);
+    output.Append(blockName, "_register");
+    output.AppendInteger(entry.m_Register);
+    output.Append("[");
 
-                // There are a few special cases
-                //  1. mul in HLSL is simply the * operator in GLSL
-                //  2. saturate in HLSL is min(1.0, max(0.0, x)) where x is the value to saturate
-                if (nextLexeme.m_Token == "saturate")
-                {
-                    // TODO
-                    // For now we assume that the three next lexemes are a opened paranthesis, a variable name and a closed paranthesis
-                    outputGlsl += " " + hlslBuiltinFunctionsToGlsl[index + 1] + lexemes[lexemeIndex + 2 + idx + 2].m_Token + ")";
-                    idx += 3;
-                }
-                else
-                {
-                    outputGlsl += " " + hlslBuiltinFunctionsToGlsl[index + 1];
-                }
+    if (member.m_Offset / REGISTER_SIZE > entry.m_Register)
+    {
+        output.AppendInteger(member.m_Offset / REGISTER_SIZE - entry.m_Register);
+        output.Append(" + (");
+    }
+}
 
-                idx += 1;
-            }
+void AppendRegisterArrayReadEnd(const UniformBlockMember& member, uint32_t firstRegister, string_view glslType, OutputWriter& output)
+{
+    if (member.m_Offset / REGISTER_SIZE > firstRegister)
+    {
+        output.Append(")");
+    }
 
-            continue;
+    output.Append("].", string_view("xyzw").substr(0, member.m_Rows));
+    AppendRegisterConversionEnd(member, glslType, output);
+}
+
+// Declares the members of a cbuffer whose layout is known, with the padding and registers which give them their
+// HLSL offsets under std140. The uses of the members read from a register are replaced by the read.
+void DeclareUniformBlockMembers(const LexemeStream& lexemes, ConversionContext& context, string_view blockName, const UniformBlockLayout& layout,
+                                OutputWriter& output)
+{
+    output.Append("{");
+    output.NewLine();
+    output.Indent();
+
+    size_t paddingIndex = 0;
+    for (const UniformBlockEntry& entry : layout.m_Entries)
+    {
+        for (uint32_t i = 0; i < entry.m_Padding; i++, paddingIndex++)
+        {
+            output.Append("float ", blockName, "_padding");
+            output.AppendInteger(paddingIndex);
+            output.Append(";");
+            output.NewLine();
         }
-        else if (nextLexeme.m_TokenClass == TokenClass_t::TYPE)
+
+        if (entry.m_Register != INVALID_REGISTER)
         {
-            size_t index = 0;
-            size_t size = _countof(hlslTypesMappingToGlsl);
-            for (; index < size; index++)
+            output.Append("vec4 ", blockName, "_register");
+            output.AppendInteger(entry.m_Register);
+
+            if (entry.m_RegisterCount > 1)
             {
-                if (nextLexeme.m_Token == hlslTypesMappingToGlsl[index])
-                {
-                    break;
-                }
+                output.Append("[");
+                output.AppendInteger(entry.m_RegisterCount);
+                output.Append("]");
             }
 
-            outputGlsl += hlslTypesMappingToGlsl[index + 1] + " ";
-            idx += 1;
+            output.Append(";");
+            output.NewLine();
             continue;
         }
-        else if (nextLexeme.m_TokenClass == TokenClass_t::CLOSED_PARANTHESIS)
-        {
-            level -= 1;
-        }
-        else if (nextLexeme.m_TokenClass == TokenClass_t::OPENED_PARANTHESIS)
+
+        const UniformBlockMember& member = layout.m_Members[entry.m_Member];
+        const Keyword& type = GetKeyword(lexemes.GetKeywordId(member.m_Type));
+        if (context.m_PrecisionQualifiers && !type.m_Precision.empty())
         {
-            level += 1;
+            output.Append(type.m_Precision, " ");
         }
-        else if (nextLexeme.m_TokenClass == TokenClass_t::COMMA && level == levelToReach)
+
+        output.Append(type.m_Glsl, " ", lexemes.GetToken(member.m_Name));
+        if (member.m_ArraySize > 0)
         {
-            break;
+            output.Append("[");
+            output.AppendInteger(member.m_ArraySize);
+            output.Append("]");
         }
 
-        outputGlsl += nextLexeme.m_Token;
-
-        idx += 1;
+        output.Append(";");
+        output.NewLine();
     }
-        
-    outputGlsl += " * ";
-    lexemeIndex += 2 + idx;
+
+    output.Unindent();
+    output.Append("};");
+    output.NewLine();
 }
 
-void InterpretBuiltinFunction(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl)
+void InterpretCbuffer(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output)
 {
-    const Lexeme& lexeme = lexemes[lexemeIndex];
-
-    size_t index = 0;
-    size_t size = _countof(hlslBuiltinFunctionsToGlsl);
-    for (; index < size; index++)
+    // A cbuffer is a uniform block. We first have to get the index of the register to properly set the layout index
+    const DeclarationNode* declaration = context.m_SyntaxTree->FindDeclaration(lexemeIndex);
+    if (declaration == nullptr || declaration->m_Name == INVALID_LEXEME_INDEX || declaration->m_End == INVALID_LEXEME_INDEX)
     {
-        if (lexeme.m_Token == hlslBuiltinFunctionsToGlsl[index])
-        {
-            break;
-        }
+        output.Append(lexemes[lexemeIndex].m_Token, " ");
+        return;
     }
 
-    // There are a few special cases
-    //  1. mul in HLSL is simply the * operator in GLSL
-    //  2. saturate in HLSL is min(1.0, max(0.0, x)) where x is the value to saturate
-    if (lexeme.m_Token == "saturate")
+    // Only std140 has known offsets, the default layout lets the driver pick them.
+    // Vulkan needs a binding even without a register, uniform blocks are in the first set and samplers in the second
+    if (context.m_Profile->m_IsVulkan)
     {
-        // TODO
-        // For now we assume that the three next lexemes are a opened paranthesis, a variable name and a closed paranthesis
-        outputGlsl += " " + hlslBuiltinFunctionsToGlsl[index + 1] + lexemes[lexemeIndex + 2].m_Token + ")";
-        lexemeIndex += 3;
+        output.Append("layout(std140, set = 0, binding = ");
+        output.AppendInteger(GetRegisterSlot(lexemes, *declaration));
+        output.Append(") ");
     }
-    else if (lexeme.m_Token == "mul")
+    else if (context.m_Profile->m_HasBindings && declaration->m_Register != INVALID_LEXEME_INDEX)
     {
-        InterpretMulOperation(lexemes, lexemeIndex, outputGlsl, 1, 1);
+        output.Append("layout(std140, binding = ", lexemes.GetToken(declaration->m_Register).substr(1), ") ");
     }
     else
     {
-        outputGlsl += " " + hlslBuiltinFunctionsToGlsl[index + 1];
+        output.Append("layout(std140) ");
     }
-}
 
-void InterpretCbuffer(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl)
-{
-    // A cbuffer is a uniform block. We first have to get the index of the register to properly set the layout index
-    const Lexeme& lexeme = lexemes[lexemeIndex];
+    const string_view blockName = lexemes.GetToken(declaration->m_Name);
+    output.Append("uniform ", blockName, "\n");
+    lexemeIndex = declaration->m_End;
+
+    const size_t openedCurlyBracket = declaration->m_End + 1;
+    if (openedCurlyBracket >= lexemes.size() || lexemes.GetTokenClass(openedCurlyBracket) != TokenClass_t::OPENED_CURLY_BRACKET)
+    {
+        return;
+    }
+
+    // Members whose layout isn't known are emitted as they are, by the lexemes which follow
+    auto uniformBlock = lower_bound(context.m_UniformBlocks.begin(), context.m_UniformBlocks.end(), openedCurlyBracket,
+                                    [](const UniformBlock& block, size_t lexemeIndex) { return block.m_OpenedCurlyBracket < lexemeIndex; });
+
+    if (uniformBlock == context.m_UniformBlocks.end() || uniformBlock->m_OpenedCurlyBracket != openedCurlyBracket)
+    {
+        return;
+    }
+
+    const UniformBlockLayout& layout = uniformBlock->m_Layout;
+    const bool isAnalyzed = uniformBlock->m_IsAnalyzed;
+
+    if (context.m_UniformBlockStatistics != nullptr)
+    {
+        UniformBlockStatistics statistics;
+        statistics.m_Name = blockName;
+        statistics.m_IsAnalyzed = isAnalyzed;
+        statistics.m_MatchesHlsl = isAnalyzed && layout.m_MatchesStd140;
+        statistics.m_Size = layout.m_Size;
+        statistics.m_WastedBytes = layout.m_Size - layout.m_UsedSize;
+        statistics.m_PackedSize = layout.m_PackedSize;
+
+        for (const UniformBlockEntry& entry : layout.m_Entries)
+        {
+            statistics.m_PaddingMembers += entry.m_Padding;
+        }
+
+        statistics.m_RegisterMembers = layout.m_Members.size() - count(layout.m_MemberRegisters.begin(), layout.m_MemberRegisters.end(), INVALID_REGISTER);
+        context.m_UniformBlockStatistics->push_back(statistics);
+    }
+
+    if (!isAnalyzed)
+    {
+        return;
+    }
 
-    string registerSlot = lexemes[lexemeIndex + 5].m_Token.substr(1, string::npos);
+    DeclareUniformBlockMembers(lexemes, context, blockName, layout, output);
 
-    outputGlsl += "layout(binding = " + registerSlot + ") uniform " + lexemes[lexemeIndex + 1].m_Token  + "\n";
-    lexemeIndex += 6;
+    lexemeIndex = context.m_SyntaxTree->GetMatchingBracket(openedCurlyBracket);
+    if (lexemeIndex + 1 < lexemes.size() && lexemes.GetTokenClass(lexemeIndex + 1) == TokenClass_t::SEMICOLUMN)
+    {
+        lexemeIndex += 1;
+    }
 }
 
-void IntrepretClosedAngleBracket(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl)
+void IntrepretClosedAngleBracket(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output)
 {
-    outputGlsl += lexemes[lexemeIndex].m_Token;
+    output.Append(lexemes[lexemeIndex].m_Token);
 }
 
-void InterpretClosedCurlyBracket(const vector<Lexeme>& lexemes, size_t& lexemeIndex, bool isVertexShader, string& outputGlsl)
+void InterpretClosedCurlyBracket(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, bool isVertexShader, OutputWriter& output)
 {
-    if (isInEntryFunction)
+    if (context.m_IsInEntryFunction)
     {
-        entryFunctionLevel -= 1;
+        context.m_EntryFunctionLevel -= 1;
 
-        if (entryFunctionLevel == 0)
+        if (context.m_EntryFunctionLevel == 0)
         {
-            isInEntryFunction = false;
+            context.m_IsInEntryFunction = false;
         }
     }
 
     // Check if we have to output the struct
-    if (insideOfStruct)
+    if (context.m_InsideOfStruct)
     {
-        if (hadAnySemanticsInStruct)
+        if (context.m_HadAnySemanticsInStruct)
         {
-            for (size_t i = 0; i < semantics.size(); i++)
+            for (size_t i = 0; i < context.m_Semantics.size(); i++)
             {
-                if (isVertexShader && !isOutputSemanticStruct)
+                // Vulkan matches the outputs of a stage with the inputs of the next one by location only
+                if ((isVertexShader && !context.m_IsOutputSemanticStruct) || context.m_Profile->m_IsVulkan)
                 {
-                    outputGlsl += "layout (location=" + to_string(i) + ") ";
+                    output.Append("layout (location=");
+                    output.AppendInteger(i);
+                    output.Append(") ");
                 }
                 
-                if (isOutputSemanticStruct)
+                if (context.m_IsOutputSemanticStruct)
                 {
-                    outputGlsl += "out ";
+                    output.Append("out ");
                 }
                 else
                 {
-                    outputGlsl += "in ";
+                    output.Append("in ");
                 }
 
-                outputGlsl += semantics[i];
+                output.Append(context.m_Semantics[i]);
             }
 
-            for (const string& val : semantics)
+            for (const pmr::string& val : context.m_Semantics)
             {
-                semanticsForUvNames.push_back(val);
+                context.m_SemanticsForUvNames.push_back(val);
             }
             
-            semantics.clear();
+            context.m_Semantics.clear();
 
-            hadAnySemanticsInStruct = false;
-            isOutputSemanticStruct = false;
+            context.m_HadAnySemanticsInStruct = false;
+            context.m_IsOutputSemanticStruct = false;
 
             lexemeIndex += 1;
-            outputGlsl += "\n";
+            output.Append("\n");
         }
         else
         {
-            outputGlsl += structBufferIfNoSemanticsInStruct;
-            currentIndentationLevel -= 1;
+            output.Append(context.m_StructBufferIfNoSemanticsInStruct);
+            output.Unindent();
         }
 
-        structBufferIfNoSemanticsInStruct = "";
+        context.m_StructBufferIfNoSemanticsInStruct = "";
     }
     else
     {
-        outputGlsl += lexemes[lexemeIndex].m_Token;
-        currentIndentationLevel -= 1;
+        output.Append(lexemes[lexemeIndex].m_Token);
+        output.Unindent();
     }
 
-    insideOfStruct = false;
-    mightAddSemanticStructNameToIgnore = false;
+    context.m_InsideOfStruct = false;
+    context.m_MightAddSemanticStructNameToIgnore = false;
 }
 
-void IntrepretClosedParanthesis(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl)
+void IntrepretClosedParanthesis(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output)
 {
-    outputGlsl += lexemes[lexemeIndex].m_Token;
+    output.Append(lexemes[lexemeIndex].m_Token);
 }
 
-void InterpretColon(const vector<Lexeme>& lexemes, size_t& lexemeIndex, bool isVertexShader, string& outputGlsl)
+void InterpretColon(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, bool isVertexShader, OutputWriter& output)
 {
-    if (insideOfStruct)
+    if (context.m_InsideOfStruct)
     {
-        hadAnySemanticsInStruct = true;
+        context.m_HadAnySemanticsInStruct = true;
 
         size_t index = lexemeIndex - 2;
-        string semanticType;
-        string semanticName;
+        pmr::string semantic(context.m_MemoryResource);
+        OutputWriter semanticOutput(semantic);
 
-        insideOfStruct = false;
+        context.m_InsideOfStruct = false;
 
-        InterpretType(lexemes, index, semanticType);
+        InterpretType(lexemes, context, index, semanticOutput);
         index += 1;
 
-        InterpretVariableName(lexemes, "", isVertexShader, vector<string>(), index, semanticName);
+        InterpretVariableName(lexemes, context, "", isVertexShader, index, semanticOutput);
 
-        insideOfStruct = true;
+        context.m_InsideOfStruct = true;
 
         bool ignoreFollowingSemantic = false;
 
@@ -804,8 +1177,8 @@ void InterpretColon(const vector<Lexeme>& lexemes, size_t& lexemeIndex, bool isV
         {
             if (lexemes[lexemeIndex + 1].m_Token == "SV_POSITION")
             {
-                glPositionName = lexemes[lexemeIndex - 1].m_Token;
-                isOutputSemanticStruct = true;
+                context.m_GlPositionSymbol = lexemes[lexemeIndex - 1].m_SymbolId;
+                context.m_IsOutputSemanticStruct = true;
 
                 ignoreFollowingSemantic = true;
             }
@@ -814,7 +1187,7 @@ void InterpretColon(const vector<Lexeme>& lexemes, size_t& lexemeIndex, bool isV
         {
             if (lexemes[lexemeIndex + 1].m_Token.find("SV_TARGET") != string::npos)
             {
-                isOutputSemanticStruct = true;
+                context.m_IsOutputSemanticStruct = true;
             }
             else if (lexemes[lexemeIndex + 1].m_Token.find("SV_POSITION") != string::npos)
             {
@@ -824,72 +1197,79 @@ void InterpretColon(const vector<Lexeme>& lexemes, size_t& lexemeIndex, bool isV
 
         if (!ignoreFollowingSemantic)
         {
-            semantics.push_back(semanticType + semanticName + ";\n");
+            semanticOutput.Append(";\n");
+            context.m_Semantics.push_back(move(semantic));
         }
 
         lexemeIndex += 2;
 
-        if (mightAddSemanticStructNameToIgnore)
+        if (context.m_MightAddSemanticStructNameToIgnore)
         {
-            semanticStructNameToIgnore.push_back(structNames.back());
-            mightAddSemanticStructNameToIgnore = false;
+            AddSymbolFlag(context, context.m_CurrentStructSymbol, SYMBOL_SEMANTIC_STRUCT_NAME);
+            context.m_MightAddSemanticStructNameToIgnore = false;
         }
     }
     else
     {
-        outputGlsl += lexemes[lexemeIndex].m_Token + " ";
+        output.Append(lexemes[lexemeIndex].m_Token, " ");
     }
 }
 
-void InterpretComma(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl)
+void InterpretComma(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output)
 {
-    outputGlsl += lexemes[lexemeIndex].m_Token + " ";
+    output.Append(lexemes[lexemeIndex].m_Token, " ");
 }
 
-void InterpretComment(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl)
+void InterpretComment(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output)
 {
-    outputGlsl += lexemes[lexemeIndex].m_Token + "\n";
+    output.Append(lexemes[lexemeIndex].m_Token, "\n");
 }
 
-void InterpretFlowControl(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl)
+void InterpretFlowControl(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output)
 {
-    if (isInEntryFunction)
+    if (context.m_IsInEntryFunction)
     {
+        // The outputs are written as they are assigned, so the return statement goes away
         if (lexemes[lexemeIndex].m_Token == "return")
         {
-            lexemeIndex += 2;
+            while (lexemeIndex + 1 < lexemes.size() && lexemes.GetTokenClass(lexemeIndex) != TokenClass_t::SEMICOLUMN)
+            {
+                lexemeIndex += 1;
+            }
+
             return;
         }
     }
 
-    outputGlsl += lexemes[lexemeIndex].m_Token + " ";
+    output.Append(lexemes[lexemeIndex].m_Token, " ");
 }
 
-void InterpretOpenedAngleBracket(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl)
+void InterpretOpenedAngleBracket(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output)
 {
-    outputGlsl += lexemes[lexemeIndex].m_Token + " ";
+    output.Append(lexemes[lexemeIndex].m_Token, " ");
 }
 
-void InterpretOpenedCurlyBracket(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl)
+void InterpretOpenedCurlyBracket(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output)
 {
-    if (isInEntryFunction)
+    if (context.m_IsInEntryFunction)
     {
-        entryFunctionLevel += 1;
+        context.m_EntryFunctionLevel += 1;
     }
 
-    if (!insideOfStruct)
+    if (!context.m_InsideOfStruct)
     {
-        outputGlsl += lexemes[lexemeIndex].m_Token + "\n";
-        currentIndentationLevel += 1;
-        startOfLine = true;
+        output.Append(lexemes[lexemeIndex].m_Token);
+        output.NewLine();
+        output.Indent();
     }
     else
     {
-        structBufferIfNoSemanticsInStruct += lexemes[lexemeIndex].m_Token + "\n";
+        context.m_StructBufferIfNoSemanticsInStruct += lexemes[lexemeIndex].m_Token;
+        context.m_StructBufferIfNoSemanticsInStruct += "\n";
     }
 }
 
-void InterpretOpenedParanthesis(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl)
+void InterpretOpenedParanthesis(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output)
 {
     // Special case: casting. Casting can be in two forms:
     //  1. (float3)val;                     -> Simple cast of a single variable
@@ -900,192 +1280,175 @@ void InterpretOpenedParanthesis(const vector<Lexeme>& lexemes, size_t& lexemeInd
     const Lexeme& semiColonLexeme = lexemes[lexemeIndex + 4];
     if (nextLexeme.m_TokenClass == TokenClass_t::TYPE && thirdLexeme.m_TokenClass == TokenClass_t::CLOSED_PARANTHESIS)
     {
-        size_t index = 0;
-        size_t size = _countof(hlslTypesMappingToGlsl);
-        for (; index < size; index++)
-        {
-            if (nextLexeme.m_Token == hlslTypesMappingToGlsl[index])
-            {
-                break;
-            }
-        }
+        const string_view glslSpelling = GetGlslSpelling(nextLexeme);
 
         if (variableLexeme.m_TokenClass == TokenClass_t::VARIABLE_NAME)
         {
-            outputGlsl += hlslTypesMappingToGlsl[index + 1] + "(" + variableLexeme.m_Token + ")";
+            output.Append(glslSpelling, "(", variableLexeme.m_Token, ")");
             lexemeIndex += 3;
         }
         else
         {
-            outputGlsl += hlslTypesMappingToGlsl[index + 1];
+            output.Append(glslSpelling);
             lexemeIndex += 2;
         }
     }
     else
     {
-        outputGlsl += lexemes[lexemeIndex].m_Token + " ";
+        output.Append(lexemes[lexemeIndex].m_Token, " ");
     }
 }
 
-void InterpretRegister(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl)
+void InterpretRegister(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output)
 {
 }
 
-void InterpretRelationalOperator(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl)
+void InterpretRelationalOperator(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output)
 {
-    // >, <, !
+    // >, <, !, as well as >=, <=, !=, ==, >>, <<, >>=, <<= which the tokenizer gives us as a single lexeme
     const Lexeme& lexeme = lexemes[lexemeIndex];
 
-    // Check for >=, <=, !=, or >>, <<, >>=, <<=
-    if (lexemeIndex < lexemes.size() - 1)
-    {
-        const Lexeme& nextLexeme = lexemes[lexemeIndex + 1];
-
-        if (nextLexeme.m_TokenClass == TokenClass_t::ASSIGNATION)
-        {
-            outputGlsl += " " + lexeme.m_Token + nextLexeme.m_Token + " ";
-            lexemeIndex += 1;
-            return;
-        }
-        else if (nextLexeme.m_TokenClass == TokenClass_t::RELATIONAL_OPERATOR)
-        {
-            if (nextLexeme.m_TokenClass == lexeme.m_TokenClass)
-            {
-                const Lexeme& thirdLexeme = lexemes[lexemeIndex + 2];
-
-                if (thirdLexeme.m_TokenClass == TokenClass_t::ASSIGNATION)
-                {
-                    outputGlsl += " " + lexeme.m_Token + nextLexeme.m_Token + thirdLexeme.m_Token + " ";
-                    lexemeIndex += 2;
-                }
-                else
-                {
-                    outputGlsl += " " + lexeme.m_Token + nextLexeme.m_Token + " " ;
-                    lexemeIndex += 1;
-                }
+    output.Append(" ", lexeme.m_Token, " ");
+}
 
-                return;
-            }
-        }
+// Skips a texture or sampler state declaration. PreprocessTextures declares the combined samplers instead.
+void SkipDeclaration(const ConversionContext& context, size_t& lexemeIndex)
+{
+    const DeclarationNode* declaration = context.m_SyntaxTree->FindDeclaration(lexemeIndex);
+    if (declaration != nullptr && declaration->m_End != INVALID_LEXEME_INDEX)
+    {
+        lexemeIndex = declaration->m_End;
     }
-
-    // Simple relational operator
-    outputGlsl += " " + lexeme.m_Token + " ";
 }
 
-void InterpretSamplerState(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl)
+void InterpretSamplerState(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output)
 {
-    lexemeIndex += 7;
+    SkipDeclaration(context, lexemeIndex);
 }
 
-void InterpretSemiColumn(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl)
+void InterpretSemiColumn(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output)
 {
-    if (insideOfStruct)
+    if (context.m_InsideOfStruct)
     {
-        structBufferIfNoSemanticsInStruct += lexemes[lexemeIndex].m_Token + "\n";
+        context.m_StructBufferIfNoSemanticsInStruct += lexemes[lexemeIndex].m_Token;
+        context.m_StructBufferIfNoSemanticsInStruct += "\n";
     }
     else
     {
-        outputGlsl += lexemes[lexemeIndex].m_Token + "\n";
-        startOfLine = true;
+        output.Append(lexemes[lexemeIndex].m_Token);
+        output.NewLine();
     }
 }
 
-void InterpretStruct(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl)
+void InterpretStruct(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output)
 {
     // Assume that the next lexemes is the struct name
     const Lexeme& lexeme = lexemes[lexemeIndex];
 
-    string structName = lexemes[lexemeIndex + 1].m_Token;
-    structNames.push_back(structName);
+    string_view structName = lexemes[lexemeIndex + 1].m_Token;
+    AddSymbolFlag(context, lexemes[lexemeIndex + 1].m_SymbolId, SYMBOL_STRUCT_NAME);
+    context.m_CurrentStructSymbol = lexemes[lexemeIndex + 1].m_SymbolId;
 
-    insideOfStruct = true;
-    mightAddSemanticStructNameToIgnore = true;
+    context.m_InsideOfStruct = true;
+    context.m_MightAddSemanticStructNameToIgnore = true;
 
-    structBufferIfNoSemanticsInStruct += lexeme.m_Token + " " + structName + "\n";
+    context.m_StructBufferIfNoSemanticsInStruct.append(lexeme.m_Token).append(" ").append(structName).append("\n");
     lexemeIndex += 1;
 }
 
-void InterpretStructureOperator(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl)
+void InterpretStructureOperator(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output)
 {
-    outputGlsl += lexemes[lexemeIndex].m_Token;
+    output.Append(lexemes[lexemeIndex].m_Token);
 }
 
-void InterpretTexture(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl)
+void InterpretTexture(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output)
 {
-    lexemeIndex += 7;
+    SkipDeclaration(context, lexemeIndex);
 }
 
-void InterpretTernaryOperator(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl)
+void InterpretTernaryOperator(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output)
 {
-    outputGlsl += " " + lexemes[lexemeIndex].m_Token;
+    output.Append(" ", lexemes[lexemeIndex].m_Token);
 }
 
-void InterpretType(const vector<Lexeme>& lexemes, size_t& lexemeIndex, string& outputGlsl)
+void InterpretType(const LexemeStream& lexemes, ConversionContext& context, size_t& lexemeIndex, OutputWriter& output)
 {
     const Lexeme& lexeme = lexemes[lexemeIndex];
 
-    size_t index = 0;
-    size_t size = _countof(hlslTypesMappingToGlsl);
-    for (; index < size; index++)
+    const string_view glslSpelling = GetGlslSpelling(lexeme);
+
+    // Reduced precision types keep their precision as a qualifier, except in constructors which can't have one
+    string_view precision;
+    if (context.m_PrecisionQualifiers && lexeme.m_KeywordId != INVALID_KEYWORD_ID &&
+        (lexemeIndex + 1 >= lexemes.size() || lexemes.GetTokenClass(lexemeIndex + 1) != TokenClass_t::OPENED_PARANTHESIS))
+    {
+        precision = GetKeyword(lexeme.m_KeywordId).m_Precision;
+    }
+
+    if (context.m_InsideOfStruct)
     {
-        if (lexeme.m_Token == hlslTypesMappingToGlsl[index])
+        context.m_StructBufferIfNoSemanticsInStruct.append("    ");
+        if (!precision.empty())
         {
-            break;
+            context.m_StructBufferIfNoSemanticsInStruct.append(precision).append(" ");
         }
-    }
 
-    if (insideOfStruct)
+        context.m_StructBufferIfNoSemanticsInStruct.append(glslSpelling).append(" ");
+    }
+    else if (!precision.empty())
     {
-        structBufferIfNoSemanticsInStruct += "    " + hlslTypesMappingToGlsl[index + 1] + " ";
+        output.Append(precision, " ", glslSpelling, " ");
     }
     else
     {
-        outputGlsl += hlslTypesMappingToGlsl[index + 1] + " ";
+        output.Append(glslSpelling, " ");
     }
 }
 
-void InterpretVariableName(const vector<Lexeme>& lexemes, const string& entryFunctionName, bool isVertexShader, const vector<string>& originalTextureNames, size_t& lexemeIndex, string& outputGlsl)
+void InterpretVariableName(const LexemeStream& lexemes, ConversionContext& context, const string& entryFunctionName, bool isVertexShader, size_t& lexemeIndex, OutputWriter& output)
 {
     const Lexeme& lexeme = lexemes[lexemeIndex];
 
-    // Special case for the SV_POSITION semantic
-    if (isInEntryFunction && glPositionName != "")
+    // Special case for the SV_POSITION semantic, unless it is a member of the input of the entry function with the same name
+    if (context.m_IsInEntryFunction)
     {
-        if (lexeme.m_Token == glPositionName)
+        const bool isMemberOfEntryFunctionParameter = lexemeIndex >= 2 && lexemes.GetTokenClass(lexemeIndex - 1) == TokenClass_t::STRUCTURE_OPERATOR &&
+                                                      IsSymbol(lexemes[lexemeIndex - 2], context.m_EntryFunctionParameterSymbol);
+
+        if (IsSymbol(lexeme, context.m_GlPositionSymbol) && !isMemberOfEntryFunctionParameter)
         {
-            outputGlsl += "gl_Position";
+            output.Append("gl_Position");
             return;
         }
     }
 
     // Special case for texture names : if we find one of the original texture names, check if there is a dot, then the Sample keyword followed by a (
-    if (find(originalTextureNames.begin(), originalTextureNames.end(), lexeme.m_Token) != originalTextureNames.end())
+    if (HasSymbolFlag(context, lexeme.m_SymbolId, SYMBOL_TEXTURE_NAME))
     {
-        if (lexemes[lexemeIndex + 1].m_TokenClass == TokenClass_t::STRUCTURE_OPERATOR &&
-            lexemes[lexemeIndex + 2].m_Token == "Sample" && lexemes[lexemeIndex + 3].m_TokenClass == TokenClass_t::OPENED_PARANTHESIS)
+        const CallNode* sampleCall = FindSampleCall(lexemes, context, lexemeIndex);
+        if (sampleCall != nullptr)
         {
-            string samplerStateTextureName = GetSamplerStateTextureName(lexemes[lexemeIndex + 4].m_Token, lexeme.m_Token);
-            if (samplerStateTextureName != "")
+            LexemeRange samplerState = context.m_SyntaxTree->GetArgument(*sampleCall, 0);
+
+            string_view samplerStateTextureName = GetSamplerStateTextureName(context, lexemes.GetSymbolId(samplerState.m_Begin), lexeme.m_SymbolId);
+            if (!samplerStateTextureName.empty())
             {
-                outputGlsl += "texture(" + samplerStateTextureName;
-                lexemeIndex += 4;
+                output.Append("texture(", samplerStateTextureName);
+                lexemeIndex = samplerState.m_End - 1;
 
                 if (!isVertexShader)
                 {
                     // We also want to use the inverted uv 
-                    string uvName = lexemes[lexemeIndex + 2].m_Token + lexemes[lexemeIndex + 3].m_Token + lexemes[lexemeIndex + 4].m_Token;
+                    LexemeRange uvNameRange = GetUvNameRange(lexemes, context, *sampleCall);
+
+                    pmr::string uvName(context.m_MemoryResource);
+                    AppendTokens(lexemes, uvNameRange, uvName);
 
-                    for (size_t i = 0; i < uvNames.size(); i++)
+                    if (!uvNameRange.empty() && HasSymbolFlag(context, lexemes.GetSymbolTable().Find(uvName), SYMBOL_UV_NAME))
                     {
-                        if (uvNames[i] == uvName)
-                        {
-                            string newUvName = "inv_" + uvNames[i].substr(uvNames[i].find('.') + 1);
-                            outputGlsl += ", " + newUvName;
+                        output.Append(", inv_", string_view(uvName).substr(uvName.find('.') + 1));
 
-                            lexemeIndex += 4;
-                            break;
-                        }
+                        lexemeIndex = uvNameRange.m_End - 1;
                     }
                 }
 
@@ -1094,40 +1457,52 @@ void InterpretVariableName(const vector<Lexeme>& lexemes, const string& entryFun
         }
     }
 
-    if (insideOfStruct)
+    if (context.m_InsideOfStruct)
     {
-        structBufferIfNoSemanticsInStruct += lexeme.m_Token + (IsStructName(lexeme.m_Token) ? " " : "");
+        context.m_StructBufferIfNoSemanticsInStruct += lexeme.m_Token;
+        context.m_StructBufferIfNoSemanticsInStruct += (IsStructName(context, lexeme.m_SymbolId) ? " " : "");
     }
     else
     {
         // Special case for semantic variable names to ignore. We want to remove the name and the dot after it
-        if (IsSemanticStructVariable(lexeme.m_Token))
+        if (IsSemanticStructVariable(context, lexeme.m_SymbolId))
         {
             lexemeIndex += 1;
             return;
         }
 
         // Special case for entry function. If this variable name is a struct name, check if the next lexeme is the entry function.
-        if (IsSemanticStructName(lexeme.m_Token))
+        if (IsSemanticStructName(context, lexeme.m_SymbolId))
         {
             const Lexeme& nextLexeme = lexemes[lexemeIndex + 1];
-            if (nextLexeme.m_Token == entryFunctionName)
+            const CallNode* signature = context.m_SyntaxTree->FindCall(lexemeIndex + 1);
+
+            if (IsSymbol(nextLexeme, context.m_EntryFunctionSymbol) && signature != nullptr && signature->m_FunctionDefinition != INVALID_NODE_INDEX)
             {
-                // Don't forget to get the semantic variable declaration inside of the entry function
-                semanticStructVariableToIgnore.push_back(lexemes[lexemeIndex + 4].m_Token);
+                // Don't forget to get the semantic variable declaration inside of the entry function, the name of its first parameter
+                if (signature->m_NumberOfArguments > 0)
+                {
+                    LexemeRange parameter = context.m_SyntaxTree->GetArgument(*signature, 0);
+                    if (!parameter.empty())
+                    {
+                        context.m_EntryFunctionParameterSymbol = lexemes.GetSymbolId(parameter.m_End - 1);
+                        AddSymbolFlag(context, context.m_EntryFunctionParameterSymbol, SYMBOL_SEMANTIC_STRUCT_VARIABLE);
+                    }
+                }
 
-                outputGlsl += "void " + entryFunctionName + "() { \n";
-                lexemeIndex += 6;
+                output.Append("void ", entryFunctionName, "() { \n");
+                lexemeIndex = context.m_SyntaxTree->m_Functions[signature->m_FunctionDefinition].m_OpenedCurlyBracket;
 
                 if (!isVertexShader)
                 {
                     // Invert the y coordinates of the uv variables
-                    for (size_t i = 0; i < uvNames.size(); i++)
+                    for (SymbolId_t uvSymbolId : context.m_UvNames)
                     {
-                        string uvName = uvNames[i].substr(uvNames[i].find('.') + 1);
+                        string_view uvName = lexemes.GetSymbolTable().GetName(uvSymbolId);
+                        uvName = uvName.substr(uvName.find('.') + 1);
 
                         bool uvNameOk = false;
-                        for (const string& val : semanticsForUvNames)
+                        for (const pmr::string& val : context.m_SemanticsForUvNames)
                         {
                             if (val.find(uvName) != string::npos)
                             {
@@ -1135,31 +1510,32 @@ void InterpretVariableName(const vector<Lexeme>& lexemes, const string& entryFun
                             }
                         }
 
+                        // Without a copy, its uses keep the name
                         if (!uvNameOk)
                         {
+                            context.m_SymbolFlags[uvSymbolId] &= ~SYMBOL_UV_NAME;
                             continue;
                         }
 
-                        string newUvName = "inv_" + uvName;
-                        outputGlsl += "vec2 " + newUvName + " = " + uvName + ";\n";
-                        outputGlsl += newUvName + ".y = 1.0 - " + uvName + ".y;\n\n";
+                        output.Append("vec2 inv_", uvName, " = ", uvName, ";\n");
+                        output.Append("inv_", uvName, ".y = 1.0 - ", uvName, ".y;\n\n");
 
-                        entryFunctionLevel += 1;
+                        context.m_EntryFunctionLevel += 1;
                     }
                 }
 
-                isInEntryFunction = true;
+                context.m_IsInEntryFunction = true;
             }
             else if (nextLexeme.m_TokenClass == TokenClass_t::VARIABLE_NAME)
             {
                 // This means that it is a semantic variable declaration. Add it to the ignore list
-                semanticStructVariableToIgnore.push_back(nextLexeme.m_Token);
+                AddSymbolFlag(context, nextLexeme.m_SymbolId, SYMBOL_SEMANTIC_STRUCT_VARIABLE);
                 lexemeIndex += 2;
             }
         }
         else
         {
-            outputGlsl += lexeme.m_Token + (IsStructName(lexeme.m_Token) ? " " : "");
+            output.Append(lexeme.m_Token, IsStructName(context, lexeme.m_SymbolId) ? " " : "");
         }
     }
 }
@@ -0,0 +1,668 @@
+#include "ConstantFolding.h"
+
+#include "DeadCodeElimination.h"
+#include "Keywords.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+using namespace std;
+
+namespace HlslToGlsl
+{
+
+// A known value. Integers are kept exactly, floats are rounded to 32 bits after every operation.
+struct Constant
+{
+    double m_Value;
+    bool m_IsInteger;
+};
+
+// Known values of the static const globals, by symbol
+typedef pmr::vector<pair<bool, Constant>> ConstantSymbols;
+
+bool IsOperator(const LexemeStream& lexemes, size_t lexemeIndex, string_view token)
+{
+    return lexemes.GetTokenClass(lexemeIndex) == TokenClass_t::ARITHMETIC_OPERATOR && lexemes.GetToken(lexemeIndex) == token;
+}
+
+// The GLSL scalar type float or int of a type lexeme, nullptr for anything else
+const char* GetScalarType(const LexemeStream& lexemes, size_t lexemeIndex)
+{
+    const KeywordId_t keywordId = lexemes.GetKeywordId(lexemeIndex);
+    if (lexemes.GetTokenClass(lexemeIndex) != TokenClass_t::TYPE || keywordId == INVALID_KEYWORD_ID)
+    {
+        return nullptr;
+    }
+
+    const string_view glsl = GetKeyword(keywordId).m_Glsl;
+    return (glsl == "float") ? "float" : (glsl == "int") ? "int" : nullptr;
+}
+
+bool IsCast(const LexemeStream& lexemes, const SyntaxTree& syntaxTree, size_t openedParanthesis)
+{
+    return openedParanthesis + 2 < lexemes.size() && lexemes.GetTokenClass(openedParanthesis + 1) == TokenClass_t::TYPE &&
+           syntaxTree.GetMatchingBracket(openedParanthesis) == openedParanthesis + 2;
+}
+
+bool IsOperation(const LexemeStream& lexemes, const SyntaxTree& syntaxTree, size_t lexemeIndex)
+{
+    switch (lexemes.GetTokenClass(lexemeIndex))
+    {
+    case TokenClass_t::ARITHMETIC_OPERATOR:
+    case TokenClass_t::BUILTIN_FUNCTION:
+        return true;
+    case TokenClass_t::TYPE:
+        return syntaxTree.FindCall(lexemeIndex) != nullptr;
+    case TokenClass_t::OPENED_PARANTHESIS:
+        return IsCast(lexemes, syntaxTree, lexemeIndex);
+    default:
+        return false;
+    }
+}
+
+size_t CountOperations(const LexemeStream& lexemes, const SyntaxTree& syntaxTree, LexemeRange range)
+{
+    size_t numberOfOperations = 0;
+    for (LexemeIndex_t i = range.m_Begin; i < range.m_End; i++)
+    {
+        numberOfOperations += IsOperation(lexemes, syntaxTree, i) ? 1 : 0;
+    }
+
+    return numberOfOperations;
+}
+
+bool ParseLiteral(string_view token, Constant& constant)
+{
+    if (token.empty() || !(isdigit((unsigned char) token[0]) || (token[0] == '.' && token.size() > 1 && isdigit((unsigned char) token[1]))))
+    {
+        return false;
+    }
+
+    // 1.0f and 1.0h are floats, other suffixes and hexadecimal literals aren't folded
+    const bool hasFloatSuffix = (token.back() == 'f' || token.back() == 'F' || token.back() == 'h' || token.back() == 'H');
+    if (hasFloatSuffix)
+    {
+        token.remove_suffix(1);
+    }
+
+    if (token.find_first_not_of("0123456789.eE+-") != string_view::npos)
+    {
+        return false;
+    }
+
+    constant.m_IsInteger = !hasFloatSuffix && token.find_first_of(".eE") == string_view::npos;
+
+    auto result = from_chars(token.data(), token.data() + token.size(), constant.m_Value);
+    return result.ec == errc() && result.ptr == token.data() + token.size();
+}
+
+bool MakeFloat(double value, Constant& constant)
+{
+    const float roundedValue = (float) value;
+    if (!isfinite(roundedValue))
+    {
+        return false;
+    }
+
+    constant = Constant{ roundedValue, false };
+    return true;
+}
+
+bool ApplyOperator(char operation, const Constant& left, const Constant& right, Constant& result)
+{
+    if (left.m_IsInteger && right.m_IsInteger)
+    {
+        const int64_t a = (int64_t) left.m_Value;
+        const int64_t b = (int64_t) right.m_Value;
+
+        if (operation == '/' && b == 0)
+        {
+            return false;
+        }
+
+        const int64_t value = (operation == '+') ? a + b : (operation == '-') ? a - b : (operation == '*') ? a * b : a / b;
+        result = Constant{ (double) value, true };
+        return true;
+    }
+
+    const float a = (float) left.m_Value;
+    const float b = (float) right.m_Value;
+    const float value = (operation == '+') ? a + b : (operation == '-') ? a - b : (operation == '*') ? a * b : a / b;
+
+    return MakeFloat(value, result);
+}
+
+bool ApplyBuiltinFunction(string_view name, const Constant* arguments, size_t numberOfArguments, Constant& result)
+{
+    const float x = (float) arguments[0].m_Value;
+
+    if (numberOfArguments == 2 && (name == "min" || name == "max"))
+    {
+        const bool isMin = (name == "min");
+        if (arguments[0].m_IsInteger && arguments[1].m_IsInteger)
+        {
+            result = isMin ? (arguments[0].m_Value < arguments[1].m_Value ? arguments[0] : arguments[1])
+                           : (arguments[0].m_Value > arguments[1].m_Value ? arguments[0] : arguments[1]);
+            return true;
+        }
+
+        const float y = (float) arguments[1].m_Value;
+        return MakeFloat(isMin ? min(x, y) : max(x, y), result);
+    }
+
+    if (numberOfArguments != 1)
+    {
+        return false;
+    }
+
+    if (name == "abs")
+    {
+        result = Constant{ fabs(arguments[0].m_Value), arguments[0].m_IsInteger };
+        return arguments[0].m_IsInteger || MakeFloat(fabs(x), result);
+    }
+    else if (name == "saturate")
+    {
+        return MakeFloat(min(1.0f, max(0.0f, x)), result);
+    }
+    else if (name == "floor")
+    {
+        return MakeFloat(floor(x), result);
+    }
+    else if (name == "ceil")
+    {
+        return MakeFloat(ceil(x), result);
+    }
+    else if (name == "sqrt")
+    {
+        return x >= 0.0f && MakeFloat(sqrt(x), result);
+    }
+    else if (name == "rsqrt")
+    {
+        return x > 0.0f && MakeFloat(1.0f / sqrt(x), result);
+    }
+
+    return false;
+}
+
+// Recursive descent evaluation of the constant expression in a range of lexemes. Fails on anything unknown.
+class ConstantEvaluator
+{
+public:
+    ConstantEvaluator(const LexemeStream& lexemes, const SyntaxTree& syntaxTree, const ConstantSymbols& constantSymbols)
+        : m_Lexemes(lexemes)
+        , m_SyntaxTree(syntaxTree)
+        , m_ConstantSymbols(constantSymbols)
+    {
+    }
+
+    bool Evaluate(LexemeRange range, Constant& constant)
+    {
+        if (range.empty())
+        {
+            return false;
+        }
+
+        LexemeIndex_t index = range.m_Begin;
+        return ParseSum(index, range.m_End, constant) && index == range.m_End;
+    }
+
+private:
+    bool ParseSum(LexemeIndex_t& index, LexemeIndex_t end, Constant& constant)
+    {
+        if (!ParseProduct(index, end, constant))
+        {
+            return false;
+        }
+
+        while (index < end && (IsOperator(m_Lexemes, index, "+") || IsOperator(m_Lexemes, index, "-")))
+        {
+            const char operation = m_Lexemes.GetToken(index)[0];
+            index += 1;
+
+            Constant right;
+            if (!ParseProduct(index, end, right) || !ApplyOperator(operation, constant, right, constant))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool ParseProduct(LexemeIndex_t& index, LexemeIndex_t end, Constant& constant)
+    {
+        if (!ParseUnary(index, end, constant))
+        {
+            return false;
+        }
+
+        while (index < end && (IsOperator(m_Lexemes, index, "*") || IsOperator(m_Lexemes, index, "/")))
+        {
+            const char operation = m_Lexemes.GetToken(index)[0];
+            index += 1;
+
+            Constant right;
+            if (!ParseUnary(index, end, right) || !ApplyOperator(operation, constant, right, constant))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool ParseUnary(LexemeIndex_t& index, LexemeIndex_t end, Constant& constant)
+    {
+        if (index < end && (IsOperator(m_Lexemes, index, "-") || IsOperator(m_Lexemes, index, "+")))
+        {
+            const bool isNegation = m_Lexemes.GetToken(index)[0] == '-';
+            index += 1;
+
+            if (!ParseUnary(index, end, constant))
+            {
+                return false;
+            }
+
+            constant.m_Value = isNegation ? -constant.m_Value : constant.m_Value;
+            return true;
+        }
+
+        return ParsePrimary(index, end, constant);
+    }
+
+    bool ParsePrimary(LexemeIndex_t& index, LexemeIndex_t end, Constant& constant)
+    {
+        if (index >= end)
+        {
+            return false;
+        }
+
+        const TokenClass_t tokenClass = m_Lexemes.GetTokenClass(index);
+
+        if (tokenClass == TokenClass_t::VARIABLE_NAME)
+        {
+            // A literal, or the name of a constant which isn't followed by a swizzle or an index
+            const SymbolId_t symbolId = m_Lexemes.GetSymbolId(index);
+            if (ParseLiteral(m_Lexemes.GetToken(index), constant))
+            {
+                index += 1;
+                return true;
+            }
+
+            if (symbolId >= m_ConstantSymbols.size() || !m_ConstantSymbols[symbolId].first || (index + 1 < end && !IsOperatorFollower(index + 1)))
+            {
+                return false;
+            }
+
+            constant = m_ConstantSymbols[symbolId].second;
+            index += 1;
+            return true;
+        }
+
+        if (tokenClass == TokenClass_t::OPENED_PARANTHESIS)
+        {
+            const LexemeIndex_t closedParanthesis = m_SyntaxTree.GetMatchingBracket(index);
+            if (closedParanthesis == INVALID_LEXEME_INDEX || closedParanthesis >= end)
+            {
+                return false;
+            }
+
+            if (IsCast(m_Lexemes, m_SyntaxTree, index))
+            {
+                const char* scalarType = GetScalarType(m_Lexemes, index + 1);
+                index = closedParanthesis + 1;
+
+                return scalarType != nullptr && ParseUnary(index, end, constant) && Convert(scalarType, constant);
+            }
+
+            const LexemeRange content{ index + 1, closedParanthesis };
+            index = closedParanthesis + 1;
+
+            return Evaluate(content, constant);
+        }
+
+        const CallNode* call = m_SyntaxTree.FindCall(index);
+        if (call == nullptr || call->m_ClosedParanthesis >= end || call->m_NumberOfArguments == 0 || call->m_NumberOfArguments > 2)
+        {
+            return false;
+        }
+
+        Constant arguments[2];
+        for (size_t i = 0; i < call->m_NumberOfArguments; i++)
+        {
+            if (!Evaluate(m_SyntaxTree.GetArgument(*call, i), arguments[i]))
+            {
+                return false;
+            }
+        }
+
+        index = call->m_ClosedParanthesis + 1;
+
+        if (tokenClass == TokenClass_t::TYPE)
+        {
+            // Constructor of a scalar
+            const char* scalarType = GetScalarType(m_Lexemes, call->m_Function);
+            constant = arguments[0];
+
+            return scalarType != nullptr && call->m_NumberOfArguments == 1 && Convert(scalarType, constant);
+        }
+
+        return tokenClass == TokenClass_t::BUILTIN_FUNCTION &&
+               ApplyBuiltinFunction(m_Lexemes.GetToken(call->m_Function), arguments, call->m_NumberOfArguments, constant);
+    }
+
+    bool IsOperatorFollower(LexemeIndex_t index) const
+    {
+        const TokenClass_t tokenClass = m_Lexemes.GetTokenClass(index);
+        return tokenClass != TokenClass_t::STRUCTURE_OPERATOR && tokenClass != TokenClass_t::OPENED_ANGLE_BRACKET;
+    }
+
+    static bool Convert(const char* scalarType, Constant& constant)
+    {
+        if (scalarType[0] == 'i')
+        {
+            constant = Constant{ trunc(constant.m_Value), true };
+            return true;
+        }
+
+        return MakeFloat(constant.m_Value, constant);
+    }
+
+    const LexemeStream& m_Lexemes;
+    const SyntaxTree& m_SyntaxTree;
+    const ConstantSymbols& m_ConstantSymbols;
+};
+
+void AppendConstant(const Constant& constant, pmr::string& glsl)
+{
+    char buffer[64];
+    to_chars_result result = constant.m_IsInteger ? to_chars(buffer, buffer + sizeof(buffer), (int64_t) constant.m_Value)
+                                                  : to_chars(buffer, buffer + sizeof(buffer), (float) constant.m_Value);
+
+    glsl.append(buffer, result.ptr);
+
+    // A float literal needs a dot or an exponent
+    if (!constant.m_IsInteger && string_view(buffer, result.ptr - buffer).find_first_of(".e") == string_view::npos)
+    {
+        glsl += ".0";
+    }
+}
+
+// Lexemes which can come right before an expression, and right after one
+bool IsExpressionStart(const LexemeStream& lexemes, size_t lexemeIndex)
+{
+    switch (lexemes.GetTokenClass(lexemeIndex))
+    {
+    case TokenClass_t::OPENED_PARANTHESIS:
+    case TokenClass_t::OPENED_ANGLE_BRACKET:
+    case TokenClass_t::COMMA:
+    case TokenClass_t::ASSIGNATION:
+    case TokenClass_t::SEMICOLUMN:
+    case TokenClass_t::TERNARY_OPERATOR:
+    case TokenClass_t::COLON:
+        return true;
+    case TokenClass_t::FLOW_CONTROL:
+        return lexemes.GetToken(lexemeIndex) == "return";
+    case TokenClass_t::ARITHMETIC_OPERATOR:
+        return lexemes.GetToken(lexemeIndex).size() == 2 && lexemes.GetToken(lexemeIndex)[1] == '=';
+    default:
+        return false;
+    }
+}
+
+bool IsExpressionEnd(const LexemeStream& lexemes, size_t lexemeIndex)
+{
+    switch (lexemes.GetTokenClass(lexemeIndex))
+    {
+    case TokenClass_t::CLOSED_PARANTHESIS:
+    case TokenClass_t::CLOSED_ANGLE_BRACKET:
+    case TokenClass_t::COMMA:
+    case TokenClass_t::SEMICOLUMN:
+    case TokenClass_t::TERNARY_OPERATOR:
+    case TokenClass_t::COLON:
+    case TokenClass_t::RELATIONAL_OPERATOR:
+    case TokenClass_t::BITWISE_OPERATOR:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool IsOperand(const LexemeStream& lexemes, size_t lexemeIndex)
+{
+    const TokenClass_t tokenClass = lexemes.GetTokenClass(lexemeIndex);
+    return tokenClass == TokenClass_t::VARIABLE_NAME || tokenClass == TokenClass_t::CLOSED_PARANTHESIS || tokenClass == TokenClass_t::CLOSED_ANGLE_BRACKET;
+}
+
+bool IsLiteral(const LexemeStream& lexemes, size_t lexemeIndex, double value)
+{
+    Constant constant;
+    return lexemes.GetTokenClass(lexemeIndex) == TokenClass_t::VARIABLE_NAME && ParseLiteral(lexemes.GetToken(lexemeIndex), constant) &&
+           constant.m_Value == value;
+}
+
+// Number of lexemes of an identity operation starting at a lexeme: the operator and the literal of x * 1 or
+// x + 0, or the literal and the operator of 1 * x or 0 + x. 0 if there is none.
+size_t GetIdentityOperationLength(const LexemeStream& lexemes, size_t lexemeIndex)
+{
+    if (lexemeIndex == 0 || lexemeIndex + 2 >= lexemes.size())
+    {
+        return 0;
+    }
+
+    const size_t next = lexemeIndex + 1;
+    const size_t follower = lexemeIndex + 2;
+
+    // Nothing after the literal may bind tighter than the operator which goes away
+    const bool isFollowedByEnd = IsExpressionEnd(lexemes, follower) || IsOperator(lexemes, follower, "+") || IsOperator(lexemes, follower, "-");
+    const bool isFollowedByProduct = isFollowedByEnd || IsOperator(lexemes, follower, "*") || IsOperator(lexemes, follower, "/");
+
+    if ((IsOperator(lexemes, lexemeIndex, "*") || IsOperator(lexemes, lexemeIndex, "/")) && IsLiteral(lexemes, next, 1.0) && isFollowedByProduct)
+    {
+        return 2;
+    }
+
+    if ((IsOperator(lexemes, lexemeIndex, "+") || IsOperator(lexemes, lexemeIndex, "-")) && IsOperand(lexemes, lexemeIndex - 1) &&
+        IsLiteral(lexemes, next, 0.0) && isFollowedByEnd)
+    {
+        return 2;
+    }
+
+    if (IsExpressionStart(lexemes, lexemeIndex - 1) &&
+        ((IsLiteral(lexemes, lexemeIndex, 1.0) && IsOperator(lexemes, next, "*")) || (IsLiteral(lexemes, lexemeIndex, 0.0) && IsOperator(lexemes, next, "+"))))
+    {
+        return 2;
+    }
+
+    return 0;
+}
+
+// End of the expression starting at a lexeme: the first comma, semicolon or unmatched closing bracket
+LexemeIndex_t FindEndOfExpression(const LexemeStream& lexemes, const SyntaxTree& syntaxTree, LexemeIndex_t begin)
+{
+    LexemeIndex_t i = begin;
+    while (i < lexemes.size())
+    {
+        const TokenClass_t tokenClass = lexemes.GetTokenClass(i);
+        if (tokenClass == TokenClass_t::COMMA || tokenClass == TokenClass_t::SEMICOLUMN || IsClosedBracket(tokenClass))
+        {
+            break;
+        }
+
+        const LexemeIndex_t matchingBracket = syntaxTree.GetMatchingBracket(i);
+        i = (IsOpenedBracket(tokenClass) && matchingBracket != INVALID_LEXEME_INDEX) ? matchingBracket + 1 : i + 1;
+    }
+
+    return i;
+}
+
+pmr::vector<LexemeReplacement> FoldConstants(const LexemeStream& lexemes, const SyntaxTree& syntaxTree, const pmr::vector<LexemeRange>& unreachableCode,
+                                             ConstantFoldingStatistics* statistics, pmr::memory_resource* memoryResource)
+{
+    pmr::vector<LexemeReplacement> replacements(memoryResource);
+    ConstantFoldingStatistics foldingStatistics;
+
+    // A name declared more than once might be shadowed, so only names declared once can be constants
+    const size_t numberOfSymbols = lexemes.GetSymbolTable().size();
+    pmr::vector<uint8_t> numberOfDeclarations(numberOfSymbols, 0, memoryResource);
+
+    for (size_t i = 1; i < lexemes.size(); i++)
+    {
+        const SymbolId_t symbolId = lexemes.GetSymbolId(i);
+        const TokenClass_t previousTokenClass = lexemes.GetTokenClass(i - 1);
+
+        if (symbolId < numberOfSymbols && (previousTokenClass == TokenClass_t::TYPE || previousTokenClass == TokenClass_t::VARIABLE_NAME))
+        {
+            numberOfDeclarations[symbolId] = (uint8_t) min(numberOfDeclarations[symbolId] + 1, 2);
+        }
+    }
+
+    ConstantSymbols constantSymbols(numberOfSymbols, make_pair(false, Constant{ 0.0, false }), memoryResource);
+    ConstantEvaluator evaluator(lexemes, syntaxTree, constantSymbols);
+
+    // Calls whose arguments are being walked, with the index of the next argument. Other brackets have no call.
+    struct OpenedBracket
+    {
+        const CallNode* m_Call;
+        size_t m_NextArgument;
+    };
+
+    pmr::vector<OpenedBracket> openedBrackets(memoryResource);
+
+    auto tryToFold = [&](LexemeRange range) -> bool
+    {
+        // A literal or a negated literal is already as simple as it gets
+        const bool isLiteral = range.size() == 1 || (range.size() == 2 && IsOperator(lexemes, range.m_Begin, "-"));
+
+        Constant constant;
+        if (isLiteral || !evaluator.Evaluate(range, constant))
+        {
+            return false;
+        }
+
+        LexemeReplacement replacement{ range, pmr::string(memoryResource) };
+        AppendConstant(constant, replacement.m_Glsl);
+        replacements.push_back(move(replacement));
+
+        const size_t numberOfOperations = CountOperations(lexemes, syntaxTree, range);
+        foldingStatistics.m_Operations += numberOfOperations;
+        foldingStatistics.m_RemovedOperations += numberOfOperations;
+        foldingStatistics.m_FoldedExpressions += 1;
+
+        return true;
+    };
+
+    size_t unreachableCodeCursor = 0;
+    for (size_t i = SkipUnreachableCode(unreachableCode, unreachableCodeCursor, 0); i < lexemes.size();
+         i = SkipUnreachableCode(unreachableCode, unreachableCodeCursor, i + 1))
+    {
+        // Folded expressions are jumped over as a whole, so the brackets stay balanced
+        if (!replacements.empty() && replacements.back().m_Range.m_Begin == i)
+        {
+            i = replacements.back().m_Range.m_End - 1;
+            continue;
+        }
+
+        const TokenClass_t tokenClass = lexemes.GetTokenClass(i);
+        const LexemeIndex_t lexemeIndex = (LexemeIndex_t) i;
+
+        // Expression starting after this lexeme
+        LexemeRange expression{ lexemeIndex + 1, lexemeIndex + 1 };
+
+        if (tokenClass == TokenClass_t::ASSIGNATION || (tokenClass == TokenClass_t::FLOW_CONTROL && lexemes.GetToken(i) == "return"))
+        {
+            expression.m_End = FindEndOfExpression(lexemes, syntaxTree, expression.m_Begin);
+        }
+        else if (IsOpenedBracket(tokenClass) && tokenClass != TokenClass_t::OPENED_CURLY_BRACKET)
+        {
+            const CallNode* call = (tokenClass == TokenClass_t::OPENED_PARANTHESIS && i > 0) ? syntaxTree.FindCall(i - 1) : nullptr;
+            openedBrackets.push_back(OpenedBracket{ call, 0 });
+
+            if (call != nullptr && call->m_NumberOfArguments > 0)
+            {
+                expression = syntaxTree.GetArgument(*call, openedBrackets.back().m_NextArgument++);
+            }
+            else if (call == nullptr && !IsCast(lexemes, syntaxTree, i) && syntaxTree.GetMatchingBracket(i) != INVALID_LEXEME_INDEX)
+            {
+                expression.m_End = syntaxTree.GetMatchingBracket(i);
+            }
+        }
+        else if (IsClosedBracket(tokenClass) && tokenClass != TokenClass_t::CLOSED_CURLY_BRACKET)
+        {
+            if (!openedBrackets.empty())
+            {
+                openedBrackets.pop_back();
+            }
+        }
+        else if (tokenClass == TokenClass_t::COMMA && !openedBrackets.empty() && openedBrackets.back().m_Call != nullptr)
+        {
+            OpenedBracket& openedBracket = openedBrackets.back();
+            if (openedBracket.m_NextArgument < openedBracket.m_Call->m_NumberOfArguments)
+            {
+                expression = syntaxTree.GetArgument(*openedBracket.m_Call, openedBracket.m_NextArgument++);
+            }
+        }
+
+        const bool isFolded = tryToFold(expression);
+
+        // static const float name = value; at the top level
+        if (tokenClass == TokenClass_t::ASSIGNATION && openedBrackets.empty() && i >= 3 && lexemes.GetTokenClass(i - 3) == TokenClass_t::FLOW_CONTROL &&
+            lexemes.GetToken(i - 3) == "const" && GetScalarType(lexemes, i - 2) != nullptr && lexemes.GetTokenClass(i - 1) == TokenClass_t::VARIABLE_NAME)
+        {
+            const SymbolId_t symbolId = lexemes.GetSymbolId(i - 1);
+
+            Constant constant;
+            if (symbolId < numberOfSymbols && numberOfDeclarations[symbolId] == 1 && evaluator.Evaluate(expression, constant))
+            {
+                const char* scalarType = GetScalarType(lexemes, i - 2);
+                constant = (scalarType[0] == 'i') ? Constant{ trunc(constant.m_Value), true } : Constant{ (float) constant.m_Value, false };
+
+                constantSymbols[symbolId] = make_pair(true, constant);
+                foldingStatistics.m_EvaluatedConstants += 1;
+            }
+        }
+
+        if (isFolded)
+        {
+            continue;
+        }
+
+        if (IsOperation(lexemes, syntaxTree, i))
+        {
+            foldingStatistics.m_Operations += 1;
+        }
+
+        const size_t identityOperationLength = GetIdentityOperationLength(lexemes, i);
+        if (identityOperationLength > 0)
+        {
+            LexemeRange identityOperation{ lexemeIndex, (LexemeIndex_t) (i + identityOperationLength) };
+            replacements.push_back(LexemeReplacement{ identityOperation, pmr::string(memoryResource) });
+
+            // The operator was counted with the first lexeme if it comes first
+            const size_t numberOfOperations = CountOperations(lexemes, syntaxTree, identityOperation);
+            foldingStatistics.m_Operations += numberOfOperations - (IsOperation(lexemes, syntaxTree, i) ? 1 : 0);
+            foldingStatistics.m_RemovedOperations += numberOfOperations;
+            foldingStatistics.m_RemovedIdentities += 1;
+
+            i = identityOperation.m_End - 1;
+        }
+    }
+
+    if (statistics != nullptr)
+    {
+        *statistics = foldingStatistics;
+    }
+
+    return replacements;
+}
+
+const LexemeReplacement* FindReplacement(const pmr::vector<LexemeReplacement>& replacements, size_t lexemeIndex)
+{
+    auto it = lower_bound(replacements.begin(), replacements.end(), lexemeIndex,
+                          [](const LexemeReplacement& replacement, size_t index) { return replacement.m_Range.m_Begin < index; });
+
+    return (it != replacements.end() && it->m_Range.m_Begin == lexemeIndex) ? &*it : nullptr;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+#include "ConversionArena.h"
+
+namespace HlslToGlsl
+{
+
+ConversionArena::ConversionArena(size_t initialSizeInBytes)
+    : m_Block(initialSizeInBytes)
+    , m_Resource(make_unique<pmr::monotonic_buffer_resource>(m_Block.data(), m_Block.size(), &m_Overflow))
+{
+}
+
+void ConversionArena::Reset()
+{
+    m_Resource->release();
+
+    if (m_Overflow.m_AllocatedSizeInBytes > 0)
+    {
+        // The last conversion didn't fit, make the block big enough for it
+        const size_t newSize = m_Block.size() + m_Overflow.m_AllocatedSizeInBytes;
+        m_Overflow.m_AllocatedSizeInBytes = 0;
+
+        m_Resource.reset();
+        m_Block = vector<char>(newSize);
+        m_Resource = make_unique<pmr::monotonic_buffer_resource>(m_Block.data(), m_Block.size(), &m_Overflow);
+    }
+}
+
+void* ConversionArena::OverflowResource::do_allocate(size_t bytes, size_t alignment)
+{
+    m_AllocatedSizeInBytes += bytes;
+    return pmr::new_delete_resource()->allocate(bytes, alignment);
+}
+
+void ConversionArena::OverflowResource::do_deallocate(void* pointer, size_t bytes, size_t alignment)
+{
+    pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+}
+
+}
\ No newline at end of file
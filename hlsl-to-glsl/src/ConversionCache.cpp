@@ -0,0 +1,139 @@
+#include "ConversionCache.h"
+
+#include "HlslToGlsl.h"
+
+#include <algorithm>
+
+namespace HlslToGlsl
+{
+
+ConversionCache::ConversionCache(size_t maximumSizeInBytes, size_t numberOfShards)
+    : m_MaximumShardSizeInBytes(maximumSizeInBytes / max(numberOfShards, (size_t) 1))
+    , m_Shards(max(numberOfShards, (size_t) 1))
+{
+}
+
+shared_ptr<const string> ConversionCache::Convert(string_view hlslSource, const string& entryFunctionName, bool isVertexShader,
+                                                  const ConversionOptions& options)
+{
+    // The units of the combined samplers come from the table, which the key doesn't cover, and the statistics of
+    // the uniform blocks are only gathered by converting
+    if (options.m_SamplerBindings != nullptr || options.m_UniformBlockStatistics != nullptr)
+    {
+        shared_ptr<string> uncachedOutputGlsl = make_shared<string>();
+        return ConvertHlslToGlslFromSource(hlslSource, entryFunctionName, isVertexShader, *uncachedOutputGlsl, options) ? uncachedOutputGlsl : nullptr;
+    }
+
+    const ConversionKey key = ComputeConversionKey(hlslSource, entryFunctionName, isVertexShader, options);
+
+    shared_ptr<const string> outputGlsl = Find(key);
+    if (outputGlsl != nullptr)
+    {
+        return outputGlsl;
+    }
+
+    // Two threads missing the same key at the same time will both convert it, which is cheaper than making
+    // every other thread of the shard wait for the conversion
+    shared_ptr<string> newOutputGlsl = make_shared<string>();
+    if (!ConvertHlslToGlslFromSource(hlslSource, entryFunctionName, isVertexShader, *newOutputGlsl, options))
+    {
+        return nullptr;
+    }
+
+    newOutputGlsl->shrink_to_fit();
+    outputGlsl = newOutputGlsl;
+
+    Insert(key, outputGlsl);
+    return outputGlsl;
+}
+
+shared_ptr<const string> ConversionCache::Find(const ConversionKey& key)
+{
+    Shard& shard = GetShard(key);
+    lock_guard<mutex> lock(shard.m_Mutex);
+
+    auto it = shard.m_EntriesByKey.find(key);
+    if (it == shard.m_EntriesByKey.end())
+    {
+        shard.m_Misses += 1;
+        return nullptr;
+    }
+
+    // Move the entry to the front, without reallocating it
+    shard.m_Entries.splice(shard.m_Entries.begin(), shard.m_Entries, it->second);
+    shard.m_Hits += 1;
+
+    return it->second->m_OutputGlsl;
+}
+
+void ConversionCache::Insert(const ConversionKey& key, const shared_ptr<const string>& outputGlsl)
+{
+    Entry entry;
+    entry.m_Key = key;
+    entry.m_OutputGlsl = outputGlsl;
+
+    const size_t entrySize = GetEntrySize(entry);
+    if (entrySize > m_MaximumShardSizeInBytes)
+    {
+        return;
+    }
+
+    Shard& shard = GetShard(key);
+    lock_guard<mutex> lock(shard.m_Mutex);
+
+    if (shard.m_EntriesByKey.find(key) != shard.m_EntriesByKey.end())
+    {
+        return;
+    }
+
+    while (shard.m_SizeInBytes + entrySize > m_MaximumShardSizeInBytes)
+    {
+        // Callers still holding the evicted output keep it alive until they release it
+        const Entry& leastRecentlyUsed = shard.m_Entries.back();
+        shard.m_SizeInBytes -= GetEntrySize(leastRecentlyUsed);
+        shard.m_EntriesByKey.erase(leastRecentlyUsed.m_Key);
+        shard.m_Entries.pop_back();
+        shard.m_Evictions += 1;
+    }
+
+    shard.m_Entries.push_front(entry);
+    shard.m_EntriesByKey[key] = shard.m_Entries.begin();
+    shard.m_SizeInBytes += entrySize;
+}
+
+void ConversionCache::Clear()
+{
+    for (Shard& shard : m_Shards)
+    {
+        lock_guard<mutex> lock(shard.m_Mutex);
+
+        shard.m_Entries.clear();
+        shard.m_EntriesByKey.clear();
+        shard.m_SizeInBytes = 0;
+    }
+}
+
+ConversionCacheStatistics ConversionCache::GetStatistics() const
+{
+    ConversionCacheStatistics statistics = {};
+
+    for (const Shard& shard : m_Shards)
+    {
+        lock_guard<mutex> lock(shard.m_Mutex);
+
+        statistics.m_Hits += shard.m_Hits;
+        statistics.m_Misses += shard.m_Misses;
+        statistics.m_Evictions += shard.m_Evictions;
+        statistics.m_SizeInBytes += shard.m_SizeInBytes;
+    }
+
+    return statistics;
+}
+
+size_t ConversionCache::GetEntrySize(const Entry& entry)
+{
+    // Count the bookkeeping too, so that a budget full of tiny shaders is still a real bound
+    return entry.m_OutputGlsl->capacity() + sizeof(Entry) + sizeof(string) + 4 * sizeof(void*);
+}
+
+}
\ No newline at end of file
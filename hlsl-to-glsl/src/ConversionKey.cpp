@@ -0,0 +1,46 @@
+#include "ConversionKey.h"
+
+#include "Hash.h"
+
+namespace HlslToGlsl
+{
+
+string ConversionKey::ToString() const
+{
+    const char hexadecimalDigits[] = "0123456789abcdef";
+
+    string key;
+    key.reserve(32);
+
+    for (uint64_t hash : m_Hash)
+    {
+        for (int shift = 60; shift >= 0; shift -= 4)
+        {
+            key += hexadecimalDigits[(hash >> shift) & 0xF];
+        }
+    }
+
+    return key;
+}
+
+ConversionKey ComputeConversionKey(string_view hlslSource, const string& entryFunctionName, bool isVertexShader, const ConversionOptions& options)
+{
+    // Everything but the source goes in a small buffer hashed after it
+    string parameters = entryFunctionName;
+    parameters += '\0';
+    parameters += (isVertexShader) ? 'v' : 'f';
+    parameters += (options.m_FoldConstants) ? 'c' : '-';
+    parameters += (options.m_PrecisionQualifiers) ? 'p' : '-';
+    parameters += GetGlslProfile(options.m_Profile).m_Name;
+    parameters += '\0';
+    parameters += (options.m_Minify) ? ((options.m_RenameLocals) ? 'r' : 'm') : '-';
+    parameters += to_string(CONVERTER_VERSION);
+
+    ConversionKey key;
+    key.m_Hash[0] = HashBytes(parameters, HashBytes(hlslSource, 0x9e3779b97f4a7c15ull));
+    key.m_Hash[1] = HashBytes(parameters, HashBytes(hlslSource, 0xc2b2ae3d27d4eb4full));
+
+    return key;
+}
+
+}
\ No newline at end of file
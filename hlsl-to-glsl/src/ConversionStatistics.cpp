@@ -0,0 +1,142 @@
+#include "ConversionStatistics.h"
+
+#include <cstdio>
+
+namespace HlslToGlsl
+{
+
+void AppendJsonNumber(const char* name, double value, string& json);
+
+double ConversionStatistics::GetTotalSeconds() const
+{
+    return m_ReadSeconds + m_CacheSeconds + m_TokenizeSeconds + m_AnalysisSeconds + m_PreprocessSeconds + m_EmissionSeconds + m_MinificationSeconds;
+}
+
+void ConversionStatistics::Add(const ConversionStatistics& other)
+{
+    m_Conversions += other.m_Conversions;
+    m_CacheHits += other.m_CacheHits;
+
+    m_ReadSeconds += other.m_ReadSeconds;
+    m_CacheSeconds += other.m_CacheSeconds;
+    m_TokenizeSeconds += other.m_TokenizeSeconds;
+    m_AnalysisSeconds += other.m_AnalysisSeconds;
+    m_PreprocessSeconds += other.m_PreprocessSeconds;
+    m_EmissionSeconds += other.m_EmissionSeconds;
+    m_MinificationSeconds += other.m_MinificationSeconds;
+
+    m_SourceBytes += other.m_SourceBytes;
+    m_OutputBytes += other.m_OutputBytes;
+    m_Lexemes += other.m_Lexemes;
+    for (size_t i = 0; i < NUMBER_OF_TOKEN_CLASSES; i++)
+    {
+        m_LexemesPerTokenClass[i] += other.m_LexemesPerTokenClass[i];
+    }
+
+    m_Allocations += other.m_Allocations;
+    m_AllocatedBytes += other.m_AllocatedBytes;
+}
+
+void* CountingMemoryResource::do_allocate(size_t bytes, size_t alignment)
+{
+    m_Statistics.m_Allocations += 1;
+    m_Statistics.m_AllocatedBytes += bytes;
+    return m_Upstream->allocate(bytes, alignment);
+}
+
+void CountingMemoryResource::do_deallocate(void* pointer, size_t bytes, size_t alignment)
+{
+    m_Upstream->deallocate(pointer, bytes, alignment);
+}
+
+string_view GetTokenClassName(TokenClass_t tokenClass)
+{
+    // In the order of TokenClass_t
+    static const string_view names[NUMBER_OF_TOKEN_CLASSES] = {
+        "type",
+        "variable_name",
+        "semicolumn",
+        "opened_curly_bracket",
+        "closed_curly_bracket",
+        "comma",
+        "opened_angle_bracket",
+        "closed_angle_bracket",
+        "opened_paranthesis",
+        "closed_paranthesis",
+        "arithmetic_operator",
+        "relational_operator",
+        "assignation",
+        "builtin_function",
+        "colon",
+        "cbuffer",
+        "register",
+        "flow_control",
+        "struct",
+        "bitwise_operator",
+        "structure_operator",
+        "ternary_operator",
+        "comment",
+        "sampler_state",
+        "texture",
+    };
+
+    return names[tokenClass];
+}
+
+void WriteConversionStatisticsAsJson(const ConversionStatistics& statistics, string& json)
+{
+    json += "{";
+    AppendJsonNumber("conversions", (double) statistics.m_Conversions, json);
+    AppendJsonNumber("cache_hits", (double) statistics.m_CacheHits, json);
+
+    json += "\"seconds\": {";
+    AppendJsonNumber("read", statistics.m_ReadSeconds, json);
+    AppendJsonNumber("cache", statistics.m_CacheSeconds, json);
+    AppendJsonNumber("tokenize", statistics.m_TokenizeSeconds, json);
+    AppendJsonNumber("analysis", statistics.m_AnalysisSeconds, json);
+    AppendJsonNumber("preprocess", statistics.m_PreprocessSeconds, json);
+    AppendJsonNumber("emission", statistics.m_EmissionSeconds, json);
+    AppendJsonNumber("minification", statistics.m_MinificationSeconds, json);
+    AppendJsonNumber("total", statistics.GetTotalSeconds(), json);
+    json.resize(json.size() - 2);
+    json += "}, ";
+
+    AppendJsonNumber("source_bytes", (double) statistics.m_SourceBytes, json);
+    AppendJsonNumber("output_bytes", (double) statistics.m_OutputBytes, json);
+    AppendJsonNumber("allocations", (double) statistics.m_Allocations, json);
+    AppendJsonNumber("allocated_bytes", (double) statistics.m_AllocatedBytes, json);
+    AppendJsonNumber("lexemes", (double) statistics.m_Lexemes, json);
+
+    // Only the classes the source has
+    json += "\"lexemes_per_token_class\": {";
+    bool isFirst = true;
+    for (size_t i = 0; i < NUMBER_OF_TOKEN_CLASSES; i++)
+    {
+        if (statistics.m_LexemesPerTokenClass[i] > 0)
+        {
+            json += isFirst ? "" : ", ";
+            json += "\"";
+            json += GetTokenClassName((TokenClass_t) i);
+            json += "\": ";
+            json += to_string(statistics.m_LexemesPerTokenClass[i]);
+            isFirst = false;
+        }
+    }
+
+    json += "}}";
+}
+
+// Followed by a comma and a space, which the caller removes after the last number of an object
+void AppendJsonNumber(const char* name, double value, string& json)
+{
+    char number[32];
+    snprintf(number, sizeof(number), "%.9g", value);
+
+    json += "\"";
+    json += name;
+    json += "\": ";
+    json += number;
+    json += ", ";
+}
+
+}
\ No newline at end of file
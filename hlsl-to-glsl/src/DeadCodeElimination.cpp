@@ -0,0 +1,262 @@
+#include "DeadCodeElimination.h"
+
+#include <algorithm>
+#include <utility>
+using namespace std;
+
+namespace HlslToGlsl
+{
+
+// A top level declaration, with the names it declares and the names it uses
+struct TopLevelDeclaration
+{
+    LexemeRange m_Range;
+    uint32_t m_FirstDefinition;
+    uint32_t m_NumberOfDefinitions;
+    uint32_t m_FirstReference;
+    uint32_t m_NumberOfReferences;
+    bool m_IsReachable;
+};
+
+typedef pair<SymbolId_t, uint32_t> SymbolDeclaration;
+
+bool IsLessSymbol(const SymbolDeclaration& a, const SymbolDeclaration& b)
+{
+    return a.first < b.first;
+}
+
+// Splits the names of a declaration into the ones it declares and the ones it uses. Functions and structs
+// declare their own name, textures and sampler states the name of their declaration. Anything else declares
+// the variables following a type or a comma at its top level, which for a cbuffer is inside of its body.
+void CollectNames(const LexemeStream& lexemes, const SyntaxTree& syntaxTree, LexemeRange range, LexemeIndex_t functionName,
+                  pmr::vector<SymbolId_t>& definitions, pmr::vector<SymbolId_t>& references)
+{
+    LexemeIndex_t first = range.m_Begin;
+    while (first < range.m_End && lexemes.GetTokenClass(first) == TokenClass_t::COMMENT)
+    {
+        first += 1;
+    }
+
+    if (first == range.m_End)
+    {
+        return;
+    }
+
+    const TokenClass_t firstTokenClass = lexemes.GetTokenClass(first);
+
+    LexemeIndex_t declaredName = INVALID_LEXEME_INDEX;
+    if (functionName != INVALID_LEXEME_INDEX)
+    {
+        declaredName = functionName;
+    }
+    else if (firstTokenClass == TokenClass_t::STRUCT && first + 1 < range.m_End)
+    {
+        declaredName = first + 1;
+    }
+    else if (firstTokenClass == TokenClass_t::TEXTURE || firstTokenClass == TokenClass_t::SAMPLER_STATE)
+    {
+        const DeclarationNode* declaration = syntaxTree.FindDeclaration(first);
+        declaredName = declaration != nullptr ? declaration->m_Name : INVALID_LEXEME_INDEX;
+    }
+
+    // Depth at which variables are declared
+    const bool declaresVariables = declaredName == INVALID_LEXEME_INDEX && functionName == INVALID_LEXEME_INDEX;
+    const size_t variableDepth = firstTokenClass == TokenClass_t::CBUFFER ? 1 : 0;
+
+    size_t depth = 0;
+    for (LexemeIndex_t i = first; i < range.m_End; i++)
+    {
+        const TokenClass_t tokenClass = lexemes.GetTokenClass(i);
+
+        if (IsOpenedBracket(tokenClass))
+        {
+            depth += 1;
+        }
+        else if (IsClosedBracket(tokenClass))
+        {
+            depth -= depth > 0 ? 1 : 0;
+        }
+
+        if (tokenClass != TokenClass_t::VARIABLE_NAME)
+        {
+            continue;
+        }
+
+        bool isDefinition = (i == declaredName);
+        if (declaresVariables && depth == variableDepth && i > first)
+        {
+            // The first name of a declaration follows its type, the next ones a comma: float a, b;
+            const TokenClass_t previousTokenClass = lexemes.GetTokenClass(i - 1);
+            isDefinition = previousTokenClass == TokenClass_t::TYPE || previousTokenClass == TokenClass_t::VARIABLE_NAME ||
+                           previousTokenClass == TokenClass_t::COMMA;
+        }
+
+        (isDefinition ? definitions : references).push_back(lexemes.GetSymbolId(i));
+    }
+}
+
+pmr::vector<LexemeRange> FindUnreachableCode(const LexemeStream& lexemes, const SyntaxTree& syntaxTree, SymbolId_t entryFunctionSymbol,
+                                             pmr::memory_resource* memoryResource)
+{
+    pmr::vector<LexemeRange> unreachableCode(memoryResource);
+    if (entryFunctionSymbol == INVALID_SYMBOL_ID)
+    {
+        return unreachableCode;
+    }
+
+    pmr::vector<TopLevelDeclaration> declarations(memoryResource);
+    pmr::vector<SymbolId_t> definitions(memoryResource);
+    pmr::vector<SymbolId_t> references(memoryResource);
+
+    // Split the top level into declarations. Each one ends with a semicolon or with the closing curly bracket
+    // of a function, and starts with the comments before it.
+    size_t function = 0;
+    size_t depth = 0;
+    LexemeIndex_t begin = 0;
+
+    for (LexemeIndex_t i = 0; i < lexemes.size(); i++)
+    {
+        const TokenClass_t tokenClass = lexemes.GetTokenClass(i);
+
+        if (IsOpenedBracket(tokenClass))
+        {
+            depth += 1;
+            continue;
+        }
+
+        if (IsClosedBracket(tokenClass))
+        {
+            depth -= depth > 0 ? 1 : 0;
+        }
+
+        if (depth > 0 || (tokenClass != TokenClass_t::SEMICOLUMN && tokenClass != TokenClass_t::CLOSED_CURLY_BRACKET))
+        {
+            continue;
+        }
+
+        // The semicolon after the body of a struct or a cbuffer belongs to it
+        if (tokenClass == TokenClass_t::CLOSED_CURLY_BRACKET && i + 1 < lexemes.size() && lexemes.GetTokenClass(i + 1) == TokenClass_t::SEMICOLUMN)
+        {
+            i += 1;
+        }
+
+        LexemeIndex_t functionName = INVALID_LEXEME_INDEX;
+        while (function < syntaxTree.m_Functions.size() && syntaxTree.m_Functions[function].m_OpenedCurlyBracket < begin)
+        {
+            function += 1;
+        }
+
+        if (function < syntaxTree.m_Functions.size() && syntaxTree.m_Functions[function].m_OpenedCurlyBracket <= i)
+        {
+            functionName = syntaxTree.m_Calls[syntaxTree.m_Functions[function].m_Signature].m_Function;
+        }
+
+        TopLevelDeclaration declaration;
+        declaration.m_Range = LexemeRange{ begin, i + 1 };
+        declaration.m_FirstDefinition = (uint32_t) definitions.size();
+        declaration.m_FirstReference = (uint32_t) references.size();
+        declaration.m_IsReachable = false;
+
+        CollectNames(lexemes, syntaxTree, declaration.m_Range, functionName, definitions, references);
+
+        declaration.m_NumberOfDefinitions = (uint32_t) definitions.size() - declaration.m_FirstDefinition;
+        declaration.m_NumberOfReferences = (uint32_t) references.size() - declaration.m_FirstReference;
+        declarations.push_back(declaration);
+
+        begin = i + 1;
+    }
+
+    // Declarations by the names they declare
+    pmr::vector<SymbolDeclaration> declarationsOfSymbols(memoryResource);
+    declarationsOfSymbols.reserve(definitions.size());
+
+    for (uint32_t i = 0; i < declarations.size(); i++)
+    {
+        for (uint32_t j = 0; j < declarations[i].m_NumberOfDefinitions; j++)
+        {
+            declarationsOfSymbols.emplace_back(definitions[declarations[i].m_FirstDefinition + j], i);
+        }
+    }
+
+    sort(declarationsOfSymbols.begin(), declarationsOfSymbols.end());
+
+    if (!binary_search(declarationsOfSymbols.begin(), declarationsOfSymbols.end(), SymbolDeclaration(entryFunctionSymbol, 0), IsLessSymbol))
+    {
+        return unreachableCode;
+    }
+
+    // Walk the names used from the entry function, and from whatever doesn't declare any name
+    pmr::vector<uint8_t> isSymbolVisited(lexemes.GetSymbolTable().size(), 0, memoryResource);
+    pmr::vector<SymbolId_t> symbolsToVisit(memoryResource);
+
+    auto visit = [&](SymbolId_t symbolId)
+    {
+        if (symbolId < isSymbolVisited.size() && !isSymbolVisited[symbolId])
+        {
+            isSymbolVisited[symbolId] = 1;
+            symbolsToVisit.push_back(symbolId);
+        }
+    };
+
+    auto markReachable = [&](TopLevelDeclaration& declaration)
+    {
+        declaration.m_IsReachable = true;
+
+        for (uint32_t j = 0; j < declaration.m_NumberOfReferences; j++)
+        {
+            visit(references[declaration.m_FirstReference + j]);
+        }
+    };
+
+    visit(entryFunctionSymbol);
+
+    for (TopLevelDeclaration& declaration : declarations)
+    {
+        if (declaration.m_NumberOfDefinitions == 0)
+        {
+            markReachable(declaration);
+        }
+    }
+
+    while (!symbolsToVisit.empty())
+    {
+        const SymbolId_t symbolId = symbolsToVisit.back();
+        symbolsToVisit.pop_back();
+
+        auto range = equal_range(declarationsOfSymbols.begin(), declarationsOfSymbols.end(), SymbolDeclaration(symbolId, 0), IsLessSymbol);
+
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if (!declarations[it->second].m_IsReachable)
+            {
+                markReachable(declarations[it->second]);
+            }
+        }
+    }
+
+    for (const TopLevelDeclaration& declaration : declarations)
+    {
+        if (!declaration.m_IsReachable)
+        {
+            unreachableCode.push_back(declaration.m_Range);
+        }
+    }
+
+    return unreachableCode;
+}
+
+size_t SkipUnreachableCode(const pmr::vector<LexemeRange>& unreachableCode, size_t& cursor, size_t lexemeIndex)
+{
+    // Unreachable declarations are often next to each other
+    for (; cursor < unreachableCode.size() && unreachableCode[cursor].m_Begin <= lexemeIndex; cursor++)
+    {
+        if (lexemeIndex < unreachableCode[cursor].m_End)
+        {
+            lexemeIndex = unreachableCode[cursor].m_End;
+        }
+    }
+
+    return lexemeIndex;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,183 @@
+#include "DiskCache.h"
+
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <sstream>
+#include <thread>
+#include <vector>
+using namespace std;
+
+namespace HlslToGlsl
+{
+
+const char* const CACHE_ENTRY_EXTENSION = ".glsl";
+
+DiskCache::DiskCache(const string& directory, uint64_t maximumSizeInBytes)
+    : m_Directory(directory)
+    , m_MaximumSizeInBytes(maximumSizeInBytes)
+    , m_SizeInBytes(0)
+    , m_Hits(0)
+    , m_Misses(0)
+    , m_Stores(0)
+    , m_Evictions(0)
+{
+    error_code error;
+    filesystem::create_directories(m_Directory, error);
+
+    for (filesystem::directory_iterator it(m_Directory, error), end; !error && it != end; it.increment(error))
+    {
+        if (it->path().extension() == CACHE_ENTRY_EXTENSION)
+        {
+            m_SizeInBytes += it->file_size(error);
+        }
+    }
+
+    // The maximum size might be lower than the one used by the previous runs
+    if (m_SizeInBytes > m_MaximumSizeInBytes)
+    {
+        EvictLeastRecentlyUsed();
+    }
+}
+
+bool DiskCache::Load(const ConversionKey& key, string& outputGlsl)
+{
+    const filesystem::path entryPath = filesystem::path(m_Directory) / (key.ToString() + CACHE_ENTRY_EXTENSION);
+
+    MappedFile entryFile;
+    if (!entryFile.Open(entryPath.string()))
+    {
+        m_Misses += 1;
+        return false;
+    }
+
+    outputGlsl.assign(entryFile.GetContent());
+    entryFile.Close();
+
+    // The modification time is what orders the entries for eviction, so a hit makes the entry the most recent
+    error_code error;
+    filesystem::last_write_time(entryPath, filesystem::file_time_type::clock::now(), error);
+
+    m_Hits += 1;
+    return true;
+}
+
+void DiskCache::Store(const ConversionKey& key, const string& outputGlsl)
+{
+    const filesystem::path entryPath = filesystem::path(m_Directory) / (key.ToString() + CACHE_ENTRY_EXTENSION);
+
+    // The temporary name must be unique among every process and thread writing to the directory
+    ostringstream temporaryName;
+    temporaryName << key.ToString() << ".tmp" << chrono::steady_clock::now().time_since_epoch().count() << "_" << this_thread::get_id();
+    const filesystem::path temporaryPath = filesystem::path(m_Directory) / temporaryName.str();
+
+    FILE* file = fopen(temporaryPath.string().c_str(), "wb");
+    if (file == nullptr)
+    {
+        return;
+    }
+
+    bool hasFailed = (fwrite(outputGlsl.data(), 1, outputGlsl.size(), file) != outputGlsl.size());
+    hasFailed |= (fclose(file) != 0);
+
+    error_code error;
+    if (!hasFailed)
+    {
+        filesystem::rename(temporaryPath, entryPath, error);
+    }
+
+    if (hasFailed || error)
+    {
+        filesystem::remove(temporaryPath, error);
+        return;
+    }
+
+    m_Stores += 1;
+
+    if ((m_SizeInBytes += outputGlsl.size()) > m_MaximumSizeInBytes)
+    {
+        EvictLeastRecentlyUsed();
+    }
+}
+
+DiskCacheStatistics DiskCache::GetStatistics() const
+{
+    DiskCacheStatistics statistics;
+    statistics.m_Hits = m_Hits;
+    statistics.m_Misses = m_Misses;
+    statistics.m_Stores = m_Stores;
+    statistics.m_Evictions = m_Evictions;
+
+    return statistics;
+}
+
+void DiskCache::EvictLeastRecentlyUsed()
+{
+    lock_guard<mutex> lock(m_EvictionMutex);
+
+    // Another thread might have evicted while we were waiting
+    if (m_SizeInBytes <= m_MaximumSizeInBytes)
+    {
+        return;
+    }
+
+    // Other processes also write to the directory, so the size has to be computed from scratch
+    struct Entry
+    {
+        filesystem::file_time_type m_LastUse;
+        uint64_t m_Size;
+        filesystem::path m_Path;
+    };
+
+    vector<Entry> entries;
+    uint64_t sizeInBytes = 0;
+
+    // Temporary files older than this were left behind by a process that died while storing a result
+    const filesystem::file_time_type abandonedTime = filesystem::file_time_type::clock::now() - chrono::hours(1);
+
+    error_code error;
+    for (filesystem::directory_iterator it(m_Directory, error), end; !error && it != end; it.increment(error))
+    {
+        error_code entryError;
+
+        if (it->path().extension() != CACHE_ENTRY_EXTENSION)
+        {
+            if (it->path().filename().string().find(".tmp") != string::npos && it->last_write_time(entryError) < abandonedTime && !entryError)
+            {
+                filesystem::remove(it->path(), entryError);
+            }
+
+            continue;
+        }
+
+        Entry entry;
+        entry.m_LastUse = it->last_write_time(entryError);
+        entry.m_Size = it->file_size(entryError);
+        entry.m_Path = it->path();
+
+        if (!entryError)
+        {
+            sizeInBytes += entry.m_Size;
+            entries.push_back(entry);
+        }
+    }
+
+    sort(entries.begin(), entries.end(), [] (const Entry& a, const Entry& b) {
+        return a.m_LastUse < b.m_LastUse;
+    });
+
+    for (size_t i = 0; i < entries.size() && sizeInBytes > m_MaximumSizeInBytes; i++)
+    {
+        // Another process might already have removed it, either way it no longer takes space
+        filesystem::remove(entries[i].m_Path, error);
+        sizeInBytes -= entries[i].m_Size;
+        m_Evictions += 1;
+    }
+
+    m_SizeInBytes = sizeInBytes;
+}
+
+}
\ No newline at end of file
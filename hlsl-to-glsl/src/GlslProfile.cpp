@@ -0,0 +1,39 @@
+#include "GlslProfile.h"
+
+namespace HlslToGlsl
+{
+
+// In the order of GlslProfile_t. GLSL ES versions are matched with the desktop version which has the same
+// builtin functions: fma only comes with ES 3.20, and no ES version has the fine and coarse derivatives.
+constexpr GlslProfile glslProfiles[] = {
+    { "330",        "#version 330",         330,    false,  false,  false },
+    { "420",        "#version 420",         420,    false,  true,   false },
+    { "450",        "#version 450",         450,    false,  true,   false },
+    { "es300",      "#version 300 es",      330,    true,   false,  false },
+    { "es310",      "#version 310 es",      330,    true,   true,   false },
+    { "es320",      "#version 320 es",      400,    true,   true,   false },
+    { "vulkan",     "#version 450",         450,    false,  true,   true },
+};
+
+static_assert(sizeof(glslProfiles) / sizeof(glslProfiles[0]) == GLSL_PROFILE_VULKAN + 1, "glslProfiles must have one entry per GlslProfile_t");
+
+const GlslProfile& GetGlslProfile(GlslProfile_t profile)
+{
+    return glslProfiles[profile];
+}
+
+bool FindGlslProfile(string_view name, GlslProfile_t& profile)
+{
+    for (size_t i = 0; i < sizeof(glslProfiles) / sizeof(glslProfiles[0]); i++)
+    {
+        if (glslProfiles[i].m_Name == name)
+        {
+            profile = (GlslProfile_t) i;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#include "Hash.h"
+
+#include <cstring>
+
+namespace HlslToGlsl
+{
+
+uint64_t HashBytes(const void* data, size_t size, uint64_t seed)
+{
+    const uint64_t multiplier = 0xc6a4a7935bd1e995ull;
+    const int shift = 47;
+
+    const unsigned char* bytes = (const unsigned char*) data;
+    const unsigned char* end = bytes + (size & ~(size_t) 7);
+
+    uint64_t hash = seed ^ (size * multiplier);
+
+    for (; bytes != end; bytes += 8)
+    {
+        uint64_t block;
+        memcpy(&block, bytes, sizeof(block));
+
+        block *= multiplier;
+        block ^= block >> shift;
+        block *= multiplier;
+
+        hash ^= block;
+        hash *= multiplier;
+    }
+
+    switch (size & 7)
+    {
+    case 7: hash ^= uint64_t(bytes[6]) << 48;   // Fall through
+    case 6: hash ^= uint64_t(bytes[5]) << 40;   // Fall through
+    case 5: hash ^= uint64_t(bytes[4]) << 32;   // Fall through
+    case 4: hash ^= uint64_t(bytes[3]) << 24;   // Fall through
+    case 3: hash ^= uint64_t(bytes[2]) << 16;   // Fall through
+    case 2: hash ^= uint64_t(bytes[1]) << 8;    // Fall through
+    case 1: hash ^= uint64_t(bytes[0]);
+            hash *= multiplier;
+    }
+
+    hash ^= hash >> shift;
+    hash *= multiplier;
+    hash ^= hash >> shift;
+
+    return hash;
+}
+
+}
\ No newline at end of file
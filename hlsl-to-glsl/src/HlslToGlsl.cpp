@@ -1,50 +1,152 @@
 #include "HlslToGlsl.h"
 
 #include "CodeGenerator.h"
+#include "ConversionKey.h"
+#include "ConversionStatistics.h"
+#include "DiskCache.h"
+#include "MappedFile.h"
+#include "SymbolTable.h"
 #include "Tokenizer.h"
-
-#include <fstream>
 using namespace std;
 
 namespace HlslToGlsl
 {
 
-void WriteHeaderOfGlsl(string& outputGlsl);
+void WriteHeaderOfGlsl(const ConversionOptions& options, string& outputGlsl);
+bool ConvertHlslToGlslWithStatistics(string_view hlslSource, const string& entryFunctionName, bool isVertexShader, string& outputGlsl,
+                                     const ConversionOptions& options, pmr::memory_resource* memoryResource, SymbolTable* sharedSymbolTable,
+                                     ConversionStatistics& statistics);
 
-bool ConvertHlslToGlslFromFile(const string& filename, const string& entryFunctionName, bool isVertexShader, string& outputGlsl)
+bool ConvertHlslToGlslFromFile(const string& filename, const string& entryFunctionName, bool isVertexShader, string& outputGlsl,
+                               const ConversionOptions& options, DiskCache* cache, pmr::memory_resource* memoryResource, SymbolTable* sharedSymbolTable)
 {
     outputGlsl = "";
 
-    ifstream inputFile(filename);
-    if (!inputFile.is_open())
+    if (options.m_LoadedFromCache != nullptr)
+    {
+        *options.m_LoadedFromCache = false;
+    }
+
+    ConversionStatistics* statistics = options.m_ConversionStatistics;
+    PhaseClock clock(statistics);
+
+    // The tokenizer works directly on the mapped file, the source is never copied
+    MappedFile inputFile;
+    if (!inputFile.Open(filename))
     {
         return false;
     }
 
-    string inputHlsl;
-    inputFile.seekg(0, std::ios::end);
-    inputHlsl.reserve((size_t) inputFile.tellg());
-    inputHlsl.resize((size_t) inputFile.tellg());
-    inputFile.seekg(0, std::ios::beg);
+    clock.Lap(&ConversionStatistics::m_ReadSeconds);
+
+    if (cache == nullptr || options.m_SamplerBindings != nullptr || options.m_UniformBlockStatistics != nullptr)
+    {
+        return ConvertHlslToGlslFromSource(inputFile.GetContent(), entryFunctionName, isVertexShader, outputGlsl, options, memoryResource, sharedSymbolTable);
+    }
+
+    const ConversionKey key = ComputeConversionKey(inputFile.GetContent(), entryFunctionName, isVertexShader, options);
+    if (cache->Load(key, outputGlsl))
+    {
+        clock.Lap(&ConversionStatistics::m_CacheSeconds);
+
+        if (options.m_LoadedFromCache != nullptr)
+        {
+            *options.m_LoadedFromCache = true;
+        }
+
+        if (statistics != nullptr)
+        {
+            statistics->m_Conversions += 1;
+            statistics->m_CacheHits += 1;
+            statistics->m_SourceBytes += inputFile.GetContent().size();
+            statistics->m_OutputBytes += outputGlsl.size();
+        }
+
+        return true;
+    }
+
+    clock.Lap(&ConversionStatistics::m_CacheSeconds);
 
-    inputFile.read(&inputHlsl[0], inputHlsl.length());
+    if (!ConvertHlslToGlslFromSource(inputFile.GetContent(), entryFunctionName, isVertexShader, outputGlsl, options, memoryResource, sharedSymbolTable))
+    {
+        return false;
+    }
+
+    // Restarted, the conversion measured itself
+    clock = PhaseClock(statistics);
+    cache->Store(key, outputGlsl);
+    clock.Lap(&ConversionStatistics::m_CacheSeconds);
 
-    return ConvertHlslToGlslFromSource(inputHlsl, entryFunctionName, isVertexShader, outputGlsl);
+    return true;
 }
 
-bool ConvertHlslToGlslFromSource(const string& hlslSource, const string& entryFunctionName, bool isVertexShader, string& outputGlsl)
+bool ConvertHlslToGlslFromSource(string_view hlslSource, const string& entryFunctionName, bool isVertexShader, string& outputGlsl,
+                                 const ConversionOptions& options, pmr::memory_resource* memoryResource, SymbolTable* sharedSymbolTable)
 {
-    vector<Lexeme> lexemes = ParseIntoLexemes(hlslSource);
+    ConversionStatistics* statistics = options.m_ConversionStatistics;
+    if (statistics != nullptr)
+    {
+        return ConvertHlslToGlslWithStatistics(hlslSource, entryFunctionName, isVertexShader, outputGlsl, options, memoryResource, sharedSymbolTable, *statistics);
+    }
 
-    WriteHeaderOfGlsl(outputGlsl);
-    ConvertLexemesIntoGlsl(lexemes, entryFunctionName, isVertexShader, outputGlsl);
+    SymbolTable symbolTable(false, memoryResource);
+    LexemeStream lexemes = ParseIntoLexemes(hlslSource, (sharedSymbolTable != nullptr) ? *sharedSymbolTable : symbolTable, memoryResource);
+
+    WriteHeaderOfGlsl(options, outputGlsl);
+    ConvertLexemesIntoGlsl(lexemes, entryFunctionName, isVertexShader, outputGlsl, options, memoryResource);
 
     return true;
 }
 
-void WriteHeaderOfGlsl(string& outputGlsl)
+// The same conversion, with everything it allocates counted and the lexemes sorted by class
+bool ConvertHlslToGlslWithStatistics(string_view hlslSource, const string& entryFunctionName, bool isVertexShader, string& outputGlsl,
+                                     const ConversionOptions& options, pmr::memory_resource* memoryResource, SymbolTable* sharedSymbolTable,
+                                     ConversionStatistics& statistics)
 {
-    outputGlsl += "#version 420\n";
+    CountingMemoryResource countingResource(memoryResource, statistics);
+    const size_t initialOutputSize = outputGlsl.size();
+
+    PhaseClock clock(&statistics);
+
+    SymbolTable symbolTable(false, &countingResource);
+    LexemeStream lexemes = ParseIntoLexemes(hlslSource, (sharedSymbolTable != nullptr) ? *sharedSymbolTable : symbolTable, &countingResource);
+
+    clock.Lap(&ConversionStatistics::m_TokenizeSeconds);
+
+    for (size_t i = 0; i < lexemes.size(); i++)
+    {
+        statistics.m_LexemesPerTokenClass[lexemes.GetTokenClass(i)] += 1;
+    }
+
+    WriteHeaderOfGlsl(options, outputGlsl);
+    ConvertLexemesIntoGlsl(lexemes, entryFunctionName, isVertexShader, outputGlsl, options, &countingResource);
+
+    statistics.m_Conversions += 1;
+    statistics.m_SourceBytes += hlslSource.size();
+    statistics.m_OutputBytes += outputGlsl.size() - initialOutputSize;
+    statistics.m_Lexemes += lexemes.size();
+
+    return true;
+}
+
+void WriteHeaderOfGlsl(const ConversionOptions& options, string& outputGlsl)
+{
+    const GlslProfile& profile = GetGlslProfile(options.m_Profile);
+
+    outputGlsl += profile.m_VersionDirective;
+    outputGlsl += "\n";
+
+    // Only the reduced precision types get a qualifier, everything else keeps the precision of HLSL. GLSL ES
+    // has no default precision for floats, nor for 3D samplers.
+    if (options.m_PrecisionQualifiers || profile.m_IsEs)
+    {
+        outputGlsl += "precision highp float;\nprecision highp int;\n";
+    }
+
+    if (profile.m_IsEs)
+    {
+        outputGlsl += "precision highp sampler3D;\n";
+    }
 }
 
 }
\ No newline at end of file
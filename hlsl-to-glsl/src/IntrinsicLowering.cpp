@@ -0,0 +1,121 @@
+#include "IntrinsicLowering.h"
+
+#include <algorithm>
+#include <cctype>
+using namespace std;
+
+namespace HlslToGlsl
+{
+
+constexpr string_view CLIP_HELPER =
+    "void clip(float x) { if (x < 0.0) discard; }\n"
+    "void clip(vec2 x) { if (any(lessThan(x, vec2(0.0)))) discard; }\n"
+    "void clip(vec3 x) { if (any(lessThan(x, vec3(0.0)))) discard; }\n"
+    "void clip(vec4 x) { if (any(lessThan(x, vec4(0.0)))) discard; }\n";
+
+// Sorted by HLSL name, then from the most to the least recent GLSL version
+constexpr IntrinsicLowering intrinsicLowerings[] = {
+    { "clip",           1,  110,    "clip($0)",                         CLIP_HELPER },
+    { "ddx_coarse",     1,  450,    "dFdxCoarse($0)",                   "" },
+    { "ddx_coarse",     1,  110,    "dFdx($0)",                         "" },
+    { "ddx_fine",       1,  450,    "dFdxFine($0)",                     "" },
+    { "ddx_fine",       1,  110,    "dFdx($0)",                         "" },
+    { "ddy_coarse",     1,  450,    "dFdyCoarse($0)",                   "" },
+    { "ddy_coarse",     1,  110,    "dFdy($0)",                         "" },
+    { "ddy_fine",       1,  450,    "dFdyFine($0)",                     "" },
+    { "ddy_fine",       1,  110,    "dFdy($0)",                         "" },
+    { "fma",            3,  400,    "fma($0, $1, $2)",                  "" },
+    { "fma",            3,  110,    "(@0 * @1 + @2)",                   "" },
+    { "fmod",           2,  130,    "(@0 - @1 * trunc(@0 / @1))",       "" },       // The result has the sign of x, unlike mod
+    { "log10",          1,  110,    "(log2($0) * 0.301029996)",         "" },
+    { "mul",            2,  110,    "(@0 * @1)",                        "" },
+    { "rcp",            1,  110,    "(1.0 / @0)",                       "" },
+    { "rsqrt",          1,  110,    "inversesqrt($0)",                  "" },
+    { "saturate",       1,  110,    "clamp($0, 0.0, 1.0)",              "" },
+};
+
+constexpr bool AreIntrinsicLoweringsSorted()
+{
+    for (size_t i = 1; i < sizeof(intrinsicLowerings) / sizeof(intrinsicLowerings[0]); i++)
+    {
+        const IntrinsicLowering& previous = intrinsicLowerings[i - 1];
+        const IntrinsicLowering& current = intrinsicLowerings[i];
+
+        if (current.m_Hlsl < previous.m_Hlsl || (current.m_Hlsl == previous.m_Hlsl && current.m_MinimumGlslVersion >= previous.m_MinimumGlslVersion))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static_assert(AreIntrinsicLoweringsSorted(), "intrinsicLowerings must be sorted by name, then by decreasing GLSL version");
+
+const IntrinsicLowering* FindIntrinsicLowering(string_view hlsl, size_t numberOfArguments, uint32_t glslVersion)
+{
+    const IntrinsicLowering* end = intrinsicLowerings + sizeof(intrinsicLowerings) / sizeof(intrinsicLowerings[0]);
+    const IntrinsicLowering* it = lower_bound(intrinsicLowerings, end, hlsl,
+                                              [](const IntrinsicLowering& lowering, string_view name) { return lowering.m_Hlsl < name; });
+
+    for (; it != end && it->m_Hlsl == hlsl; ++it)
+    {
+        if (it->m_NumberOfArguments == numberOfArguments && it->m_MinimumGlslVersion <= glslVersion)
+        {
+            return it;
+        }
+    }
+
+    return nullptr;
+}
+
+// A name, a literal or a call, optionally followed by swizzles or members, i.e. input.uv.x or max(a, b).y
+bool IsSingleOperand(string_view glsl)
+{
+    size_t depth = 0;
+
+    for (char c : glsl)
+    {
+        if (c == '(' || c == '[')
+        {
+            depth += 1;
+        }
+        else if ((c == ')' || c == ']') && depth > 0)
+        {
+            depth -= 1;
+        }
+        else if (depth == 0 && !isalnum((unsigned char) c) && c != '_' && c != '.' && c != ' ')
+        {
+            return false;
+        }
+    }
+
+    // Spaces only separate a constructor from its paranthesis, two names in a row would be something else
+    return glsl.find(' ') == string_view::npos || glsl.find_first_of("([") != string_view::npos;
+}
+
+void AppendIntrinsicLowering(const IntrinsicLowering& lowering, const string_view* arguments, OutputWriter& output)
+{
+    string_view glsl = lowering.m_Glsl;
+
+    for (size_t argument = glsl.find_first_of("$@"); argument != string_view::npos; argument = glsl.find_first_of("$@"))
+    {
+        const size_t argumentIndex = (argument + 1 < glsl.size()) ? (size_t) (glsl[argument + 1] - '0') : MAXIMUM_NUMBER_OF_INTRINSIC_ARGUMENTS;
+        const string_view value = (argumentIndex < lowering.m_NumberOfArguments) ? arguments[argumentIndex] : string_view();
+
+        if (glsl[argument] == '@' && !IsSingleOperand(value))
+        {
+            output.Append(glsl.substr(0, argument), "(", value, ")");
+        }
+        else
+        {
+            output.Append(glsl.substr(0, argument), value);
+        }
+
+        glsl.remove_prefix(min(argument + 2, glsl.size()));
+    }
+
+    output.Append(glsl);
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,338 @@
+#include "Keywords.h"
+
+#include <array>
+
+namespace HlslToGlsl
+{
+
+// Every keyword recognized by the converter. The table and the hash tables built from it below are all
+// constexpr, so nothing here runs at static initialization time.
+constexpr Keyword keywords[] = {
+    // Types
+    { "bool",            KEYWORD_TYPE,               "bool" },
+    { "int",             KEYWORD_TYPE,               "int" },
+    { "uint",            KEYWORD_TYPE,               "uint" },
+    { "dword",           KEYWORD_TYPE,               "uint" },
+    { "half",            KEYWORD_TYPE,               "float",           "mediump" },
+    { "float",           KEYWORD_TYPE,               "float" },
+    { "double",          KEYWORD_TYPE,               "double" },
+
+    { "bool1",           KEYWORD_TYPE,               "bool" },
+    { "bool2",           KEYWORD_TYPE,               "bvec2" },
+    { "bool3",           KEYWORD_TYPE,               "bvec3" },
+    { "bool4",           KEYWORD_TYPE,               "bvec4" },
+
+    { "int1",            KEYWORD_TYPE,               "int" },
+    { "int2",            KEYWORD_TYPE,               "ivec2" },
+    { "int3",            KEYWORD_TYPE,               "ivec3" },
+    { "int4",            KEYWORD_TYPE,               "ivec4" },
+
+    { "uint1",           KEYWORD_TYPE,               "uint" },
+    { "uint2",           KEYWORD_TYPE,               "uvec2" },
+    { "uint3",           KEYWORD_TYPE,               "uvec3" },
+    { "uint4",           KEYWORD_TYPE,               "uvec4" },
+
+    { "half1",           KEYWORD_TYPE,               "float",           "mediump" },
+    { "half2",           KEYWORD_TYPE,               "vec2",            "mediump" },
+    { "half3",           KEYWORD_TYPE,               "vec3",            "mediump" },
+    { "half4",           KEYWORD_TYPE,               "vec4",            "mediump" },
+
+    { "float1",          KEYWORD_TYPE,               "float" },
+    { "float2",          KEYWORD_TYPE,               "vec2" },
+    { "float3",          KEYWORD_TYPE,               "vec3" },
+    { "float4",          KEYWORD_TYPE,               "vec4" },
+
+    { "double1",         KEYWORD_TYPE,               "double" },
+    { "double2",         KEYWORD_TYPE,               "dvec2" },
+    { "double3",         KEYWORD_TYPE,               "dvec3" },
+    { "double4",         KEYWORD_TYPE,               "dvec4" },
+
+    { "min16float",      KEYWORD_TYPE,               "float",           "mediump" },
+    { "min16float1",     KEYWORD_TYPE,               "float",           "mediump" },
+    { "min16float2",     KEYWORD_TYPE,               "vec2",            "mediump" },
+    { "min16float3",     KEYWORD_TYPE,               "vec3",            "mediump" },
+    { "min16float4",     KEYWORD_TYPE,               "vec4",            "mediump" },
+
+    { "min10float",      KEYWORD_TYPE,               "float",           "lowp" },
+    { "min10float1",     KEYWORD_TYPE,               "float",           "lowp" },
+    { "min10float2",     KEYWORD_TYPE,               "vec2",            "lowp" },
+    { "min10float3",     KEYWORD_TYPE,               "vec3",            "lowp" },
+    { "min10float4",     KEYWORD_TYPE,               "vec4",            "lowp" },
+
+    { "min16int",        KEYWORD_TYPE,               "int",             "mediump" },
+    { "min16int1",       KEYWORD_TYPE,               "int",             "mediump" },
+    { "min16int2",       KEYWORD_TYPE,               "ivec2",           "mediump" },
+    { "min16int3",       KEYWORD_TYPE,               "ivec3",           "mediump" },
+    { "min16int4",       KEYWORD_TYPE,               "ivec4",           "mediump" },
+
+    { "min12int",        KEYWORD_TYPE,               "int",             "mediump" },
+    { "min12int1",       KEYWORD_TYPE,               "int",             "mediump" },
+    { "min12int2",       KEYWORD_TYPE,               "ivec2",           "mediump" },
+    { "min12int3",       KEYWORD_TYPE,               "ivec3",           "mediump" },
+    { "min12int4",       KEYWORD_TYPE,               "ivec4",           "mediump" },
+
+    { "min16uint",       KEYWORD_TYPE,               "uint",            "mediump" },
+    { "min16uint1",      KEYWORD_TYPE,               "uint",            "mediump" },
+    { "min16uint2",      KEYWORD_TYPE,               "uvec2",           "mediump" },
+    { "min16uint3",      KEYWORD_TYPE,               "uvec3",           "mediump" },
+    { "min16uint4",      KEYWORD_TYPE,               "uvec4",           "mediump" },
+
+    { "float2x2",        KEYWORD_TYPE,               "mat2" },
+    { "float3x3",        KEYWORD_TYPE,               "mat3" },
+    { "float4x4",        KEYWORD_TYPE,               "mat4" },
+
+    // Builtin functions
+    { "abs",             KEYWORD_BUILTIN_FUNCTION,   "abs" },
+    { "acos",            KEYWORD_BUILTIN_FUNCTION,   "acos" },
+    { "all",             KEYWORD_BUILTIN_FUNCTION,   "all" },
+    { "any",             KEYWORD_BUILTIN_FUNCTION,   "any" },
+    { "asin",            KEYWORD_BUILTIN_FUNCTION,   "asin" },
+    { "atan",            KEYWORD_BUILTIN_FUNCTION,   "atan" },
+    { "atan2",           KEYWORD_BUILTIN_FUNCTION,   "atan" },
+    { "ceil",            KEYWORD_BUILTIN_FUNCTION,   "ceil" },
+    { "clamp",           KEYWORD_BUILTIN_FUNCTION,   "clamp" },
+    { "clip",            KEYWORD_BUILTIN_FUNCTION,   "clip" },             // Lowered, see IntrinsicLowering.cpp
+    { "cos",             KEYWORD_BUILTIN_FUNCTION,   "cos" },
+    { "cosh",            KEYWORD_BUILTIN_FUNCTION,   "cosh" },
+    { "cross",           KEYWORD_BUILTIN_FUNCTION,   "cross" },
+    { "ddx",             KEYWORD_BUILTIN_FUNCTION,   "dFdx" },
+    { "ddx_coarse",      KEYWORD_BUILTIN_FUNCTION,   "dFdxCoarse" },
+    { "ddx_fine",        KEYWORD_BUILTIN_FUNCTION,   "dFdxFine" },
+    { "ddy",             KEYWORD_BUILTIN_FUNCTION,   "dFdy" },
+    { "ddy_coarse",      KEYWORD_BUILTIN_FUNCTION,   "dFdyCoarse" },
+    { "ddy_fine",        KEYWORD_BUILTIN_FUNCTION,   "dFdyFine" },
+    { "degrees",         KEYWORD_BUILTIN_FUNCTION,   "degrees" },
+    { "determinant",     KEYWORD_BUILTIN_FUNCTION,   "determinant" },
+    { "distance",        KEYWORD_BUILTIN_FUNCTION,   "distance" },
+    { "dot",             KEYWORD_BUILTIN_FUNCTION,   "dot" },
+    { "exp",             KEYWORD_BUILTIN_FUNCTION,   "exp" },
+    { "exp2",            KEYWORD_BUILTIN_FUNCTION,   "exp2" },
+    { "faceforward",     KEYWORD_BUILTIN_FUNCTION,   "faceforward" },
+    { "floor",           KEYWORD_BUILTIN_FUNCTION,   "floor" },
+    { "fma",             KEYWORD_BUILTIN_FUNCTION,   "fma" },
+    { "fmod",            KEYWORD_BUILTIN_FUNCTION,   "fmod" },             // Lowered, see IntrinsicLowering.cpp
+    { "frac",            KEYWORD_BUILTIN_FUNCTION,   "fract" },
+    { "frexp",           KEYWORD_BUILTIN_FUNCTION,   "frexp" },
+    { "fwidth",          KEYWORD_BUILTIN_FUNCTION,   "fwidth" },
+    { "isfinite",        KEYWORD_BUILTIN_FUNCTION,   "isfinite" },
+    { "isinf",           KEYWORD_BUILTIN_FUNCTION,   "isinf" },
+    { "isnan",           KEYWORD_BUILTIN_FUNCTION,   "isnan" },
+    { "ldexp",           KEYWORD_BUILTIN_FUNCTION,   "ldexp" },
+    { "length",          KEYWORD_BUILTIN_FUNCTION,   "length" },
+    { "lerp",            KEYWORD_BUILTIN_FUNCTION,   "mix" },
+    { "log",             KEYWORD_BUILTIN_FUNCTION,   "log" },
+    { "log10",           KEYWORD_BUILTIN_FUNCTION,   "log10" },            // Lowered, see IntrinsicLowering.cpp
+    { "log2",            KEYWORD_BUILTIN_FUNCTION,   "log2" },
+    { "max",             KEYWORD_BUILTIN_FUNCTION,   "max" },
+    { "min",             KEYWORD_BUILTIN_FUNCTION,   "min" },
+    { "modf",            KEYWORD_BUILTIN_FUNCTION,   "modf" },
+    { "mul",             KEYWORD_BUILTIN_FUNCTION,   "*" },                // Lowered, see IntrinsicLowering.cpp
+    { "noise",           KEYWORD_BUILTIN_FUNCTION,   "noise" },
+    { "normalize",       KEYWORD_BUILTIN_FUNCTION,   "normalize" },
+    { "pow",             KEYWORD_BUILTIN_FUNCTION,   "pow" },
+    { "radians",         KEYWORD_BUILTIN_FUNCTION,   "radians" },
+    { "rcp",             KEYWORD_BUILTIN_FUNCTION,   "rcp" },              // Lowered, see IntrinsicLowering.cpp
+    { "reflect",         KEYWORD_BUILTIN_FUNCTION,   "reflect" },
+    { "refract",         KEYWORD_BUILTIN_FUNCTION,   "refract" },
+    { "reversebits",     KEYWORD_BUILTIN_FUNCTION,   "bitfieldReverse" },
+    { "round",           KEYWORD_BUILTIN_FUNCTION,   "round" },
+    { "rsqrt",           KEYWORD_BUILTIN_FUNCTION,   "inversesqrt" },      // Lowered, see IntrinsicLowering.cpp
+    { "saturate",        KEYWORD_BUILTIN_FUNCTION,   "clamp" },            // Lowered, see IntrinsicLowering.cpp
+    { "sign",            KEYWORD_BUILTIN_FUNCTION,   "sign" },
+    { "sin",             KEYWORD_BUILTIN_FUNCTION,   "sin" },
+    { "sinh",            KEYWORD_BUILTIN_FUNCTION,   "sinh" },
+    { "smoothstep",      KEYWORD_BUILTIN_FUNCTION,   "smoothstep" },
+    { "sqrt",            KEYWORD_BUILTIN_FUNCTION,   "sqrt" },
+    { "step",            KEYWORD_BUILTIN_FUNCTION,   "step" },
+    { "tan",             KEYWORD_BUILTIN_FUNCTION,   "tan" },
+    { "tanh",            KEYWORD_BUILTIN_FUNCTION,   "tanh" },
+    { "tex1D",           KEYWORD_BUILTIN_FUNCTION,   "texture" },
+    { "tex1Dbias",       KEYWORD_BUILTIN_FUNCTION,   "texture" },
+    { "tex1Dgrad",       KEYWORD_BUILTIN_FUNCTION,   "textureGrad" },
+    { "tex1Dlod",        KEYWORD_BUILTIN_FUNCTION,   "textureLod" },
+    { "tex1Dproj",       KEYWORD_BUILTIN_FUNCTION,   "textureProj" },
+    { "tex2D",           KEYWORD_BUILTIN_FUNCTION,   "texture" },
+    { "tex2Dbias",       KEYWORD_BUILTIN_FUNCTION,   "texture" },
+    { "tex2Dgrad",       KEYWORD_BUILTIN_FUNCTION,   "textureGrad" },
+    { "tex2Dlod",        KEYWORD_BUILTIN_FUNCTION,   "textureLod" },
+    { "tex2Dproj",       KEYWORD_BUILTIN_FUNCTION,   "textureProj" },
+    { "tex3D",           KEYWORD_BUILTIN_FUNCTION,   "texture" },
+    { "tex3Dbias",       KEYWORD_BUILTIN_FUNCTION,   "texture" },
+    { "tex3Dgrad",       KEYWORD_BUILTIN_FUNCTION,   "textureGrad" },
+    { "tex3Dlod",        KEYWORD_BUILTIN_FUNCTION,   "textureLod" },
+    { "tex3Dproj",       KEYWORD_BUILTIN_FUNCTION,   "textureProj" },
+    { "texCUBE",         KEYWORD_BUILTIN_FUNCTION,   "texture" },
+    { "texCUBEbias",     KEYWORD_BUILTIN_FUNCTION,   "texture" },
+    { "texCUBEgrad",     KEYWORD_BUILTIN_FUNCTION,   "textureGrad" },
+    { "texCUBElod",      KEYWORD_BUILTIN_FUNCTION,   "textureLod" },
+    { "texCUBEproj",     KEYWORD_BUILTIN_FUNCTION,   "textureProj" },
+    { "transpose",       KEYWORD_BUILTIN_FUNCTION,   "transpose" },
+    { "trunc",           KEYWORD_BUILTIN_FUNCTION,   "trunc" },
+
+    // Flow control
+    { "break",           KEYWORD_FLOW_CONTROL,       "break" },
+    { "continue",        KEYWORD_FLOW_CONTROL,       "continue" },
+    { "discard",         KEYWORD_FLOW_CONTROL,       "discard" },
+    { "do",              KEYWORD_FLOW_CONTROL,       "do" },
+    { "for",             KEYWORD_FLOW_CONTROL,       "for" },
+    { "if",              KEYWORD_FLOW_CONTROL,       "if" },
+    { "switch",          KEYWORD_FLOW_CONTROL,       "switch" },
+    { "case",            KEYWORD_FLOW_CONTROL,       "case" },
+    { "while",           KEYWORD_FLOW_CONTROL,       "while" },
+    { "return",          KEYWORD_FLOW_CONTROL,       "return" },
+    { "else",            KEYWORD_FLOW_CONTROL,       "else" },
+    { "const",           KEYWORD_FLOW_CONTROL,       "const" },
+
+    // Declarations
+    { "cbuffer",         KEYWORD_CBUFFER,            "cbuffer" },
+    { "register",        KEYWORD_REGISTER,           "register" },
+    { "struct",          KEYWORD_STRUCT,             "struct" },
+    { "SamplerState",    KEYWORD_SAMPLER_STATE,      "SamplerState" },
+    { "Texture1D",       KEYWORD_TEXTURE,            "Texture1D" },
+    { "Texture2D",       KEYWORD_TEXTURE,            "Texture2D" },
+    { "Texture3D",       KEYWORD_TEXTURE,            "Texture3D" },
+
+    // Keywords to ignore
+    { "static",          KEYWORD_TO_IGNORE,          "" },
+};
+
+constexpr size_t NUMBER_OF_KEYWORDS = sizeof(keywords) / sizeof(keywords[0]);
+static_assert(NUMBER_OF_KEYWORDS < INVALID_KEYWORD_ID, "Too many keywords for KeywordId_t");
+
+// The perfect hash is a two level "hash and displace" scheme: a first hash picks a bucket, and each bucket
+// stores the seed of a second hash that sends all of its keywords to distinct slots of the final table.
+constexpr size_t NUMBER_OF_BUCKETS = 64;
+constexpr size_t NUMBER_OF_SLOTS = 256;
+
+constexpr uint32_t HashKeyword(string_view token, uint32_t seed)
+{
+    // FNV-1a, with the seed folded into the offset basis
+    uint32_t hash = 2166136261u ^ (seed * 16777619u);
+    for (char c : token)
+    {
+        hash ^= (uint8_t) c;
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+struct KeywordHashTable
+{
+    array<uint16_t, NUMBER_OF_BUCKETS> m_Seeds;
+    array<KeywordId_t, NUMBER_OF_SLOTS> m_Slots;
+    bool m_IsValid;
+};
+
+constexpr KeywordHashTable BuildKeywordHashTable()
+{
+    KeywordHashTable table = {};
+    table.m_IsValid = true;
+
+    for (size_t i = 0; i < NUMBER_OF_SLOTS; i++)
+    {
+        table.m_Slots[i] = INVALID_KEYWORD_ID;
+    }
+
+    array<size_t, NUMBER_OF_KEYWORDS> bucketOfKeyword = {};
+    array<size_t, NUMBER_OF_BUCKETS> bucketSizes = {};
+    for (size_t i = 0; i < NUMBER_OF_KEYWORDS; i++)
+    {
+        bucketOfKeyword[i] = HashKeyword(keywords[i].m_Hlsl, 0) % NUMBER_OF_BUCKETS;
+        bucketSizes[bucketOfKeyword[i]] += 1;
+    }
+
+    // Place the largest buckets first, while the table is still mostly empty
+    array<bool, NUMBER_OF_BUCKETS> isBucketPlaced = {};
+    for (size_t placed = 0; placed < NUMBER_OF_BUCKETS; placed++)
+    {
+        size_t bucket = 0;
+        size_t largestSize = 0;
+        for (size_t i = 0; i < NUMBER_OF_BUCKETS; i++)
+        {
+            if (!isBucketPlaced[i] && bucketSizes[i] >= largestSize)
+            {
+                bucket = i;
+                largestSize = bucketSizes[i];
+            }
+        }
+
+        isBucketPlaced[bucket] = true;
+        if (largestSize == 0)
+        {
+            continue;
+        }
+
+        bool isPlaced = false;
+        for (uint32_t seed = 1; seed < 0xFFFF && !isPlaced; seed++)
+        {
+            array<size_t, NUMBER_OF_SLOTS> slotsOfBucket = {};
+            size_t numberOfSlots = 0;
+
+            isPlaced = true;
+            for (size_t i = 0; i < NUMBER_OF_KEYWORDS && isPlaced; i++)
+            {
+                if (bucketOfKeyword[i] != bucket)
+                {
+                    continue;
+                }
+
+                const size_t slot = HashKeyword(keywords[i].m_Hlsl, seed) % NUMBER_OF_SLOTS;
+                isPlaced = (table.m_Slots[slot] == INVALID_KEYWORD_ID);
+
+                for (size_t j = 0; j < numberOfSlots && isPlaced; j++)
+                {
+                    isPlaced = (slotsOfBucket[j] != slot);
+                }
+
+                slotsOfBucket[numberOfSlots] = slot;
+                numberOfSlots += 1;
+            }
+
+            if (!isPlaced)
+            {
+                continue;
+            }
+
+            table.m_Seeds[bucket] = (uint16_t) seed;
+            for (size_t i = 0, j = 0; i < NUMBER_OF_KEYWORDS; i++)
+            {
+                if (bucketOfKeyword[i] == bucket)
+                {
+                    table.m_Slots[slotsOfBucket[j]] = (KeywordId_t) i;
+                    j += 1;
+                }
+            }
+        }
+
+        if (!isPlaced)
+        {
+            table.m_IsValid = false;
+        }
+    }
+
+    return table;
+}
+
+constexpr KeywordHashTable keywordHashTable = BuildKeywordHashTable();
+static_assert(keywordHashTable.m_IsValid, "Couldn't build the perfect hash of the keywords, increase NUMBER_OF_SLOTS");
+
+KeywordId_t FindKeyword(string_view token)
+{
+    const uint32_t seed = keywordHashTable.m_Seeds[HashKeyword(token, 0) % NUMBER_OF_BUCKETS];
+    const KeywordId_t keywordId = keywordHashTable.m_Slots[HashKeyword(token, seed) % NUMBER_OF_SLOTS];
+
+    if (keywordId == INVALID_KEYWORD_ID || keywords[keywordId].m_Hlsl != token)
+    {
+        return INVALID_KEYWORD_ID;
+    }
+
+    return keywordId;
+}
+
+const Keyword& GetKeyword(KeywordId_t keywordId)
+{
+    return keywords[keywordId];
+}
+
+}
\ No newline at end of file
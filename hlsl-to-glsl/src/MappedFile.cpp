@@ -0,0 +1,131 @@
+#include "MappedFile.h"
+
+#include <cstdio>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define HLSL_TO_GLSL_HAS_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace HlslToGlsl
+{
+
+MappedFile::MappedFile()
+    : m_IsOpen(false)
+    , m_Data(nullptr)
+    , m_Size(0)
+    , m_IsMapped(false)
+{
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+bool MappedFile::Open(const string& filename)
+{
+    Close();
+
+#ifdef HLSL_TO_GLSL_HAS_MMAP
+    int fileDescriptor = open(filename.c_str(), O_RDONLY);
+    if (fileDescriptor < 0)
+    {
+        return false;
+    }
+
+    struct stat fileStatus;
+    if (fstat(fileDescriptor, &fileStatus) == 0 && S_ISREG(fileStatus.st_mode))
+    {
+        m_Size = (size_t) fileStatus.st_size;
+
+        // mmap refuses empty mappings, but an empty file is still a valid (empty) shader
+        if (m_Size == 0)
+        {
+            close(fileDescriptor);
+            m_IsOpen = true;
+            return true;
+        }
+
+        void* data = mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+        if (data != MAP_FAILED)
+        {
+            // The tokenizer reads the file front to back exactly once
+            madvise(data, m_Size, MADV_SEQUENTIAL);
+            close(fileDescriptor);
+
+            m_Data = (const char*) data;
+            m_IsMapped = true;
+            m_IsOpen = true;
+            return true;
+        }
+
+        m_Size = 0;
+    }
+
+    // Not a regular file, or it couldn't be mapped: read it instead
+    close(fileDescriptor);
+#endif
+
+    FILE* file = fopen(filename.c_str(), "rb");
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    // The size is only a hint, the file might not be seekable
+    if (fseek(file, 0, SEEK_END) == 0)
+    {
+        long size = ftell(file);
+        if (size > 0)
+        {
+            m_Buffer.reserve((size_t) size);
+        }
+
+        fseek(file, 0, SEEK_SET);
+    }
+
+    char chunk[64 * 1024];
+    size_t numberOfBytesRead = 0;
+    while ((numberOfBytesRead = fread(chunk, 1, sizeof(chunk), file)) > 0)
+    {
+        m_Buffer.insert(m_Buffer.end(), chunk, chunk + numberOfBytesRead);
+    }
+
+    bool hasFailed = (ferror(file) != 0);
+    fclose(file);
+
+    if (hasFailed)
+    {
+        m_Buffer.clear();
+        return false;
+    }
+
+    m_Data = m_Buffer.data();
+    m_Size = m_Buffer.size();
+    m_IsOpen = true;
+    return true;
+}
+
+void MappedFile::Close()
+{
+#ifdef HLSL_TO_GLSL_HAS_MMAP
+    if (m_IsMapped)
+    {
+        munmap((void*) m_Data, m_Size);
+    }
+#endif
+
+    m_Buffer.clear();
+    m_Buffer.shrink_to_fit();
+
+    m_IsOpen = false;
+    m_Data = nullptr;
+    m_Size = 0;
+    m_IsMapped = false;
+}
+
+}
\ No newline at end of file
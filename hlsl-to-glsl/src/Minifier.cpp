@@ -0,0 +1,508 @@
+#include "Minifier.h"
+#include "OutputWriter.h"
+
+#include <algorithm>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+using namespace std;
+
+namespace HlslToGlsl
+{
+
+enum class GlslTokenKind_t
+{
+    WORD,           // Name, keyword or number, which two in a row need a space between them
+    PUNCTUATION,    // Any other character
+    DIRECTIVE       // Whole preprocessor line
+};
+
+struct GlslToken
+{
+    string_view m_Text;
+    GlslTokenKind_t m_Kind;
+    bool m_FollowsWhitespace;
+};
+
+// Parameters and body of a function, from its opened paranthesis to its closed curly bracket
+struct FunctionTokens
+{
+    size_t m_Begin;
+    size_t m_End;
+};
+
+bool IsWordCharacter(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+bool IsOperatorCharacter(char c)
+{
+    return string_view("+-*/%<>=!&|^").find(c) != string_view::npos;
+}
+
+bool IsIdentifier(const GlslToken& token)
+{
+    return token.m_Kind == GlslTokenKind_t::WORD && !(token.m_Text[0] >= '0' && token.m_Text[0] <= '9');
+}
+
+bool IsPunctuation(const GlslToken& token, char c)
+{
+    return token.m_Kind == GlslTokenKind_t::PUNCTUATION && token.m_Text[0] == c;
+}
+
+// Members and swizzles are never renamed
+bool FollowsDot(const pmr::vector<GlslToken>& tokens, size_t tokenIndex)
+{
+    return tokenIndex > 0 && IsPunctuation(tokens[tokenIndex - 1], '.');
+}
+
+// Comments and whitespace only mark that the next token follows whitespace
+pmr::vector<GlslToken> SplitGlslIntoTokens(string_view glsl, pmr::memory_resource* memoryResource)
+{
+    pmr::vector<GlslToken> tokens(memoryResource);
+    tokens.reserve(glsl.size() / 3);
+
+    bool followsWhitespace = false;
+    bool isStartOfLine = true;
+
+    for (size_t i = 0; i < glsl.size();)
+    {
+        const char c = glsl[i];
+
+        if (c == ' ' || c == '\t' || c == '\r' || c == '\n')
+        {
+            isStartOfLine = isStartOfLine || c == '\n';
+            followsWhitespace = true;
+            i += 1;
+            continue;
+        }
+
+        if (c == '/' && i + 1 < glsl.size() && (glsl[i + 1] == '/' || glsl[i + 1] == '*'))
+        {
+            const bool isLineComment = glsl[i + 1] == '/';
+            const size_t end = glsl.find(isLineComment ? "\n" : "*/", i + 2);
+
+            i = (end == string_view::npos) ? glsl.size() : (isLineComment ? end : end + 2);
+            followsWhitespace = true;
+            continue;
+        }
+
+        size_t end = i + 1;
+        GlslTokenKind_t kind = GlslTokenKind_t::PUNCTUATION;
+
+        if (c == '#' && isStartOfLine)
+        {
+            end = min(glsl.find('\n', i), glsl.size());
+            while (end > i && (glsl[end - 1] == ' ' || glsl[end - 1] == '\t' || glsl[end - 1] == '\r'))
+            {
+                end -= 1;
+            }
+
+            kind = GlslTokenKind_t::DIRECTIVE;
+        }
+        else if (IsWordCharacter(c))
+        {
+            while (end < glsl.size() && IsWordCharacter(glsl[end]))
+            {
+                end += 1;
+            }
+
+            kind = GlslTokenKind_t::WORD;
+        }
+
+        tokens.push_back(GlslToken{ glsl.substr(i, end - i), kind, followsWhitespace });
+
+        followsWhitespace = false;
+        isStartOfLine = false;
+        i = end;
+    }
+
+    return tokens;
+}
+
+// A function starts with the paranthesis before a curly bracket opened at the top level
+pmr::vector<FunctionTokens> FindFunctions(const pmr::vector<GlslToken>& tokens, pmr::memory_resource* memoryResource)
+{
+    pmr::vector<FunctionTokens> functions(memoryResource);
+
+    size_t curlyBracketDepth = 0;
+    size_t paranthesisDepth = 0;
+    size_t lastOpenedParanthesis = 0;
+
+    for (size_t i = 0; i < tokens.size(); i++)
+    {
+        const GlslToken& token = tokens[i];
+
+        if (token.m_Kind != GlslTokenKind_t::PUNCTUATION)
+        {
+            continue;
+        }
+
+        if (curlyBracketDepth == 0 && token.m_Text[0] == '(' && paranthesisDepth++ == 0)
+        {
+            lastOpenedParanthesis = i;
+        }
+        else if (curlyBracketDepth == 0 && token.m_Text[0] == ')' && paranthesisDepth > 0)
+        {
+            paranthesisDepth -= 1;
+        }
+        else if (token.m_Text[0] == '{')
+        {
+            if (curlyBracketDepth == 0 && i > 0 && IsPunctuation(tokens[i - 1], ')'))
+            {
+                functions.push_back(FunctionTokens{ lastOpenedParanthesis, tokens.size() });
+            }
+
+            curlyBracketDepth += 1;
+        }
+        else if (token.m_Text[0] == '}' && curlyBracketDepth > 0)
+        {
+            curlyBracketDepth -= 1;
+
+            if (curlyBracketDepth == 0 && !functions.empty() && functions.back().m_End == tokens.size())
+            {
+                functions.back().m_End = i + 1;
+            }
+        }
+    }
+
+    return functions;
+}
+
+bool IsGlslType(string_view name)
+{
+    static const unordered_set<string_view> types = {
+        "bool", "int", "uint", "float", "double",
+        "bvec2", "bvec3", "bvec4", "ivec2", "ivec3", "ivec4", "uvec2", "uvec3", "uvec4",
+        "vec2", "vec3", "vec4", "dvec2", "dvec3", "dvec4",
+        "mat2", "mat3", "mat4", "mat2x2", "mat2x3", "mat2x4", "mat3x2", "mat3x3", "mat3x4", "mat4x2", "mat4x3", "mat4x4",
+    };
+
+    return types.find(name) != types.end();
+}
+
+// Short names which are keywords, or builtin functions a local variable would hide
+bool IsReservedShortName(string_view name)
+{
+    static const unordered_set<string_view> names = {
+        "do", "if", "in", "for", "int", "out",
+        "abs", "all", "any", "asm", "cos", "dot", "exp", "fma", "log", "max", "min", "mix", "mod", "not", "pow", "sin", "tan",
+    };
+
+    return names.find(name) != names.end();
+}
+
+// Names of one, then two, then three characters, skipping those the shader already uses
+class ShortNameGenerator
+{
+public:
+    ShortNameGenerator(const pmr::unordered_set<string_view>& usedNames, pmr::deque<pmr::string>& names)
+        : m_UsedNames(usedNames)
+        , m_Names(names)
+    {
+    }
+
+    // Names are kept in a deque so that they don't move, as tokens point to them. The deque belongs to the caller,
+    // since the tokens are written once the generator is gone.
+    string_view GetName(size_t index)
+    {
+        while (m_Names.size() <= index)
+        {
+            string_view name = Generate(m_NextIndex++);
+            if (m_UsedNames.find(name) == m_UsedNames.end() && !IsReservedShortName(name))
+            {
+                m_Names.emplace_back(name);
+            }
+        }
+
+        return m_Names[index];
+    }
+
+private:
+    string_view Generate(size_t index)
+    {
+        static const char first[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+        static const char other[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+        const size_t numberOfFirst = sizeof(first) - 1;
+        const size_t numberOfOther = sizeof(other) - 1;
+
+        size_t length = 1;
+        for (size_t count = numberOfFirst; index >= count; count *= numberOfOther)
+        {
+            index -= count;
+            length += 1;
+        }
+
+        m_Buffer[0] = first[index % numberOfFirst];
+        index /= numberOfFirst;
+
+        for (size_t i = 1; i < length; i++)
+        {
+            m_Buffer[i] = other[index % numberOfOther];
+            index /= numberOfOther;
+        }
+
+        return string_view(m_Buffer, length);
+    }
+
+    const pmr::unordered_set<string_view>& m_UsedNames;
+    pmr::deque<pmr::string>& m_Names;
+    size_t m_NextIndex = 0;
+    char m_Buffer[16];
+};
+
+// The names a function declares: its parameters, and the variables following a type in its body, including the
+// ones after a comma in the same declaration
+void CollectLocalNames(const pmr::vector<GlslToken>& tokens, const FunctionTokens& function, const pmr::unordered_set<string_view>& structNames,
+                       pmr::vector<string_view>& localNames)
+{
+    size_t paranthesisDepth = 0;
+    size_t declarationDepth = SIZE_MAX;
+    bool expectsName = false;
+
+    for (size_t i = function.m_Begin; i < function.m_End; i++)
+    {
+        const GlslToken& token = tokens[i];
+
+        if (token.m_Kind == GlslTokenKind_t::PUNCTUATION)
+        {
+            const char c = token.m_Text[0];
+
+            if (c == '(' || c == '[')
+            {
+                paranthesisDepth += 1;
+            }
+            else if ((c == ')' || c == ']') && paranthesisDepth > 0)
+            {
+                paranthesisDepth -= 1;
+                declarationDepth = (paranthesisDepth < declarationDepth) ? SIZE_MAX : declarationDepth;
+            }
+            else if (c == ';' || c == '{' || c == '}')
+            {
+                declarationDepth = SIZE_MAX;
+            }
+            else if (c == ',' && paranthesisDepth == declarationDepth)
+            {
+                expectsName = true;
+                continue;
+            }
+
+            expectsName = false;
+            continue;
+        }
+
+        if (!IsIdentifier(token) || FollowsDot(tokens, i))
+        {
+            expectsName = false;
+            continue;
+        }
+
+        const GlslToken& previous = tokens[i - 1];
+        const bool followsType = previous.m_Kind == GlslTokenKind_t::WORD && (IsGlslType(previous.m_Text) || structNames.find(previous.m_Text) != structNames.end());
+
+        if (followsType || (expectsName && !IsGlslType(token.m_Text) && structNames.find(token.m_Text) == structNames.end()))
+        {
+            localNames.push_back(token.m_Text);
+            declarationDepth = paranthesisDepth;
+        }
+
+        expectsName = false;
+    }
+}
+
+// A macro replaces every word with its name, so no local is renamed to the name of a macro, nor to a name its body
+// uses. A local which already has the name of a macro is left as it is.
+void CollectDirectiveNames(string_view directive, pmr::unordered_set<string_view>& usedNames, pmr::unordered_set<string_view>& globalNames)
+{
+    size_t numberOfNames = 0;
+    bool isDefine = false;
+
+    for (size_t i = 1; i < directive.size();)
+    {
+        if (!IsWordCharacter(directive[i]))
+        {
+            i += 1;
+            continue;
+        }
+
+        size_t end = i + 1;
+        while (end < directive.size() && IsWordCharacter(directive[end]))
+        {
+            end += 1;
+        }
+
+        const string_view name = directive.substr(i, end - i);
+        i = end;
+
+        if (name[0] >= '0' && name[0] <= '9')
+        {
+            continue;
+        }
+
+        // The first name is the directive, the second one the name of the macro
+        isDefine = isDefine || (numberOfNames == 0 && name == "define");
+        if (isDefine && numberOfNames == 1)
+        {
+            globalNames.insert(name);
+        }
+
+        usedNames.insert(name);
+        numberOfNames += 1;
+    }
+}
+
+// The renamed tokens point to the new names, which are stored in shortNameStorage
+size_t RenameLocals(pmr::vector<GlslToken>& tokens, pmr::deque<pmr::string>& shortNameStorage, pmr::memory_resource* memoryResource)
+{
+    const pmr::vector<FunctionTokens> functions = FindFunctions(tokens, memoryResource);
+
+    // Every identifier outside of a function body is part of the interface or shared by several functions.
+    // Struct names are also types, and the names in directives belong to macros. Members and swizzles don't
+    // prevent a local from using the same name.
+    pmr::unordered_set<string_view> usedNames(memoryResource);
+    pmr::unordered_set<string_view> globalNames(memoryResource);
+    pmr::unordered_set<string_view> structNames(memoryResource);
+
+    size_t nextFunction = 0;
+    for (size_t i = 0; i < tokens.size(); i++)
+    {
+        if (nextFunction < functions.size() && i >= functions[nextFunction].m_End)
+        {
+            nextFunction += 1;
+        }
+
+        if (tokens[i].m_Kind == GlslTokenKind_t::DIRECTIVE)
+        {
+            CollectDirectiveNames(tokens[i].m_Text, usedNames, globalNames);
+            continue;
+        }
+
+        if (!IsIdentifier(tokens[i]) || FollowsDot(tokens, i))
+        {
+            continue;
+        }
+
+        usedNames.insert(tokens[i].m_Text);
+
+        if (nextFunction >= functions.size() || i < functions[nextFunction].m_Begin)
+        {
+            globalNames.insert(tokens[i].m_Text);
+        }
+
+        if (i > 0 && tokens[i - 1].m_Text == "struct")
+        {
+            structNames.insert(tokens[i].m_Text);
+        }
+    }
+
+    ShortNameGenerator shortNames(usedNames, shortNameStorage);
+    pmr::vector<string_view> localNames(memoryResource);
+    pmr::vector<pair<string_view, size_t>> uses(memoryResource);
+    pmr::unordered_map<string_view, size_t> useCounts(memoryResource);
+    pmr::unordered_map<string_view, string_view> renamedNames(memoryResource);
+
+    size_t numberOfRenamedIdentifiers = 0;
+
+    for (const FunctionTokens& function : functions)
+    {
+        localNames.clear();
+        CollectLocalNames(tokens, function, structNames, localNames);
+
+        // The most used names get the shortest replacements, ties keep the order of declaration
+        useCounts.clear();
+        uses.clear();
+        for (string_view name : localNames)
+        {
+            if (globalNames.find(name) == globalNames.end() && useCounts.emplace(name, 0).second)
+            {
+                uses.emplace_back(name, 0);
+            }
+        }
+
+        for (size_t i = function.m_Begin; i < function.m_End; i++)
+        {
+            auto it = useCounts.find(tokens[i].m_Text);
+            if (it != useCounts.end() && !FollowsDot(tokens, i))
+            {
+                it->second += 1;
+            }
+        }
+
+        for (pair<string_view, size_t>& use : uses)
+        {
+            use.second = useCounts[use.first];
+        }
+
+        stable_sort(uses.begin(), uses.end(), [](const pair<string_view, size_t>& a, const pair<string_view, size_t>& b) { return a.second > b.second; });
+
+        renamedNames.clear();
+        for (size_t i = 0; i < uses.size(); i++)
+        {
+            renamedNames.emplace(uses[i].first, shortNames.GetName(i));
+        }
+
+        for (size_t i = function.m_Begin; i < function.m_End; i++)
+        {
+            auto it = renamedNames.find(tokens[i].m_Text);
+            if (it != renamedNames.end() && IsIdentifier(tokens[i]) && !FollowsDot(tokens, i))
+            {
+                tokens[i].m_Text = it->second;
+            }
+        }
+
+        numberOfRenamedIdentifiers += uses.size();
+    }
+
+    return numberOfRenamedIdentifiers;
+}
+
+void MinifyGlsl(string_view glsl, bool renameLocals, pmr::string& output, MinificationStatistics* statistics, pmr::memory_resource* memoryResource)
+{
+    pmr::vector<GlslToken> tokens = SplitGlslIntoTokens(glsl, memoryResource);
+
+    pmr::deque<pmr::string> shortNames(memoryResource);
+    const size_t numberOfRenamedIdentifiers = renameLocals ? RenameLocals(tokens, shortNames, memoryResource) : 0;
+
+    const size_t originalSize = output.size();
+    OutputWriter writer(output);
+    writer.Reserve(glsl.size() / 2);
+
+    const GlslToken* previous = nullptr;
+    for (const GlslToken& token : tokens)
+    {
+        if (token.m_Kind == GlslTokenKind_t::DIRECTIVE)
+        {
+            if (previous != nullptr && previous->m_Kind != GlslTokenKind_t::DIRECTIVE)
+            {
+                writer.NewLine();
+            }
+
+            writer.Append(token.m_Text);
+            writer.NewLine();
+        }
+        else if (previous != nullptr && previous->m_Kind == token.m_Kind && previous->m_Kind != GlslTokenKind_t::DIRECTIVE &&
+                 (token.m_Kind == GlslTokenKind_t::WORD ||
+                  (token.m_FollowsWhitespace && IsOperatorCharacter(previous->m_Text.back()) && IsOperatorCharacter(token.m_Text[0]))))
+        {
+            writer.Append(" ", token.m_Text);
+        }
+        else
+        {
+            writer.Append(token.m_Text);
+        }
+
+        previous = &token;
+    }
+
+    if (statistics != nullptr)
+    {
+        statistics->m_OriginalSize += glsl.size();
+        statistics->m_MinifiedSize += output.size() - originalSize;
+        statistics->m_RenamedIdentifiers += numberOfRenamedIdentifiers;
+    }
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+#include "OutputWriter.h"
+
+#include <algorithm>
+
+namespace HlslToGlsl
+{
+
+void OutputWriter::Reserve(size_t capacity)
+{
+    m_Output.reserve(m_Output.size() + capacity);
+}
+
+void OutputWriter::AppendInteger(size_t value)
+{
+    // Enough digits for a 64 bits value, written from the end
+    char digits[20];
+    size_t start = sizeof(digits);
+
+    do
+    {
+        digits[--start] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+
+    Append(string_view(digits + start, sizeof(digits) - start));
+}
+
+void OutputWriter::NewLine()
+{
+    // An empty line doesn't get any indentation
+    m_Output.push_back('\n');
+    m_StartOfLine = true;
+}
+
+void OutputWriter::Unindent()
+{
+    if (m_IndentationLevel > 0)
+    {
+        m_IndentationLevel -= 1;
+    }
+}
+
+void OutputWriter::BeginAppend(size_t size)
+{
+    if (size == 0)
+    {
+        return;
+    }
+
+    const size_t indentationSize = m_StartOfLine ? m_Indentation.size() * m_IndentationLevel : 0;
+
+    // Grow at least geometrically, so that a long run of small appends past the reserved capacity stays cheap
+    const size_t requiredCapacity = m_Output.size() + indentationSize + size;
+    if (requiredCapacity > m_Output.capacity())
+    {
+        m_Output.reserve(max(requiredCapacity, m_Output.capacity() * 2));
+    }
+
+    if (m_StartOfLine)
+    {
+        m_StartOfLine = false;
+
+        for (size_t i = 0; i < m_IndentationLevel; i++)
+        {
+            m_Output.append(m_Indentation.data(), m_Indentation.size());
+        }
+    }
+}
+
+}
\ No newline at end of file
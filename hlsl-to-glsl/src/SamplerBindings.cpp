@@ -0,0 +1,47 @@
+#include "SamplerBindings.h"
+
+using namespace std;
+
+namespace HlslToGlsl
+{
+
+SamplerBindingTable::SamplerBindingTable(pmr::memory_resource* memoryResource)
+    : m_Bindings(memoryResource)
+{
+}
+
+uint32_t SamplerBindingTable::Allocate(string_view name, uint32_t samplerStateRegister, uint32_t textureRegister, uint32_t dimension)
+{
+    // A program only has a handful of combined samplers
+    for (const CombinedSamplerBinding& binding : m_Bindings)
+    {
+        if (binding.m_SamplerStateRegister == samplerStateRegister && binding.m_TextureRegister == textureRegister)
+        {
+            return binding.m_Binding;
+        }
+    }
+
+    const uint32_t unit = (uint32_t) m_Bindings.size();
+    m_Bindings.push_back(CombinedSamplerBinding{ pmr::string(name, m_Bindings.get_allocator().resource()), unit, samplerStateRegister, textureRegister, dimension });
+
+    return unit;
+}
+
+void SamplerBindingTable::WriteMetadata(string& output) const
+{
+    for (const CombinedSamplerBinding& binding : m_Bindings)
+    {
+        output += to_string(binding.m_Binding);
+        output += ' ';
+        output += binding.m_Name;
+        output += " s";
+        output += to_string(binding.m_SamplerStateRegister);
+        output += " t";
+        output += to_string(binding.m_TextureRegister);
+        output += ' ';
+        output += to_string(binding.m_Dimension);
+        output += "D\n";
+    }
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+#include "SymbolTable.h"
+
+#include <mutex>
+
+namespace HlslToGlsl
+{
+
+SymbolTable::SymbolTable(bool isShared, pmr::memory_resource* memoryResource)
+    : m_Names(memoryResource)
+    , m_SymbolIds(memoryResource)
+    , m_IsShared(isShared)
+{
+}
+
+SymbolId_t SymbolTable::Intern(string_view name)
+{
+    if (!m_IsShared)
+    {
+        return InternLocked(name);
+    }
+
+    // Most names of a shader were already interned by another conversion, so try under the shared lock first
+    {
+        shared_lock<shared_mutex> lock(m_Mutex);
+
+        const SymbolId_t symbolId = FindLocked(name);
+        if (symbolId != INVALID_SYMBOL_ID)
+        {
+            return symbolId;
+        }
+    }
+
+    unique_lock<shared_mutex> lock(m_Mutex);
+    return InternLocked(name);
+}
+
+SymbolId_t SymbolTable::Find(string_view name) const
+{
+    shared_lock<shared_mutex> lock(m_Mutex, defer_lock);
+    if (m_IsShared)
+    {
+        lock.lock();
+    }
+
+    return FindLocked(name);
+}
+
+string_view SymbolTable::GetName(SymbolId_t symbolId) const
+{
+    shared_lock<shared_mutex> lock(m_Mutex, defer_lock);
+    if (m_IsShared)
+    {
+        lock.lock();
+    }
+
+    return m_Names[symbolId];
+}
+
+size_t SymbolTable::size() const
+{
+    shared_lock<shared_mutex> lock(m_Mutex, defer_lock);
+    if (m_IsShared)
+    {
+        lock.lock();
+    }
+
+    return m_Names.size();
+}
+
+SymbolId_t SymbolTable::InternLocked(string_view name)
+{
+    // Another thread may have added it since the lookup under the shared lock
+    SymbolId_t symbolId = FindLocked(name);
+    if (symbolId != INVALID_SYMBOL_ID)
+    {
+        return symbolId;
+    }
+
+    symbolId = (SymbolId_t) m_Names.size();
+    m_Names.emplace_back(name);
+    m_SymbolIds.emplace(m_Names.back(), symbolId);
+
+    return symbolId;
+}
+
+SymbolId_t SymbolTable::FindLocked(string_view name) const
+{
+    auto it = m_SymbolIds.find(name);
+    return (it != m_SymbolIds.end()) ? it->second : INVALID_SYMBOL_ID;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,236 @@
+#include "SyntaxTree.h"
+
+using namespace std;
+
+namespace HlslToGlsl
+{
+
+SyntaxTree::SyntaxTree(pmr::memory_resource* memoryResource)
+    : m_MatchingBrackets(memoryResource)
+    , m_Nodes(memoryResource)
+    , m_NodeKinds(memoryResource)
+    , m_Calls(memoryResource)
+    , m_Arguments(memoryResource)
+    , m_Declarations(memoryResource)
+    , m_Functions(memoryResource)
+{
+}
+
+const CallNode* SyntaxTree::FindCall(size_t functionLexemeIndex) const
+{
+    if (functionLexemeIndex + 1 >= m_MatchingBrackets.size())
+    {
+        return nullptr;
+    }
+
+    // The call is recorded at its opened paranthesis, which directly follows the function name. Any other node
+    // there, such as the declaration of a keyword, isn't a call.
+    uint32_t node = m_Nodes[functionLexemeIndex + 1];
+    if (m_NodeKinds[functionLexemeIndex + 1] != NODE_CALL || m_Calls[node].m_Function != functionLexemeIndex)
+    {
+        return nullptr;
+    }
+
+    return &m_Calls[node];
+}
+
+const DeclarationNode* SyntaxTree::FindDeclaration(size_t keywordLexemeIndex) const
+{
+    if (keywordLexemeIndex >= m_Nodes.size())
+    {
+        return nullptr;
+    }
+
+    uint32_t node = m_Nodes[keywordLexemeIndex];
+    if (m_NodeKinds[keywordLexemeIndex] != NODE_DECLARATION || m_Declarations[node].m_Keyword != keywordLexemeIndex)
+    {
+        return nullptr;
+    }
+
+    return &m_Declarations[node];
+}
+
+bool IsOpenedBracket(TokenClass_t tokenClass)
+{
+    return tokenClass == OPENED_PARANTHESIS || tokenClass == OPENED_CURLY_BRACKET || tokenClass == OPENED_ANGLE_BRACKET;
+}
+
+bool IsClosedBracket(TokenClass_t tokenClass)
+{
+    return tokenClass == CLOSED_PARANTHESIS || tokenClass == CLOSED_CURLY_BRACKET || tokenClass == CLOSED_ANGLE_BRACKET;
+}
+
+TokenClass_t GetOpenedBracket(TokenClass_t closedBracket)
+{
+    switch (closedBracket)
+    {
+    case CLOSED_PARANTHESIS:
+        return OPENED_PARANTHESIS;
+    case CLOSED_CURLY_BRACKET:
+        return OPENED_CURLY_BRACKET;
+    default:
+        return OPENED_ANGLE_BRACKET;
+    }
+}
+
+bool IsCallable(TokenClass_t tokenClass)
+{
+    return tokenClass == VARIABLE_NAME || tokenClass == BUILTIN_FUNCTION || tokenClass == TYPE;
+}
+
+// The signature of a function definition is the call right before its body, possibly followed by a semantic
+uint32_t FindSignatureBeforeBody(const LexemeStream& lexemes, const SyntaxTree& syntaxTree, size_t openedCurlyBracket)
+{
+    if (openedCurlyBracket == 0)
+    {
+        return INVALID_NODE_INDEX;
+    }
+
+    size_t closedParanthesis = openedCurlyBracket - 1;
+    if (closedParanthesis >= 2 && lexemes.GetTokenClass(closedParanthesis) == VARIABLE_NAME && lexemes.GetTokenClass(closedParanthesis - 1) == COLON)
+    {
+        closedParanthesis -= 2;
+    }
+
+    if (lexemes.GetTokenClass(closedParanthesis) != CLOSED_PARANTHESIS)
+    {
+        return INVALID_NODE_INDEX;
+    }
+
+    LexemeIndex_t openedParanthesis = syntaxTree.GetMatchingBracket(closedParanthesis);
+    if (openedParanthesis == INVALID_LEXEME_INDEX || syntaxTree.m_NodeKinds[openedParanthesis] != NODE_CALL)
+    {
+        return INVALID_NODE_INDEX;
+    }
+
+    return syntaxTree.m_Nodes[openedParanthesis];
+}
+
+SyntaxTree ParseSyntaxTree(const LexemeStream& lexemes, pmr::memory_resource* memoryResource)
+{
+    SyntaxTree syntaxTree(memoryResource);
+    syntaxTree.m_MatchingBrackets.assign(lexemes.size(), INVALID_LEXEME_INDEX);
+    syntaxTree.m_Nodes.assign(lexemes.size(), INVALID_NODE_INDEX);
+    syntaxTree.m_NodeKinds.assign(lexemes.size(), NODE_NONE);
+
+    struct OpenedBracket
+    {
+        LexemeIndex_t m_Lexeme;
+        uint32_t m_Call;
+        LexemeIndex_t m_ArgumentBegin;
+        size_t m_FirstPendingArgument;
+    };
+
+    // Arguments of the calls still open. Inner calls close first, so the arguments of each call stay consecutive.
+    pmr::vector<OpenedBracket> openedBrackets(memoryResource);
+    pmr::vector<LexemeRange> pendingArguments(memoryResource);
+
+    uint32_t declaration = INVALID_NODE_INDEX;
+    uint32_t function = INVALID_NODE_INDEX;
+
+    for (size_t i = 0; i < lexemes.size(); i++)
+    {
+        TokenClass_t tokenClass = lexemes.GetTokenClass(i);
+        LexemeIndex_t lexemeIndex = (LexemeIndex_t) i;
+
+        if (tokenClass == CBUFFER || tokenClass == TEXTURE || tokenClass == SAMPLER_STATE)
+        {
+            declaration = (uint32_t) syntaxTree.m_Declarations.size();
+            syntaxTree.m_Declarations.push_back(DeclarationNode{ lexemeIndex, INVALID_LEXEME_INDEX, INVALID_LEXEME_INDEX, INVALID_LEXEME_INDEX });
+            syntaxTree.m_Nodes[i] = declaration;
+            syntaxTree.m_NodeKinds[i] = NODE_DECLARATION;
+        }
+        else if (declaration != INVALID_NODE_INDEX)
+        {
+            DeclarationNode& node = syntaxTree.m_Declarations[declaration];
+            if (tokenClass == VARIABLE_NAME && node.m_Name == INVALID_LEXEME_INDEX)
+            {
+                node.m_Name = lexemeIndex;
+            }
+            else if (tokenClass == REGISTER && i + 2 < lexemes.size() && lexemes.GetTokenClass(i + 1) == OPENED_PARANTHESIS)
+            {
+                node.m_Register = lexemeIndex + 2;
+            }
+            else if (tokenClass == SEMICOLUMN || tokenClass == OPENED_CURLY_BRACKET)
+            {
+                node.m_End = tokenClass == SEMICOLUMN ? lexemeIndex : lexemeIndex - 1;
+                declaration = INVALID_NODE_INDEX;
+            }
+        }
+
+        if (IsOpenedBracket(tokenClass))
+        {
+            uint32_t call = INVALID_NODE_INDEX;
+            if (tokenClass == OPENED_PARANTHESIS && i > 0 && IsCallable(lexemes.GetTokenClass(i - 1)))
+            {
+                call = (uint32_t) syntaxTree.m_Calls.size();
+                syntaxTree.m_Calls.push_back(CallNode{ lexemeIndex - 1, lexemeIndex, INVALID_LEXEME_INDEX, 0, 0, INVALID_NODE_INDEX });
+                syntaxTree.m_Nodes[i] = call;
+                syntaxTree.m_NodeKinds[i] = NODE_CALL;
+            }
+            else if (tokenClass == OPENED_CURLY_BRACKET && openedBrackets.empty())
+            {
+                uint32_t signature = FindSignatureBeforeBody(lexemes, syntaxTree, i);
+                if (signature != INVALID_NODE_INDEX)
+                {
+                    function = (uint32_t) syntaxTree.m_Functions.size();
+                    CallNode& signatureCall = syntaxTree.m_Calls[signature];
+                    signatureCall.m_FunctionDefinition = function;
+
+                    LexemeIndex_t returnType = signatureCall.m_Function > 0 ? signatureCall.m_Function - 1 : INVALID_LEXEME_INDEX;
+                    syntaxTree.m_Functions.push_back(FunctionNode{ returnType, signature, lexemeIndex, INVALID_LEXEME_INDEX, (uint32_t) syntaxTree.m_Calls.size(), 0 });
+                }
+            }
+
+            openedBrackets.push_back(OpenedBracket{ lexemeIndex, call, lexemeIndex + 1, pendingArguments.size() });
+        }
+        else if (tokenClass == COMMA && !openedBrackets.empty() && openedBrackets.back().m_Call != INVALID_NODE_INDEX)
+        {
+            pendingArguments.push_back(LexemeRange{ openedBrackets.back().m_ArgumentBegin, lexemeIndex });
+            openedBrackets.back().m_ArgumentBegin = lexemeIndex + 1;
+        }
+        else if (IsClosedBracket(tokenClass))
+        {
+            // Unbalanced brackets are left unmatched
+            if (openedBrackets.empty() || lexemes.GetTokenClass(openedBrackets.back().m_Lexeme) != GetOpenedBracket(tokenClass))
+            {
+                continue;
+            }
+
+            OpenedBracket openedBracket = openedBrackets.back();
+            openedBrackets.pop_back();
+
+            syntaxTree.m_MatchingBrackets[openedBracket.m_Lexeme] = lexemeIndex;
+            syntaxTree.m_MatchingBrackets[i] = openedBracket.m_Lexeme;
+
+            if (openedBracket.m_Call != INVALID_NODE_INDEX)
+            {
+                // f() has no arguments, but f(a, ) still has an empty second one
+                if (openedBracket.m_ArgumentBegin < lexemeIndex || pendingArguments.size() > openedBracket.m_FirstPendingArgument)
+                {
+                    pendingArguments.push_back(LexemeRange{ openedBracket.m_ArgumentBegin, lexemeIndex });
+                }
+
+                CallNode& call = syntaxTree.m_Calls[openedBracket.m_Call];
+                call.m_ClosedParanthesis = lexemeIndex;
+                call.m_FirstArgument = (uint32_t) syntaxTree.m_Arguments.size();
+                call.m_NumberOfArguments = (uint32_t) (pendingArguments.size() - openedBracket.m_FirstPendingArgument);
+
+                syntaxTree.m_Arguments.insert(syntaxTree.m_Arguments.end(), pendingArguments.begin() + openedBracket.m_FirstPendingArgument, pendingArguments.end());
+                pendingArguments.resize(openedBracket.m_FirstPendingArgument);
+            }
+
+            if (tokenClass == CLOSED_CURLY_BRACKET && openedBrackets.empty() && function != INVALID_NODE_INDEX)
+            {
+                FunctionNode& node = syntaxTree.m_Functions[function];
+                node.m_ClosedCurlyBracket = lexemeIndex;
+                node.m_NumberOfCalls = (uint32_t) syntaxTree.m_Calls.size() - node.m_FirstCall;
+                function = INVALID_NODE_INDEX;
+            }
+        }
+    }
+
+    return syntaxTree;
+}
+
+}
\ No newline at end of file
@@ -1,509 +1,314 @@
 #include "Tokenizer.h"
 
-#include <algorithm>
-
 namespace HlslToGlsl
 {
 
-string hlslTypes[] = {
-    "bool",
-    "int",
-    "uint",
-    "dword",
-    "half",
-    "float",
-    "double",
-
-    "bool1",
-    "bool2",
-    "bool3",
-    "bool4",
-
-    "int1",
-    "int2",
-    "int3",
-    "int4",
-
-    "uint1",
-    "uint2",
-    "uint3",
-    "uint4",
-
-    "half1",
-    "half2",
-    "half3",
-    "half4",
-
-    "float1",
-    "float2",
-    "float3",
-    "float4",
-
-    "double1",
-    "double2",
-    "double3",
-    "double4",
-
-    "float2x2",
-    "float3x3",
-    "float4x4"
+// Character classes driving the lexer. Every byte of the input maps to exactly one class
+enum CharacterClass_t
+{
+    CC_WHITESPACE,      // Separates lexemes and is otherwise dropped
+    CC_IDENTIFIER,      // Letters, underscore and anything not otherwise recognized
+    CC_DIGIT,
+    CC_DOT,             // Structure operator, or the start of a number such as .5
+    CC_SLASH,           // Division, or the start of a comment
+    CC_PUNCTUATOR,      // Always a lexeme on its own: ( ) [ ] { } ; , : ? ~
+    CC_OPERATOR,        // Might be combined with the next character: + - * % = < > ! & | ^
 };
 
-string hlslFunctions[] = {
-    "abs",
-    "acos",
-    "all",
-    "any",
-    "asin",
-    "atan",
-    "atan2",
-    "ceil",
-    "clamp",
-    "clip",
-    "cos",
-    "cosh",
-    "cross",
-    "ddx",
-    "ddx_coarse",
-    "ddx_fine",
-    "ddy",
-    "ddy_coarse",
-    "ddy_fine",
-    "degrees",
-    "determinant",
-    "distance",
-    "dot",
-    "exp",
-    "exp2",
-    "faceforward",
-    "floor",
-    "fma",
-    "fmod",
-    "frac",
-    "frexp",
-    "fwidth",
-    "isfinite",
-    "isinf",
-    "isnan",
-    "ldexp",
-    "length",
-    "lerp",
-    "log",
-    "log10",
-    "log2",
-    "max",
-    "min",
-    "modf",
-    "mul",
-    "noise",
-    "normalize",
-    "pow",
-    "radians",
-    "rcp",
-    "reflect",
-    "refract",
-    "reversebits",
-    "rsqrt",
-    "saturate",
-    "sign",
-    "sin",
-    "sinh",
-    "smoothstep",
-    "sqrt",
-    "step",
-    "tan",
-    "tanh",
-    "tex1D",
-    "tex1Dbias",
-    "tex1Dgrad",
-    "tex1Dlod",
-    "tex1Dproj",
-    "tex2D",
-    "tex2Dbias",
-    "tex2Dgrad",
-    "tex2Dlod",
-    "tex2Dproj",
-    "tex3D",
-    "tex3Dbias",
-    "tex3Dgrad",
-    "tex3Dlod",
-    "tex3Dproj",
-    "texCUBE",
-    "texCUBEbias",
-    "texCUBEgrad",
-    "texCUBElod",
-    "texCUBEproj",
-    "transpose",
-    "trunc"
+#define W CC_WHITESPACE
+#define I CC_IDENTIFIER
+#define D CC_DIGIT
+#define T CC_DOT
+#define S CC_SLASH
+#define P CC_PUNCTUATOR
+#define O CC_OPERATOR
+
+const unsigned char characterClasses[256] = {
+//  0  1  2  3  4  5  6  7  8  9  A  B  C  D  E  F
+    W, W, W, W, W, W, W, W, W, W, W, W, W, W, W, W, // 0x00
+    W, W, W, W, W, W, W, W, W, W, W, W, W, W, W, W, // 0x10
+    W, O, I, I, I, O, O, I, P, P, O, O, P, O, T, S, // 0x20  !"#$%&'()*+,-./
+    D, D, D, D, D, D, D, D, D, D, P, P, O, O, O, P, // 0x30 0123456789:;<=>?
+    I, I, I, I, I, I, I, I, I, I, I, I, I, I, I, I, // 0x40 @A-O
+    I, I, I, I, I, I, I, I, I, I, I, P, I, P, O, I, // 0x50 P-Z[\]^_
+    I, I, I, I, I, I, I, I, I, I, I, I, I, I, I, I, // 0x60 `a-o
+    I, I, I, I, I, I, I, I, I, I, I, P, O, P, P, W, // 0x70 p-z{|}~
+    I, I, I, I, I, I, I, I, I, I, I, I, I, I, I, I, // 0x80
+    I, I, I, I, I, I, I, I, I, I, I, I, I, I, I, I, // 0x90
+    I, I, I, I, I, I, I, I, I, I, I, I, I, I, I, I, // 0xA0
+    I, I, I, I, I, I, I, I, I, I, I, I, I, I, I, I, // 0xB0
+    I, I, I, I, I, I, I, I, I, I, I, I, I, I, I, I, // 0xC0
+    I, I, I, I, I, I, I, I, I, I, I, I, I, I, I, I, // 0xD0
+    I, I, I, I, I, I, I, I, I, I, I, I, I, I, I, I, // 0xE0
+    I, I, I, I, I, I, I, I, I, I, I, I, I, I, I, I, // 0xF0
 };
 
-string hlslFlowControl[] = {
-    "break",
-    "continue",
-    "discard",
-    "do",
-    "for",
-    "if",
-    "switch",
-    "case",
-    "while",
-    "return",
-    "else",
-    "const",
-};
+#undef W
+#undef I
+#undef D
+#undef T
+#undef S
+#undef P
+#undef O
 
-string keywordsToIgnore[] = {
-    "static"
-};
+inline CharacterClass_t GetCharacterClass(char c)
+{
+    return (CharacterClass_t) characterClasses[(unsigned char) c];
+}
+
+size_t ScanOperator(string_view input, size_t position);
+TokenClass_t ClassifyPunctuation(string_view token);
+TokenClass_t ClassifyWord(KeywordId_t keywordId, string_view input, size_t end);
+
+LexemeStream::LexemeStream(string_view source, SymbolTable& symbolTable, pmr::memory_resource* memoryResource)
+    : m_Source(source)
+    , m_SymbolTable(&symbolTable)
+    , m_TokenClasses(memoryResource)
+    , m_Spans(memoryResource)
+    , m_KeywordIds(memoryResource)
+    , m_SymbolIds(memoryResource)
+{
+}
 
-bool IsHlslType(const string& token);
-bool IsHlslFunction(const string& token);
-bool IsHlslFlowControl(const string& token);
-bool IsKeywordToIgnore(const string& token);
-vector<string> Strip(const string& input);
-void SeparateAdditionalTokens(const vector<char>& tokensToSeparate, vector<string>& tokens);
+void LexemeStream::Reserve(size_t numberOfLexemes)
+{
+    m_TokenClasses.reserve(numberOfLexemes);
+    m_Spans.reserve(numberOfLexemes);
+    m_KeywordIds.reserve(numberOfLexemes);
+    m_SymbolIds.reserve(numberOfLexemes);
+}
+
+void LexemeStream::Add(TokenClass_t tokenClass, size_t offset, size_t length, KeywordId_t keywordId, SymbolId_t symbolId)
+{
+    m_TokenClasses.push_back((uint8_t) tokenClass);
+    m_Spans.push_back(Span{ (uint32_t) offset, (uint32_t) length });
+    m_KeywordIds.push_back(keywordId);
+    m_SymbolIds.push_back(symbolId);
+}
 
-vector<Lexeme> ParseIntoLexemes(const string& input)
+LexemeStream ParseIntoLexemes(string_view input, SymbolTable& symbolTable, pmr::memory_resource* memoryResource)
 {
-    vector<Lexeme> lexemes;
-    
-    vector<char> tokensToSeparate;
-    tokensToSeparate.push_back('(');
-    tokensToSeparate.push_back(')');
-    tokensToSeparate.push_back('[');
-    tokensToSeparate.push_back(']');
-    tokensToSeparate.push_back('{');
-    tokensToSeparate.push_back('}');
-    tokensToSeparate.push_back(';');
-    tokensToSeparate.push_back('+');
-    tokensToSeparate.push_back('-');
-    tokensToSeparate.push_back('*');
-    tokensToSeparate.push_back('/');
-    tokensToSeparate.push_back('=');
-    tokensToSeparate.push_back('>');
-    tokensToSeparate.push_back('<');
-    tokensToSeparate.push_back(',');
-    tokensToSeparate.push_back('!');
-    tokensToSeparate.push_back('.');
-    tokensToSeparate.push_back('%');
-    tokensToSeparate.push_back('~');
-    tokensToSeparate.push_back('&');
-    tokensToSeparate.push_back('|');
-    tokensToSeparate.push_back('^');
-    tokensToSeparate.push_back('?');
-
-    vector<string> tokens = Strip(input);
-    SeparateAdditionalTokens(tokensToSeparate, tokens);
-
-    for (size_t i = 0; i < tokens.size(); i++)
+    LexemeStream lexemes(input, symbolTable, memoryResource);
+
+    // Shaders average close to 4 characters per lexeme once whitespace is counted, so this is
+    // enough for the arrays to be allocated once
+    lexemes.Reserve(input.size() / 3 + 16);
+
+    // Single pass over the input: each iteration skips whitespace, then consumes exactly one lexeme
+    const size_t length = input.size();
+    size_t position = 0;
+
+    while (position < length)
     {
-        Lexeme lexeme;
-        lexeme.m_Token = tokens[i];
+        const size_t start = position;
+        const CharacterClass_t characterClass = GetCharacterClass(input[position]);
 
-        // Make sure there are no null characters at the end
-        while (lexeme.m_Token.back() == '\0')
-        {
-            lexeme.m_Token.pop_back();
-        }
+        TokenClass_t tokenClass = TokenClass_t::VARIABLE_NAME;
+        KeywordId_t keywordId = INVALID_KEYWORD_ID;
+        SymbolId_t symbolId = INVALID_SYMBOL_ID;
 
-        if (IsKeywordToIgnore(lexeme.m_Token))
+        switch (characterClass)
         {
+        case CC_WHITESPACE:
+            position += 1;
             continue;
-        }
 
-        if (lexeme.m_Token.substr(0, 2) == "//")
-        {
-            lexeme.m_TokenClass = TokenClass_t::COMMENT;
-        }
-        else if (IsHlslType(lexeme.m_Token))
-        {
-            lexeme.m_TokenClass = TokenClass_t::TYPE;
-        }
-        else if (IsHlslFunction(lexeme.m_Token))
-        {
-            // Must make sure that next lexeme is a paranthesis, otherwise it does't count
-            if (tokens[i + 1] == "(")
+        case CC_IDENTIFIER:
+            do
+            {
+                position += 1;
+            } while (position < length && (GetCharacterClass(input[position]) == CC_IDENTIFIER || GetCharacterClass(input[position]) == CC_DIGIT));
+
+            keywordId = FindKeyword(input.substr(start, position - start));
+            if (keywordId != INVALID_KEYWORD_ID && GetKeyword(keywordId).m_Class == KeywordClass_t::KEYWORD_TO_IGNORE)
             {
-                lexeme.m_TokenClass = TokenClass_t::BUILTIN_FUNCTION;
+                continue;
             }
-            else
+
+            tokenClass = ClassifyWord(keywordId, input, position);
+
+            // Names, including builtin function names used as variables, are compared by symbol from here on
+            if (tokenClass == TokenClass_t::VARIABLE_NAME)
             {
-                lexeme.m_TokenClass = TokenClass_t::VARIABLE_NAME;
+                symbolId = symbolTable.Intern(input.substr(start, position - start));
             }
-        }
-        else if (IsHlslFlowControl(lexeme.m_Token))
-        {
-            lexeme.m_TokenClass = TokenClass_t::FLOW_CONTROL;
-        }
-        else if (lexeme.m_Token == "cbuffer")
-        {
-            lexeme.m_TokenClass = TokenClass_t::CBUFFER;
-        }
-        else if (lexeme.m_Token == "register")
-        {
-            lexeme.m_TokenClass = TokenClass_t::REGISTER;
-        }
-        else if (lexeme.m_Token == "struct")
-        {
-            lexeme.m_TokenClass = TokenClass_t::STRUCT;
-        }
-        else if (lexeme.m_Token == "SamplerState")
-        {
-            lexeme.m_TokenClass = TokenClass_t::SAMPLER_STATE;
-        }
-        else if (lexeme.m_Token == "Texture1D" || lexeme.m_Token == "Texture2D" || lexeme.m_Token == "Texture3D")
-        {
-            lexeme.m_TokenClass = TokenClass_t::TEXTURE;
-        }
-        else if (lexeme.m_Token == "(")
-        {
-            lexeme.m_TokenClass = TokenClass_t::OPENED_PARANTHESIS;
-        }
-        else if (lexeme.m_Token == ")")
-        {
-            lexeme.m_TokenClass = TokenClass_t::CLOSED_PARANTHESIS;
-        }
-        else if (lexeme.m_Token == "[")
-        {
-            lexeme.m_TokenClass = TokenClass_t::OPENED_ANGLE_BRACKET;
-        }
-        else if (lexeme.m_Token == "]")
-        {
-            lexeme.m_TokenClass = TokenClass_t::CLOSED_ANGLE_BRACKET;
-        }
-        else if (lexeme.m_Token == "{")
-        {
-            lexeme.m_TokenClass = TokenClass_t::OPENED_CURLY_BRACKET;
-        }
-        else if (lexeme.m_Token == "}")
-        {
-            lexeme.m_TokenClass = TokenClass_t::CLOSED_CURLY_BRACKET;
-        }
-        else if (lexeme.m_Token == "=")
-        {
-            lexeme.m_TokenClass = TokenClass_t::ASSIGNATION;
-        }
-        else if (lexeme.m_Token == "+" || lexeme.m_Token == "-" || lexeme.m_Token == "*" || lexeme.m_Token == "/" || lexeme.m_Token == "%")
-        {
-            lexeme.m_TokenClass = TokenClass_t::ARITHMETIC_OPERATOR;
-        }
-        else if (lexeme.m_Token == ">" || lexeme.m_Token == "<" || lexeme.m_Token == ">=" || lexeme.m_Token == "<=" || lexeme.m_Token == "!")
-        {
-            lexeme.m_TokenClass = TokenClass_t::RELATIONAL_OPERATOR;
-        }
-        else if (lexeme.m_Token == ",")
-        {
-            lexeme.m_TokenClass = TokenClass_t::COMMA;
-        }
-        else if (lexeme.m_Token == ";")
-        {
-            lexeme.m_TokenClass = TokenClass_t::SEMICOLUMN;
-        }
-        else if (lexeme.m_Token == ":")
-        {
-            lexeme.m_TokenClass = TokenClass_t::COLON;
-        }
-        else if (lexeme.m_Token == ".")
-        {
-            lexeme.m_TokenClass = TokenClass_t::STRUCTURE_OPERATOR;
-        }
-        else if (lexeme.m_Token == "~" || lexeme.m_Token == "&" || lexeme.m_Token == "|" || lexeme.m_Token == "^")
-        {
-            lexeme.m_TokenClass = TokenClass_t::BITWISE_OPERATOR;
-        }
-        else if (lexeme.m_Token == "?")
-        {
-            lexeme.m_TokenClass = TokenClass_t::TERNARY_OPERATOR;
-        }
-        else
-        {
-            lexeme.m_TokenClass = TokenClass_t::VARIABLE_NAME;
-        }
+            break;
 
-        lexemes.push_back(lexeme);
-    }
+        case CC_DOT:
+            if (position + 1 >= length || GetCharacterClass(input[position + 1]) != CC_DIGIT)
+            {
+                position += 1;
+                tokenClass = TokenClass_t::STRUCTURE_OPERATOR;
+                break;
+            }
 
-    return lexemes;
-}
+            // Fall through: number such as .5
+        case CC_DIGIT:
+            // Numbers keep their fractional part, exponent and suffix, i.e. 1.0f, 2e-3 or 0xFF
+            do
+            {
+                const char previous = input[position];
+                position += 1;
 
-bool IsHlslType(const string& token)
-{
-    const size_t numberOfHlslTypes = _countof(hlslTypes);
+                if (position < length && (input[position] == '+' || input[position] == '-') && (previous == 'e' || previous == 'E') &&
+                    !(input[start] == '0' && start + 1 < length && (input[start + 1] == 'x' || input[start + 1] == 'X')))
+                {
+                    position += 1;
+                }
+            } while (position < length && GetCharacterClass(input[position]) <= CC_DOT && GetCharacterClass(input[position]) != CC_WHITESPACE);
 
-    for (size_t i = 0; i < numberOfHlslTypes; i++)
-    {
-        if (token == hlslTypes[i])
-        {
-            return true;
-        }
-    }
+            tokenClass = TokenClass_t::VARIABLE_NAME;
+            break;
 
-    return false;
-}
+        case CC_SLASH:
+            if (position + 1 < length && input[position + 1] == '/')
+            {
+                // Comments run until the end of the line and are kept as a single lexeme
+                position = input.find('\n', position);
+                if (position == string_view::npos)
+                {
+                    position = length;
+                }
+
+                // Don't keep the carriage return of files using Windows line endings
+                size_t end = position;
+                while (end > start && GetCharacterClass(input[end - 1]) == CC_WHITESPACE)
+                {
+                    end -= 1;
+                }
+
+                lexemes.Add(TokenClass_t::COMMENT, start, end - start);
+                continue;
+            }
 
-bool IsHlslFunction(const string& token)
-{
-    const size_t numberOfHlslFunctions = _countof(hlslFunctions);
+            position = ScanOperator(input, position);
+            tokenClass = ClassifyPunctuation(input.substr(start, position - start));
+            break;
 
-    for (size_t i = 0; i < numberOfHlslFunctions; i++)
-    {
-        if (token == hlslFunctions[i])
-        {
-            return true;
+        case CC_PUNCTUATOR:
+            position += 1;
+            tokenClass = ClassifyPunctuation(input.substr(start, 1));
+            break;
+
+        case CC_OPERATOR:
+            position = ScanOperator(input, position);
+            tokenClass = ClassifyPunctuation(input.substr(start, position - start));
+            break;
         }
+
+        lexemes.Add(tokenClass, start, position - start, keywordId, symbolId);
     }
 
-    return false;
+    return lexemes;
 }
 
-bool IsHlslFlowControl(const string& token)
+size_t ScanOperator(string_view input, size_t position)
 {
-    const size_t numberOfHlslFlowControl = _countof(hlslFlowControl);
+    // Longest match between the single character operator and its compound forms:
+    // op=, ++, --, &&, ||, <<, >>, <<= and >>=
+    const char c = input[position];
+    position += 1;
 
-    for (size_t i = 0; i < numberOfHlslFlowControl; i++)
+    if (position >= input.size())
     {
-        if (token == hlslFlowControl[i])
-        {
-            return true;
-        }
+        return position;
     }
 
-    return false;
-}
-
-bool IsKeywordToIgnore(const string& token)
-{
-    const size_t numberOfKeywords = _countof(keywordsToIgnore);
+    const char next = input[position];
+    if (next == '=')
+    {
+        return position + 1;
+    }
 
-    for (size_t i = 0; i < numberOfKeywords; i++)
+    if (next == c && (c == '+' || c == '-' || c == '&' || c == '|' || c == '<' || c == '>'))
     {
-        if (token == keywordsToIgnore[i])
+        position += 1;
+
+        if ((c == '<' || c == '>') && position < input.size() && input[position] == '=')
         {
-            return true;
+            position += 1;
         }
     }
 
-    return false;
+    return position;
 }
 
-vector<string> Strip(const string& input)
+TokenClass_t ClassifyPunctuation(string_view token)
 {
-    vector<string> tokens;
-
-    vector<char> delims;
-    delims.push_back(' ');
-    delims.push_back('\n');
-    delims.push_back('\t');
-
-    bool isComment = false;
-    bool mightBeComment = false;
-
-    string current_string = "";
-    for (char c : input)
+    if (token == "==")
     {
-        // Special case for comments : don't strip
-        if (isComment)
-        {
-            if (c == '\n')
-            {
-                isComment = false;
-            }
-        }
-        else if (c == '/')
-        {
-            if (mightBeComment)
-            {
-                isComment = true;
-                mightBeComment = false;
-            }
-            else
-            {
-                mightBeComment = true;
-            }
-        }
-        else if (mightBeComment)
-        {
-            mightBeComment = false;
-        }
-
-        if (isComment || find(delims.begin(), delims.end(), c) == delims.end())
-        {
-            current_string += c;
-        }
-        else
-        {
-            if (current_string != "")
-            {
-                tokens.push_back(current_string);
-                current_string = "";
-            }
-        }
+        return TokenClass_t::RELATIONAL_OPERATOR;
     }
 
-    if (current_string != "")
+    switch (token[0])
     {
-        tokens.push_back(current_string);
+    case '(':   return TokenClass_t::OPENED_PARANTHESIS;
+    case ')':   return TokenClass_t::CLOSED_PARANTHESIS;
+    case '[':   return TokenClass_t::OPENED_ANGLE_BRACKET;
+    case ']':   return TokenClass_t::CLOSED_ANGLE_BRACKET;
+    case '{':   return TokenClass_t::OPENED_CURLY_BRACKET;
+    case '}':   return TokenClass_t::CLOSED_CURLY_BRACKET;
+    case ',':   return TokenClass_t::COMMA;
+    case ';':   return TokenClass_t::SEMICOLUMN;
+    case ':':   return TokenClass_t::COLON;
+    case '?':   return TokenClass_t::TERNARY_OPERATOR;
+    case '=':   return TokenClass_t::ASSIGNATION;
+
+    case '+':
+    case '-':
+    case '*':
+    case '/':
+    case '%':   return TokenClass_t::ARITHMETIC_OPERATOR;
+
+    case '>':
+    case '<':
+    case '!':   return TokenClass_t::RELATIONAL_OPERATOR;
+
+    case '~':
+    case '&':
+    case '|':
+    case '^':   return TokenClass_t::BITWISE_OPERATOR;
     }
 
-    return tokens;
+    return TokenClass_t::VARIABLE_NAME;
 }
 
-void SeparateAdditionalTokens(const vector<char>& tokensToSeparate, vector<string>& tokens)
+TokenClass_t ClassifyWord(KeywordId_t keywordId, string_view input, size_t end)
 {
-    for (size_t i = tokens.size(); i > 0; i--)
+    if (keywordId == INVALID_KEYWORD_ID)
     {
-        size_t index = i - 1;
-        string token = tokens[index];
-
-        // Special case for comments
-        if (token.substr(0, 2) == "//")
-        {
-            continue;
-        }
-
-        size_t posInString = 0;
-
-        auto it = find_if(tokensToSeparate.begin(), tokensToSeparate.end(), [&] (char c) {
-            posInString = token.find(c);
-            return (posInString != string::npos);
-        });
-
-        if (it == tokensToSeparate.end())
-        {
-            continue;
-        }
+        return TokenClass_t::VARIABLE_NAME;
+    }
 
-        // From the position in the string, separate the token in 3: the left part, the actual token, and the right part
-        // Then, insert the 3 at the current position in the array and remove the old token.
-        string leftPart = token.substr(0, posInString);
-        string tokenPart = token.substr(posInString, 1);
-        string rightPart = token.substr(posInString + 1, string::npos);
+    switch (GetKeyword(keywordId).m_Class)
+    {
+    case KeywordClass_t::KEYWORD_TYPE:          return TokenClass_t::TYPE;
+    case KeywordClass_t::KEYWORD_FLOW_CONTROL:  return TokenClass_t::FLOW_CONTROL;
+    case KeywordClass_t::KEYWORD_CBUFFER:       return TokenClass_t::CBUFFER;
+    case KeywordClass_t::KEYWORD_REGISTER:      return TokenClass_t::REGISTER;
+    case KeywordClass_t::KEYWORD_STRUCT:        return TokenClass_t::STRUCT;
+    case KeywordClass_t::KEYWORD_SAMPLER_STATE: return TokenClass_t::SAMPLER_STATE;
+    case KeywordClass_t::KEYWORD_TEXTURE:       return TokenClass_t::TEXTURE;
 
-        if ((leftPart == "" || leftPart[0] == '\0') && (rightPart == "" || rightPart[0] == '\0'))
+    case KeywordClass_t::KEYWORD_BUILTIN_FUNCTION:
+        // Must make sure that next lexeme is a paranthesis, otherwise it does't count
+        while (end < input.size() && GetCharacterClass(input[end]) == CC_WHITESPACE)
         {
-            continue;
+            end += 1;
         }
 
-        tokens.erase(tokens.begin() + index);
-        
-        size_t insertionIndex = 0;
-        if (leftPart != "")
+        if (end < input.size() && input[end] == '(')
         {
-            tokens.insert(tokens.begin() + index + insertionIndex, leftPart);
-            insertionIndex++;
+            return TokenClass_t::BUILTIN_FUNCTION;
         }
 
-        tokens.insert(tokens.begin() + index + insertionIndex, tokenPart);
-        insertionIndex++;
+        return TokenClass_t::VARIABLE_NAME;
 
-        if (rightPart != "")
-        {
-            tokens.insert(tokens.begin() + index + insertionIndex, rightPart);
-            insertionIndex++;
-        }
-
-        i += insertionIndex;
+    case KeywordClass_t::KEYWORD_TO_IGNORE:
+        break;
     }
+
+    return TokenClass_t::VARIABLE_NAME;
 }
 
 }
\ No newline at end of file
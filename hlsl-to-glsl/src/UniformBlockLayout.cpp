@@ -0,0 +1,415 @@
+#include "UniformBlockLayout.h"
+
+#include <algorithm>
+#include <charconv>
+using namespace std;
+
+namespace HlslToGlsl
+{
+
+UniformBlockLayout::UniformBlockLayout(pmr::memory_resource* memoryResource)
+    : m_Members(memoryResource)
+    , m_Entries(memoryResource)
+    , m_MemberRegisters(memoryResource)
+{
+}
+
+uint32_t AlignUp(uint32_t offset, uint32_t alignment)
+{
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+LexemeIndex_t SkipComments(const LexemeStream& lexemes, LexemeIndex_t lexemeIndex, LexemeIndex_t end)
+{
+    while (lexemeIndex < end && lexemes.GetTokenClass(lexemeIndex) == TokenClass_t::COMMENT)
+    {
+        lexemeIndex += 1;
+    }
+
+    return lexemeIndex;
+}
+
+// Shape of a type from its GLSL spelling, i.e. 3 rows and 1 column for vec3. Doubles take two components each
+// and aren't supported.
+bool GetTypeShape(string_view glsl, uint32_t& rows, uint32_t& columns)
+{
+    if (glsl.empty() || glsl[0] == 'd')
+    {
+        return false;
+    }
+
+    const char size = glsl.back();
+    rows = (size >= '2' && size <= '4') ? (uint32_t) (size - '0') : 1;
+    columns = (glsl.substr(0, 3) == "mat") ? rows : 1;
+
+    return true;
+}
+
+// Offset given by packoffset(c2.y), from its register lexeme, i.e. 36. Returns false if it isn't one.
+bool ParsePackOffset(const LexemeStream& lexemes, LexemeIndex_t& lexemeIndex, LexemeIndex_t end, uint32_t& offset)
+{
+    const string_view registerName = lexemes.GetToken(lexemeIndex);
+    uint32_t registerIndex = 0;
+    if (registerName.size() < 2 || registerName[0] != 'c' ||
+        from_chars(registerName.data() + 1, registerName.data() + registerName.size(), registerIndex).ptr != registerName.data() + registerName.size())
+    {
+        return false;
+    }
+
+    offset = registerIndex * REGISTER_SIZE;
+    lexemeIndex += 1;
+
+    if (lexemeIndex + 1 < end && lexemes.GetTokenClass(lexemeIndex) == TokenClass_t::STRUCTURE_OPERATOR)
+    {
+        const string_view component = lexemes.GetToken(lexemeIndex + 1);
+        const size_t componentIndex = (component.size() == 1) ? string_view("xyzw").find(component[0]) : string_view::npos;
+        if (componentIndex == string_view::npos)
+        {
+            return false;
+        }
+
+        offset += (uint32_t) componentIndex * 4;
+        lexemeIndex += 2;
+    }
+
+    return true;
+}
+
+// Places a member the way HLSL does: vectors never straddle a register, arrays and matrices start a new one, and
+// each element of an array or column of a matrix fills a register except the last one.
+void PlaceMember(UniformBlockMember& member, uint32_t explicitOffset, uint32_t& cursor)
+{
+    const uint32_t elementSize = (member.m_Columns - 1) * REGISTER_SIZE + member.m_Rows * 4;
+    const bool startsRegister = (member.m_ArraySize > 0 || member.m_Columns > 1);
+
+    if (member.m_ArraySize > 0)
+    {
+        member.m_Size = (member.m_ArraySize - 1) * AlignUp(elementSize, REGISTER_SIZE) + elementSize;
+        member.m_Std140Size = member.m_ArraySize * AlignUp(elementSize, REGISTER_SIZE);
+        member.m_Std140Alignment = REGISTER_SIZE;
+    }
+    else if (member.m_Columns > 1)
+    {
+        member.m_Size = elementSize;
+        member.m_Std140Size = member.m_Columns * REGISTER_SIZE;
+        member.m_Std140Alignment = REGISTER_SIZE;
+    }
+    else
+    {
+        member.m_Size = elementSize;
+        member.m_Std140Size = elementSize;
+        member.m_Std140Alignment = (member.m_Rows == 1) ? 4 : ((member.m_Rows == 2) ? 8 : REGISTER_SIZE);
+    }
+
+    if (explicitOffset != INVALID_REGISTER)
+    {
+        member.m_Offset = explicitOffset;
+    }
+    else if (startsRegister || cursor % REGISTER_SIZE + member.m_Size > REGISTER_SIZE)
+    {
+        member.m_Offset = AlignUp(cursor, REGISTER_SIZE);
+    }
+    else
+    {
+        member.m_Offset = cursor;
+    }
+
+    cursor = member.m_Offset + member.m_Size;
+}
+
+bool ParseMembers(const LexemeStream& lexemes, LexemeIndex_t begin, LexemeIndex_t end, UniformBlockLayout& layout)
+{
+    uint32_t cursor = 0;
+
+    for (LexemeIndex_t i = SkipComments(lexemes, begin, end); i < end; i = SkipComments(lexemes, i + 1, end))
+    {
+        uint32_t rows = 0;
+        uint32_t columns = 0;
+        if (lexemes.GetTokenClass(i) != TokenClass_t::TYPE || lexemes.GetKeywordId(i) == INVALID_KEYWORD_ID ||
+            !GetTypeShape(GetKeyword(lexemes.GetKeywordId(i)).m_Glsl, rows, columns))
+        {
+            return false;
+        }
+
+        // Declarators separated by commas share the type, each one ends at the comma or the semicolon
+        const LexemeIndex_t type = i;
+        do
+        {
+            i = SkipComments(lexemes, i + 1, end);
+            if (i >= end || lexemes.GetTokenClass(i) != TokenClass_t::VARIABLE_NAME)
+            {
+                return false;
+            }
+
+            UniformBlockMember member = {};
+            member.m_Type = type;
+            member.m_Name = i;
+            member.m_Rows = rows;
+            member.m_Columns = columns;
+
+            i = SkipComments(lexemes, i + 1, end);
+            if (i + 2 < end && lexemes.GetTokenClass(i) == TokenClass_t::OPENED_ANGLE_BRACKET)
+            {
+                const string_view arraySize = lexemes.GetToken(i + 1);
+                if (from_chars(arraySize.data(), arraySize.data() + arraySize.size(), member.m_ArraySize).ptr != arraySize.data() + arraySize.size() ||
+                    member.m_ArraySize == 0 || lexemes.GetTokenClass(i + 2) != TokenClass_t::CLOSED_ANGLE_BRACKET)
+                {
+                    return false;
+                }
+
+                i = SkipComments(lexemes, i + 3, end);
+            }
+
+            uint32_t explicitOffset = INVALID_REGISTER;
+            if (i + 3 < end && lexemes.GetTokenClass(i) == TokenClass_t::COLON)
+            {
+                if (lexemes.GetToken(i + 1) != "packoffset" || lexemes.GetTokenClass(i + 2) != TokenClass_t::OPENED_PARANTHESIS)
+                {
+                    return false;
+                }
+
+                i += 3;
+                if (!ParsePackOffset(lexemes, i, end, explicitOffset) || i >= end || lexemes.GetTokenClass(i) != TokenClass_t::CLOSED_PARANTHESIS)
+                {
+                    return false;
+                }
+
+                i = SkipComments(lexemes, i + 1, end);
+            }
+
+            PlaceMember(member, explicitOffset, cursor);
+            layout.m_Members.push_back(member);
+        }
+        while (i < end && lexemes.GetTokenClass(i) == TokenClass_t::COMMA);
+
+        if (i >= end || lexemes.GetTokenClass(i) != TokenClass_t::SEMICOLUMN)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Size of the buffer if its members were declared in the order that wastes the least. Arrays, matrices and
+// four component vectors fill registers on their own, smaller vectors go first fit, largest first, in the room
+// left in their last register or in new registers.
+uint32_t ComputePackedSize(const UniformBlockLayout& layout)
+{
+    pmr::vector<uint32_t> smallSizes(layout.m_Members.get_allocator().resource());
+    pmr::vector<uint32_t> freeSpaces(layout.m_Members.get_allocator().resource());
+    uint32_t packedSize = 0;
+
+    for (const UniformBlockMember& member : layout.m_Members)
+    {
+        if (member.m_Size < REGISTER_SIZE && member.m_ArraySize == 0)
+        {
+            smallSizes.push_back(member.m_Size);
+            continue;
+        }
+
+        packedSize += AlignUp(member.m_Size, REGISTER_SIZE);
+        if (member.m_Size % REGISTER_SIZE != 0)
+        {
+            freeSpaces.push_back(REGISTER_SIZE - member.m_Size % REGISTER_SIZE);
+        }
+    }
+
+    sort(smallSizes.begin(), smallSizes.end(), greater<uint32_t>());
+    for (uint32_t size : smallSizes)
+    {
+        auto freeSpace = find_if(freeSpaces.begin(), freeSpaces.end(), [size](uint32_t space) { return space >= size; });
+        if (freeSpace != freeSpaces.end())
+        {
+            *freeSpace -= size;
+            continue;
+        }
+
+        packedSize += REGISTER_SIZE;
+        freeSpaces.push_back(REGISTER_SIZE - size);
+    }
+
+    return packedSize;
+}
+
+uint32_t GetLastRegister(const UniformBlockMember& member)
+{
+    return (member.m_Offset + member.m_Size - 1) / REGISTER_SIZE;
+}
+
+bool Intersects(const UniformBlockMember& member, uint32_t firstRegister, uint32_t lastRegister)
+{
+    return member.m_Offset < (lastRegister + 1) * REGISTER_SIZE && member.m_Offset + member.m_Size > firstRegister * REGISTER_SIZE;
+}
+
+// Moves the members sharing a register with a member std140 can't place into a vec4 holding that register. An
+// array or a matrix sharing it brings all of its registers, which become a vec4 array its elements or columns are
+// read from by index. Returns false for an array of matrices, whose columns would need its index twice.
+bool ReadRegisterOfMember(UniformBlockLayout& layout, size_t memberIndex)
+{
+    uint32_t firstRegister = layout.m_Members[memberIndex].m_Offset / REGISTER_SIZE;
+    uint32_t lastRegister = firstRegister;
+
+    // The registers grow until none of the members in them reaches past them
+    for (bool hasGrown = true; hasGrown;)
+    {
+        hasGrown = false;
+
+        for (const UniformBlockMember& member : layout.m_Members)
+        {
+            if (!Intersects(member, firstRegister, lastRegister))
+            {
+                continue;
+            }
+
+            if (member.m_ArraySize > 0 && member.m_Columns > 1)
+            {
+                return false;
+            }
+
+            if (member.m_Offset / REGISTER_SIZE < firstRegister || GetLastRegister(member) > lastRegister)
+            {
+                firstRegister = min(firstRegister, member.m_Offset / REGISTER_SIZE);
+                lastRegister = max(lastRegister, GetLastRegister(member));
+                hasGrown = true;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < layout.m_Members.size(); i++)
+    {
+        if (Intersects(layout.m_Members[i], firstRegister, lastRegister))
+        {
+            layout.m_MemberRegisters[i] = firstRegister;
+        }
+    }
+
+    return true;
+}
+
+// Declares the members in the order of their offsets with floats before them to move them where HLSL puts
+// them. That only moves them forward, so members std140 aligns past their offset, such as a vec2 at 4 or the
+// members after an array or a matrix in its last register, are read from vec4s instead.
+bool PlanEntries(UniformBlockLayout& layout)
+{
+    layout.m_MemberRegisters.assign(layout.m_Members.size(), INVALID_REGISTER);
+
+    for (;;)
+    {
+        layout.m_Entries.clear();
+        uint32_t cursor = 0;
+        uint32_t lastRegister = INVALID_REGISTER;
+        size_t misplacedMember = layout.m_Members.size();
+
+        for (size_t i = 0; i < layout.m_Members.size() && misplacedMember == layout.m_Members.size(); i++)
+        {
+            const UniformBlockMember& member = layout.m_Members[i];
+            const uint32_t registerIndex = layout.m_MemberRegisters[i];
+
+            if (registerIndex != INVALID_REGISTER)
+            {
+                if (registerIndex != lastRegister)
+                {
+                    const uint32_t alignedCursor = AlignUp(cursor, REGISTER_SIZE);
+                    if (alignedCursor > registerIndex * REGISTER_SIZE)
+                    {
+                        return false;
+                    }
+
+                    // The members read from the same vec4s follow each other
+                    uint32_t endRegister = registerIndex;
+                    for (size_t j = i; j < layout.m_Members.size() && layout.m_MemberRegisters[j] == registerIndex; j++)
+                    {
+                        endRegister = max(endRegister, GetLastRegister(layout.m_Members[j]));
+                    }
+
+                    layout.m_Entries.push_back(UniformBlockEntry{ (uint32_t) i, registerIndex, (registerIndex * REGISTER_SIZE - alignedCursor) / 4,
+                                                                  endRegister - registerIndex + 1 });
+                    cursor = (endRegister + 1) * REGISTER_SIZE;
+                    lastRegister = registerIndex;
+                }
+
+                continue;
+            }
+
+            // The padding only has to bring the member to its offset, std140 aligns it from there
+            const uint32_t alignedCursor = AlignUp(cursor, member.m_Std140Alignment);
+            if (alignedCursor > member.m_Offset || member.m_Offset % member.m_Std140Alignment != 0)
+            {
+                misplacedMember = i;
+                break;
+            }
+
+            layout.m_Entries.push_back(UniformBlockEntry{ (uint32_t) i, INVALID_REGISTER, (member.m_Offset - alignedCursor) / 4, 0 });
+            cursor = member.m_Offset + member.m_Std140Size;
+        }
+
+        if (misplacedMember == layout.m_Members.size())
+        {
+            return true;
+        }
+
+        if (!ReadRegisterOfMember(layout, misplacedMember))
+        {
+            return false;
+        }
+    }
+}
+
+bool ComputeUniformBlockLayout(const LexemeStream& lexemes, const SyntaxTree& syntaxTree, LexemeIndex_t openedCurlyBracket, UniformBlockLayout& layout)
+{
+    layout.m_Members.clear();
+    layout.m_Entries.clear();
+    layout.m_MemberRegisters.clear();
+
+    const LexemeIndex_t closedCurlyBracket = syntaxTree.GetMatchingBracket(openedCurlyBracket);
+    if (closedCurlyBracket == INVALID_LEXEME_INDEX || !ParseMembers(lexemes, openedCurlyBracket + 1, closedCurlyBracket, layout))
+    {
+        return false;
+    }
+
+    // packoffset can place members in any order, but they can't overlap
+    stable_sort(layout.m_Members.begin(), layout.m_Members.end(),
+                [](const UniformBlockMember& a, const UniformBlockMember& b) { return a.m_Offset < b.m_Offset; });
+
+    uint32_t end = 0;
+    layout.m_UsedSize = 0;
+    for (const UniformBlockMember& member : layout.m_Members)
+    {
+        if (member.m_Offset < end)
+        {
+            return false;
+        }
+
+        end = member.m_Offset + member.m_Size;
+        layout.m_UsedSize += member.m_Rows * member.m_Columns * 4 * max(member.m_ArraySize, 1u);
+    }
+
+    layout.m_Size = AlignUp(end, REGISTER_SIZE);
+    layout.m_PackedSize = ComputePackedSize(layout);
+    layout.m_MatchesStd140 = PlanEntries(layout);
+
+    if (!layout.m_MatchesStd140)
+    {
+        DeclareMembersAsIs(layout);
+    }
+
+    return true;
+}
+
+void DeclareMembersAsIs(UniformBlockLayout& layout)
+{
+    // Without padding and registers, std140 only gives the members their HLSL offsets if it needed none of them
+    const bool hadPaddingOrRegisters = any_of(layout.m_Entries.begin(), layout.m_Entries.end(),
+                                              [](const UniformBlockEntry& entry) { return entry.m_Padding > 0 || entry.m_Register != INVALID_REGISTER; });
+
+    layout.m_MatchesStd140 = layout.m_MatchesStd140 && !hadPaddingOrRegisters;
+    layout.m_MemberRegisters.assign(layout.m_Members.size(), INVALID_REGISTER);
+    layout.m_Entries.clear();
+    for (size_t i = 0; i < layout.m_Members.size(); i++)
+    {
+        layout.m_Entries.push_back(UniformBlockEntry{ (uint32_t) i, INVALID_REGISTER, 0, 0 });
+    }
+}
+
+}
\ No newline at end of file
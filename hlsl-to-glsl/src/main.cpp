@@ -1,39 +1,456 @@
+#include "BatchConversion.h"
+#include "ConversionArena.h"
+#include "ConversionStatistics.h"
+#include "DiskCache.h"
 #include "HlslToGlsl.h"
+#include "MappedFile.h"
+#include "SamplerBindings.h"
 
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <vector>
 using namespace std;
 
+bool ParseIsVertexShader(const char* argument, bool& isVertexShader);
+int ConvertSingleFile(const vector<const char*>& arguments, const HlslToGlsl::ConversionOptions& options, bool writeSamplerMetadata, bool printLayoutReport,
+                      const char* statisticsFilename, HlslToGlsl::DiskCache* cache);
+int BenchmarkConversion(const vector<const char*>& arguments, const HlslToGlsl::ConversionOptions& options, size_t numberOfIterations);
+int ConvertManifest(const char* manifestFilename, size_t numberOfThreads, const HlslToGlsl::ConversionOptions& options, bool writeSamplerMetadata,
+                    const char* statisticsFilename, HlslToGlsl::DiskCache* cache);
+bool WriteStatistics(const char* statisticsFilename, const string& json);
+void PrintCacheStatistics(const HlslToGlsl::DiskCache& cache);
+void PrintConstantFoldingStatistics(const HlslToGlsl::ConstantFoldingStatistics& statistics);
+void PrintMinificationStatistics(const HlslToGlsl::MinificationStatistics& statistics);
+void PrintUniformBlockStatistics(const HlslToGlsl::UniformBlockStatistics& statistics);
+
+void PrintUsage(const char* programName)
+{
+    cerr << "Usage: " << programName << " [options] input_file.hlsl output_file.glsl isVertexShader {true|false}" << endl;
+    cerr << "       " << programName << " [options] --batch manifest.txt [--jobs N]" << endl;
+    cerr << "Each line of the manifest is: input_file.hlsl output_file.glsl entryFunctionName {vertex|fragment} [program]" << endl;
+    cerr << "Options:" << endl;
+    cerr << "  --cache directory   Reuse the results of previous conversions stored in directory" << endl;
+    cerr << "  --cache-size MB     Maximum size of the cache directory (default 256)" << endl;
+    cerr << "  --benchmark N       Convert the input file N times with and without an arena and print the conversions per second" << endl;
+    cerr << "  --fold-constants    Evaluate constant expressions and remove identity operations" << endl;
+    cerr << "  --target profile    GLSL to generate: 330, 420 (default), 450, es300, es310, es320 or vulkan" << endl;
+    cerr << "  --sampler-metadata  Write the texture unit and HLSL registers of each combined sampler to output_file.glsl.samplers" << endl;
+    cerr << "  --precision         Declare half and min16float variables mediump, min10float variables lowp" << endl;
+    cerr << "  --minify            Remove comments and unneeded whitespace, and print the bytes saved" << endl;
+    cerr << "  --rename-locals     Also shorten the names of parameters and local variables, implies --minify" << endl;
+    cerr << "  --layout-report     Print the size of each cbuffer, the bytes its packing wastes and how its std140 layout was matched" << endl;
+    cerr << "  --stats-json file   Write the time of each phase, the lexemes by class, the output bytes and the allocations as JSON" << endl;
+}
+
 int main(int argc, char** argv)
 {
-    if (argc != 4)
+    const char* manifestFilename = nullptr;
+    size_t numberOfThreads = 0;
+    const char* cacheDirectory = nullptr;
+    uint64_t cacheSizeInMegabytes = 256;
+    size_t numberOfBenchmarkIterations = 0;
+    HlslToGlsl::ConversionOptions options;
+    bool writeSamplerMetadata = false;
+    bool printLayoutReport = false;
+    const char* statisticsFilename = nullptr;
+
+    vector<const char*> arguments;
+    for (int i = 1; i < argc; i++)
+    {
+        const bool hasValue = (i + 1 < argc);
+
+        if (strcmp(argv[i], "--batch") == 0 && hasValue)
+        {
+            manifestFilename = argv[++i];
+        }
+        else if (strcmp(argv[i], "--jobs") == 0 && hasValue)
+        {
+            numberOfThreads = (size_t) atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--cache") == 0 && hasValue)
+        {
+            cacheDirectory = argv[++i];
+        }
+        else if (strcmp(argv[i], "--cache-size") == 0 && hasValue)
+        {
+            cacheSizeInMegabytes = (uint64_t) atoll(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--benchmark") == 0 && hasValue)
+        {
+            numberOfBenchmarkIterations = (size_t) atoll(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--fold-constants") == 0)
+        {
+            options.m_FoldConstants = true;
+        }
+        else if (strcmp(argv[i], "--target") == 0 && hasValue)
+        {
+            if (!HlslToGlsl::FindGlslProfile(argv[++i], options.m_Profile))
+            {
+                cerr << "Unknown target profile: " << argv[i] << endl;
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--sampler-metadata") == 0)
+        {
+            writeSamplerMetadata = true;
+        }
+        else if (strcmp(argv[i], "--precision") == 0)
+        {
+            options.m_PrecisionQualifiers = true;
+        }
+        else if (strcmp(argv[i], "--minify") == 0)
+        {
+            options.m_Minify = true;
+        }
+        else if (strcmp(argv[i], "--rename-locals") == 0)
+        {
+            options.m_Minify = true;
+            options.m_RenameLocals = true;
+        }
+        else if (strcmp(argv[i], "--layout-report") == 0)
+        {
+            printLayoutReport = true;
+        }
+        else if (strcmp(argv[i], "--stats-json") == 0 && hasValue)
+        {
+            statisticsFilename = argv[++i];
+        }
+        else if (strncmp(argv[i], "--", 2) == 0)
+        {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+        else
+        {
+            arguments.push_back(argv[i]);
+        }
+    }
+
+    if ((manifestFilename != nullptr && !arguments.empty()) || (manifestFilename == nullptr && arguments.size() != 3))
     {
-        cerr << "Usage: " << argv[0] << " input_file.hlsl output_file.glsl isVertexShader {true|false}" << endl;
+        PrintUsage(argv[0]);
         return 1;
     }
 
-    bool isVertexShader = false;
-    if (strcmp(argv[3], "true") == 0)
+    if (numberOfBenchmarkIterations > 0)
+    {
+        return (manifestFilename == nullptr) ? BenchmarkConversion(arguments, options, numberOfBenchmarkIterations) : 1;
+    }
+
+    unique_ptr<HlslToGlsl::DiskCache> cache;
+    if (cacheDirectory != nullptr)
+    {
+        cache.reset(new HlslToGlsl::DiskCache(cacheDirectory, cacheSizeInMegabytes * 1024 * 1024));
+    }
+
+    int returnCode = (manifestFilename != nullptr)
+                         ? ConvertManifest(manifestFilename, numberOfThreads, options, writeSamplerMetadata, statisticsFilename, cache.get())
+                         : ConvertSingleFile(arguments, options, writeSamplerMetadata, printLayoutReport, statisticsFilename, cache.get());
+
+    if (cache != nullptr)
+    {
+        PrintCacheStatistics(*cache);
+    }
+
+    return returnCode;
+}
+
+bool ParseIsVertexShader(const char* argument, bool& isVertexShader)
+{
+    if (strcmp(argument, "true") == 0)
     {
         isVertexShader = true;
     }
-    else if (strcmp(argv[3], "false") == 0)
+    else if (strcmp(argument, "false") == 0)
     {
         isVertexShader = false;
     }
     else
     {
-        cerr << "Invalid third parameter: " << argv[3] << " ! Reconized values are true or false" << endl;
+        cerr << "Invalid third parameter: " << argument << " ! Reconized values are true or false" << endl;
+        return false;
+    }
+
+    return true;
+}
+
+int ConvertSingleFile(const vector<const char*>& arguments, const HlslToGlsl::ConversionOptions& options, bool writeSamplerMetadata, bool printLayoutReport,
+                      const char* statisticsFilename, HlslToGlsl::DiskCache* cache)
+{
+    bool isVertexShader = false;
+    if (!ParseIsVertexShader(arguments[2], isVertexShader))
+    {
         return 1;
     }
 
+    HlslToGlsl::ConstantFoldingStatistics constantFoldingStatistics;
+    HlslToGlsl::ConversionOptions conversionOptions = options;
+    conversionOptions.m_ConstantFoldingStatistics = &constantFoldingStatistics;
+
+    HlslToGlsl::MinificationStatistics minificationStatistics;
+    conversionOptions.m_MinificationStatistics = &minificationStatistics;
+
+    vector<HlslToGlsl::UniformBlockStatistics> uniformBlockStatistics;
+    if (printLayoutReport)
+    {
+        conversionOptions.m_UniformBlockStatistics = &uniformBlockStatistics;
+    }
+
+    HlslToGlsl::SamplerBindingTable samplerBindings;
+    if (writeSamplerMetadata)
+    {
+        conversionOptions.m_SamplerBindings = &samplerBindings;
+    }
+
+    HlslToGlsl::ConversionStatistics conversionStatistics;
+    if (statisticsFilename != nullptr)
+    {
+        conversionOptions.m_ConversionStatistics = &conversionStatistics;
+    }
+
+    bool loadedFromCache = false;
+    conversionOptions.m_LoadedFromCache = &loadedFromCache;
+
     string outputGlsl;
-    HlslToGlsl::ConvertHlslToGlslFromFile(argv[1], "main", isVertexShader, outputGlsl);
+    if (!HlslToGlsl::ConvertHlslToGlslFromFile(arguments[0], "main", isVertexShader, outputGlsl, conversionOptions, cache))
+    {
+        // The conversion only says that it failed, a file which opens wasn't read by it but couldn't be converted
+        HlslToGlsl::MappedFile inputFile;
+        cerr << (inputFile.Open(arguments[0]) ? "Couldn't convert " : "Couldn't read ") << arguments[0] << endl;
+        return 1;
+    }
+
+    // The cache only has the output, not what folding and minification did
+    if (loadedFromCache && (options.m_FoldConstants || options.m_Minify))
+    {
+        cout << "Output loaded from the cache, no folding or minification statistics" << endl;
+    }
+    else
+    {
+        if (options.m_FoldConstants)
+        {
+            PrintConstantFoldingStatistics(constantFoldingStatistics);
+        }
+
+        if (options.m_Minify && minificationStatistics.m_OriginalSize > 0)
+        {
+            PrintMinificationStatistics(minificationStatistics);
+        }
+    }
+
+    for (const HlslToGlsl::UniformBlockStatistics& statistics : uniformBlockStatistics)
+    {
+        PrintUniformBlockStatistics(statistics);
+    }
 
-    ofstream outputFile(argv[2]);
+    ofstream outputFile(arguments[1]);
     outputFile << outputGlsl;
     outputFile.close();
 
+    if (writeSamplerMetadata)
+    {
+        string metadata;
+        samplerBindings.WriteMetadata(metadata);
+
+        ofstream metadataFile(string(arguments[1]) + ".samplers");
+        metadataFile << metadata;
+        metadataFile.close();
+    }
+
+    if (statisticsFilename != nullptr)
+    {
+        string json;
+        HlslToGlsl::WriteConversionStatisticsAsJson(conversionStatistics, json);
+
+        if (!WriteStatistics(statisticsFilename, json + "\n"))
+        {
+            return 1;
+        }
+    }
+
     return 0;
+}
+
+int BenchmarkConversion(const vector<const char*>& arguments, const HlslToGlsl::ConversionOptions& options, size_t numberOfIterations)
+{
+    bool isVertexShader = false;
+    if (!ParseIsVertexShader(arguments[2], isVertexShader))
+    {
+        return 1;
+    }
+
+    HlslToGlsl::MappedFile inputFile;
+    if (!inputFile.Open(arguments[0]))
+    {
+        cerr << "Couldn't read " << arguments[0] << endl;
+        return 1;
+    }
+
+    // The same output string is reused, as a long running process would, so that only the conversion itself is measured
+    string outputGlsl;
+    HlslToGlsl::ConversionArena arena;
+
+    for (int useArena = 0; useArena < 2; useArena++)
+    {
+        const auto start = chrono::steady_clock::now();
+
+        for (size_t i = 0; i < numberOfIterations; i++)
+        {
+            outputGlsl.clear();
+
+            if (useArena)
+            {
+                HlslToGlsl::ConvertHlslToGlslFromSource(inputFile.GetContent(), "main", isVertexShader, outputGlsl, options, arena.GetResource());
+                arena.Reset();
+            }
+            else
+            {
+                HlslToGlsl::ConvertHlslToGlslFromSource(inputFile.GetContent(), "main", isVertexShader, outputGlsl, options);
+            }
+        }
+
+        const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        cout << (useArena ? "Arena: " : "Heap:  ") << (numberOfIterations / seconds) << " conversions per second" << endl;
+    }
+
+    ofstream outputFile(arguments[1]);
+    outputFile << outputGlsl;
+    outputFile.close();
+
+    return 0;
+}
+
+int ConvertManifest(const char* manifestFilename, size_t numberOfThreads, const HlslToGlsl::ConversionOptions& options, bool writeSamplerMetadata,
+                    const char* statisticsFilename, HlslToGlsl::DiskCache* cache)
+{
+    vector<HlslToGlsl::BatchEntry> entries;
+    string error;
+    if (!HlslToGlsl::ReadBatchManifest(manifestFilename, entries, error))
+    {
+        cerr << error << endl;
+        return 1;
+    }
+
+    if (writeSamplerMetadata)
+    {
+        for (HlslToGlsl::BatchEntry& entry : entries)
+        {
+            entry.m_SamplerMetadataFilename = entry.m_OutputFilename + ".samplers";
+        }
+    }
+
+    HlslToGlsl::ConversionStatistics conversionStatistics;
+    HlslToGlsl::ConversionOptions batchOptions = options;
+    if (statisticsFilename != nullptr)
+    {
+        batchOptions.m_ConversionStatistics = &conversionStatistics;
+    }
+
+    vector<HlslToGlsl::BatchResult> results = HlslToGlsl::ConvertBatch(entries, numberOfThreads, batchOptions, cache);
+
+    // The summary follows the order of the manifest, not the order in which the conversions finished
+    size_t numberOfFailures = 0;
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        if (!results[i].m_Succeeded)
+        {
+            cerr << entries[i].m_InputFilename << ": " << results[i].m_Error << endl;
+            numberOfFailures += 1;
+        }
+        else if (options.m_Minify && results[i].m_LoadedFromCache)
+        {
+            cout << entries[i].m_InputFilename << ": output loaded from the cache, no minification statistics" << endl;
+        }
+        else if (options.m_Minify && results[i].m_Minification.m_OriginalSize > 0)
+        {
+            cout << entries[i].m_InputFilename << ": ";
+            PrintMinificationStatistics(results[i].m_Minification);
+        }
+    }
+
+    cout << (results.size() - numberOfFailures) << " converted, " << numberOfFailures << " failed" << endl;
+
+    // The sum of the entries, then each entry
+    if (statisticsFilename != nullptr)
+    {
+        string json = "{\"total\": ";
+        HlslToGlsl::WriteConversionStatisticsAsJson(conversionStatistics, json);
+        json += ",\n\"entries\": [\n";
+
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            json += "{\"input\": \"" + entries[i].m_InputFilename + "\", \"statistics\": ";
+            HlslToGlsl::WriteConversionStatisticsAsJson(results[i].m_Statistics, json);
+            json += (i + 1 < results.size()) ? "},\n" : "}\n";
+        }
+
+        json += "]}\n";
+
+        if (!WriteStatistics(statisticsFilename, json))
+        {
+            return 1;
+        }
+    }
+
+    return (numberOfFailures == 0) ? 0 : 1;
+}
+
+void PrintCacheStatistics(const HlslToGlsl::DiskCache& cache)
+{
+    HlslToGlsl::DiskCacheStatistics statistics = cache.GetStatistics();
+
+    cout << "Cache: " << statistics.m_Hits << " hits, " << statistics.m_Misses << " misses, " << statistics.m_Stores << " stored, "
+         << statistics.m_Evictions << " evicted" << endl;
+}
+
+void PrintConstantFoldingStatistics(const HlslToGlsl::ConstantFoldingStatistics& statistics)
+{
+    cout << "Constant folding: " << statistics.m_FoldedExpressions << " expressions folded, " << statistics.m_RemovedIdentities << " identities removed, "
+         << statistics.m_EvaluatedConstants << " constants evaluated, operations " << statistics.m_Operations << " -> "
+         << (statistics.m_Operations - statistics.m_RemovedOperations) << endl;
+}
+
+void PrintMinificationStatistics(const HlslToGlsl::MinificationStatistics& statistics)
+{
+    const size_t savedBytes = statistics.m_OriginalSize - statistics.m_MinifiedSize;
+
+    cout << "Minification: " << statistics.m_OriginalSize << " -> " << statistics.m_MinifiedSize << " bytes, " << savedBytes << " saved ("
+         << (savedBytes * 100 / statistics.m_OriginalSize) << "%), " << statistics.m_RenamedIdentifiers << " identifiers renamed" << endl;
+}
+
+void PrintUniformBlockStatistics(const HlslToGlsl::UniformBlockStatistics& statistics)
+{
+    cout << "Uniform block " << statistics.m_Name << ": ";
+    if (!statistics.m_IsAnalyzed)
+    {
+        cout << "layout unknown, declared as is" << endl;
+        return;
+    }
+
+    cout << statistics.m_Size << " bytes, " << statistics.m_WastedBytes << " wasted, " << statistics.m_PackedSize << " with the members reordered, "
+         << statistics.m_PaddingMembers << " padding members, " << statistics.m_RegisterMembers << " members read from registers";
+
+    cout << (statistics.m_MatchesHlsl ? "" : ", std140 offsets differ from HLSL") << endl;
+}
+
+bool WriteStatistics(const char* statisticsFilename, const string& json)
+{
+    ofstream statisticsFile(statisticsFilename);
+    statisticsFile << json;
+    statisticsFile.close();
+
+    if (statisticsFile.fail())
+    {
+        cerr << "Couldn't write " << statisticsFilename << endl;
+        return false;
+    }
+
+    return true;
 }
\ No newline at end of file
@@ -0,0 +1,27 @@
+# Converts INPUT with CONVERTER and compares the result with EXPECTED. OPTIONS are the options of the converter,
+# separated by |. With the environment variable UPDATE_GOLDEN set, EXPECTED is replaced by the result instead.
+
+string(REPLACE "|" ";" OPTIONS "${OPTIONS}")
+
+execute_process(
+    COMMAND ${CONVERTER} ${OPTIONS} ${INPUT} ${OUTPUT} ${IS_VERTEX_SHADER}
+    RESULT_VARIABLE result
+)
+
+if (NOT result EQUAL 0)
+    message(FATAL_ERROR "Conversion of ${INPUT} failed: ${result}")
+endif ()
+
+if (DEFINED ENV{UPDATE_GOLDEN})
+    configure_file(${OUTPUT} ${EXPECTED} COPYONLY)
+    return()
+endif ()
+
+execute_process(
+    COMMAND ${CMAKE_COMMAND} -E compare_files ${OUTPUT} ${EXPECTED}
+    RESULT_VARIABLE result
+)
+
+if (NOT result EQUAL 0)
+    message(FATAL_ERROR "${OUTPUT} differs from ${EXPECTED}")
+endif ()
\ No newline at end of file
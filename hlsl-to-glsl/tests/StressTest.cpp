@@ -0,0 +1,304 @@
+#include "ConversionArena.h"
+#include "ConversionCache.h"
+#include "ConversionKey.h"
+#include "ConversionOptions.h"
+#include "HlslToGlsl.h"
+#include "ShaderGenerator.h"
+#include "SymbolTable.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace std;
+
+// Converts thousands of generated shaders on a single thread, then again from several threads at once, and
+// checks that every output is the same byte for byte. The threads take the shaders in whatever order they
+// finish, reuse an arena per thread, and in a second pass share one symbol table, like a batch conversion.
+// The same threads then go through a ConversionCache, whose eviction order is checked on its own.
+
+struct StressShader
+{
+    string m_Source;
+    bool m_IsVertexShader;
+    HlslToGlsl::ConversionOptions m_Options;
+};
+
+void PrintUsage(const char* programName)
+{
+    cerr << "Usage: " << programName << " [options]" << endl;
+    cerr << "Options:" << endl;
+    cerr << "  --shaders N   Number of generated shaders (default 2000)" << endl;
+    cerr << "  --threads N   Number of threads converting them at once (default 8)" << endl;
+}
+
+// Small shaders, so that the threads run many conversions at the same time, in every profile and with every
+// combination of the optional stages
+vector<StressShader> GenerateShaders(size_t numberOfShaders)
+{
+    vector<StressShader> shaders(numberOfShaders);
+
+    for (size_t i = 0; i < numberOfShaders; i++)
+    {
+        ShaderGeneratorSettings settings;
+        settings.m_Seed = i + 1;
+        settings.m_IsVertexShader = (i % 2) == 1;
+        settings.m_NumberOfFunctions = 1 + i % 7;
+        settings.m_StatementsPerFunction = 1 + i % 4;
+        settings.m_MulDepth = 1 + i % 3;
+        settings.m_ExpressionDepth = 1 + i % 3;
+        settings.m_NumberOfCbuffers = 1 + i % 3;
+        settings.m_MembersPerCbuffer = i % 5;
+        settings.m_NumberOfTextures = 1 + i % 3;
+        settings.m_NumberOfSamplerStates = 1 + i % 2;
+
+        StressShader& shader = shaders[i];
+        shader.m_Source = GenerateShader(settings);
+        shader.m_IsVertexShader = settings.m_IsVertexShader;
+        shader.m_Options.m_Profile = (HlslToGlsl::GlslProfile_t) (i % (HlslToGlsl::GLSL_PROFILE_VULKAN + 1));
+        shader.m_Options.m_FoldConstants = (i / 2) % 2 == 1;
+        shader.m_Options.m_PrecisionQualifiers = (i / 4) % 2 == 1;
+        shader.m_Options.m_Minify = (i / 8) % 3 != 0;
+        shader.m_Options.m_RenameLocals = (i / 8) % 3 == 2;
+    }
+
+    return shaders;
+}
+
+vector<string> ConvertOnThreads(const vector<StressShader>& shaders, size_t numberOfThreads, HlslToGlsl::SymbolTable* sharedSymbolTable)
+{
+    vector<string> outputs(shaders.size());
+
+    atomic<size_t> nextShader(0);
+    auto worker = [&] () {
+        HlslToGlsl::ConversionArena arena;
+
+        for (size_t i = nextShader++; i < shaders.size(); i = nextShader++)
+        {
+            HlslToGlsl::ConvertHlslToGlslFromSource(shaders[i].m_Source, "main", shaders[i].m_IsVertexShader, outputs[i], shaders[i].m_Options,
+                                                    arena.GetResource(), sharedSymbolTable);
+            arena.Reset();
+        }
+    };
+
+    vector<thread> threads;
+    for (size_t i = 0; i < numberOfThreads; i++)
+    {
+        threads.push_back(thread(worker));
+    }
+
+    for (thread& t : threads)
+    {
+        t.join();
+    }
+
+    return outputs;
+}
+
+vector<shared_ptr<const string>> ConvertThroughCache(const vector<StressShader>& shaders, size_t numberOfThreads, HlslToGlsl::ConversionCache& cache)
+{
+    vector<shared_ptr<const string>> outputs(shaders.size());
+
+    atomic<size_t> nextShader(0);
+    auto worker = [&] () {
+        for (size_t i = nextShader++; i < shaders.size(); i = nextShader++)
+        {
+            outputs[i] = cache.Convert(shaders[i].m_Source, "main", shaders[i].m_IsVertexShader, shaders[i].m_Options);
+        }
+    };
+
+    vector<thread> threads;
+    for (size_t i = 0; i < numberOfThreads; i++)
+    {
+        threads.push_back(thread(worker));
+    }
+
+    for (thread& t : threads)
+    {
+        t.join();
+    }
+
+    return outputs;
+}
+
+// Returns the number of outputs which differ, and prints the first one
+size_t CompareOutputs(const vector<string>& expectedOutputs, const vector<string>& outputs, const char* passName)
+{
+    size_t numberOfDifferences = 0;
+
+    for (size_t i = 0; i < outputs.size(); i++)
+    {
+        if (outputs[i] == expectedOutputs[i])
+        {
+            continue;
+        }
+
+        if (numberOfDifferences == 0)
+        {
+            const auto firstDifference = mismatch(expectedOutputs[i].begin(), expectedOutputs[i].end(), outputs[i].begin(), outputs[i].end());
+            cerr << passName << ": shader " << i << " differs from the single threaded output at byte "
+                 << (firstDifference.first - expectedOutputs[i].begin()) << endl;
+        }
+
+        numberOfDifferences += 1;
+    }
+
+    return numberOfDifferences;
+}
+
+// The first pass fills the cache from every thread, the second one must only hit, in every shard, and hand out
+// the very buffers the first one stored. Returns the number of errors, and prints them.
+size_t CheckCacheHits(const vector<StressShader>& shaders, size_t numberOfThreads, const vector<string>& expectedOutputs)
+{
+    HlslToGlsl::ConversionCache cache(256 * 1024 * 1024);
+
+    const vector<shared_ptr<const string>> storedOutputs = ConvertThroughCache(shaders, numberOfThreads, cache);
+    const HlslToGlsl::ConversionCacheStatistics afterFirstPass = cache.GetStatistics();
+    const vector<shared_ptr<const string>> cachedOutputs = ConvertThroughCache(shaders, numberOfThreads, cache);
+    const HlslToGlsl::ConversionCacheStatistics afterSecondPass = cache.GetStatistics();
+
+    vector<string> outputs(shaders.size());
+    size_t numberOfErrors = 0;
+
+    for (size_t i = 0; i < shaders.size(); i++)
+    {
+        if (cachedOutputs[i] == nullptr || cachedOutputs[i] != storedOutputs[i])
+        {
+            if (numberOfErrors == 0)
+            {
+                cerr << "Cache: shader " << i << " wasn't handed the output stored for it" << endl;
+            }
+
+            numberOfErrors += 1;
+            continue;
+        }
+
+        outputs[i] = *cachedOutputs[i];
+    }
+
+    numberOfErrors += CompareOutputs(expectedOutputs, outputs, "Cache");
+
+    if (afterSecondPass.m_Hits - afterFirstPass.m_Hits != shaders.size() || afterSecondPass.m_Misses != afterFirstPass.m_Misses ||
+        afterSecondPass.m_Evictions != 0)
+    {
+        cerr << "Cache: " << (afterSecondPass.m_Hits - afterFirstPass.m_Hits) << " hits, " << (afterSecondPass.m_Misses - afterFirstPass.m_Misses)
+             << " misses and " << afterSecondPass.m_Evictions << " evictions converting " << shaders.size() << " cached shaders" << endl;
+        numberOfErrors += 1;
+    }
+
+    return numberOfErrors;
+}
+
+// Fills a single shard with entries of the same size, three of which fit in its budget: the least recently used
+// one must be the one evicted to make room for a fourth
+size_t CheckCacheEviction()
+{
+    const shared_ptr<const string> output = make_shared<const string>(1000, 'x');
+    HlslToGlsl::ConversionKey keys[4];
+    for (size_t i = 0; i < 4; i++)
+    {
+        keys[i] = HlslToGlsl::ComputeConversionKey(to_string(i), "main", false);
+    }
+
+    // The size of an entry counts its bookkeeping too
+    HlslToGlsl::ConversionCache unboundedCache(SIZE_MAX, 1);
+    unboundedCache.Insert(keys[0], output);
+    const size_t entrySize = unboundedCache.GetStatistics().m_SizeInBytes;
+
+    HlslToGlsl::ConversionCache cache(3 * entrySize + entrySize / 2, 1);
+    cache.Insert(keys[0], output);
+    cache.Insert(keys[1], output);
+    cache.Insert(keys[2], output);
+    cache.Find(keys[0]);
+    cache.Insert(keys[3], output);
+
+    const HlslToGlsl::ConversionCacheStatistics statistics = cache.GetStatistics();
+    if (cache.Find(keys[1]) != nullptr || cache.Find(keys[0]) == nullptr || cache.Find(keys[2]) == nullptr || cache.Find(keys[3]) == nullptr ||
+        statistics.m_Evictions != 1 || statistics.m_SizeInBytes != 3 * entrySize)
+    {
+        cerr << "Cache: the least recently used entry wasn't the one evicted, " << statistics.m_Evictions << " evictions and "
+             << statistics.m_SizeInBytes << " bytes for a budget of " << (3 * entrySize + entrySize / 2) << endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+// Gathering the statistics of the uniform blocks converts every time, since a cached output comes without them
+size_t CheckCacheBypass(const StressShader& shader)
+{
+    HlslToGlsl::ConversionCache cache(256 * 1024 * 1024);
+
+    vector<HlslToGlsl::UniformBlockStatistics> uniformBlockStatistics;
+    HlslToGlsl::ConversionOptions options = shader.m_Options;
+    options.m_UniformBlockStatistics = &uniformBlockStatistics;
+
+    cache.Convert(shader.m_Source, "main", shader.m_IsVertexShader, options);
+    const size_t numberOfUniformBlocks = uniformBlockStatistics.size();
+    cache.Convert(shader.m_Source, "main", shader.m_IsVertexShader, options);
+
+    if (uniformBlockStatistics.size() != 2 * numberOfUniformBlocks || cache.GetStatistics().m_SizeInBytes != 0)
+    {
+        cerr << "Cache: a conversion gathering the statistics of the uniform blocks was cached" << endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    size_t numberOfShaders = 2000;
+    size_t numberOfThreads = 8;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const bool hasValue = (i + 1 < argc);
+
+        if (strcmp(argv[i], "--shaders") == 0 && hasValue)
+        {
+            numberOfShaders = max((size_t) atoll(argv[++i]), (size_t) 1);
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && hasValue)
+        {
+            numberOfThreads = max((size_t) atoll(argv[++i]), (size_t) 1);
+        }
+        else
+        {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    const vector<StressShader> shaders = GenerateShaders(numberOfShaders);
+
+    vector<string> expectedOutputs(shaders.size());
+    for (size_t i = 0; i < shaders.size(); i++)
+    {
+        HlslToGlsl::ConvertHlslToGlslFromSource(shaders[i].m_Source, "main", shaders[i].m_IsVertexShader, expectedOutputs[i], shaders[i].m_Options);
+
+        if (expectedOutputs[i].empty())
+        {
+            cerr << "Shader " << i << " wasn't converted" << endl;
+            return 1;
+        }
+    }
+
+    size_t numberOfDifferences = CompareOutputs(expectedOutputs, ConvertOnThreads(shaders, numberOfThreads, nullptr), "Own symbol tables");
+
+    HlslToGlsl::SymbolTable sharedSymbolTable(true);
+    numberOfDifferences += CompareOutputs(expectedOutputs, ConvertOnThreads(shaders, numberOfThreads, &sharedSymbolTable), "Shared symbol table");
+
+    cout << numberOfShaders << " shaders converted twice on " << numberOfThreads << " threads, " << numberOfDifferences << " outputs differ" << endl;
+
+    const size_t numberOfCacheErrors = CheckCacheHits(shaders, numberOfThreads, expectedOutputs) + CheckCacheEviction() + CheckCacheBypass(shaders[0]);
+    cout << numberOfShaders << " shaders converted twice through a cache on " << numberOfThreads << " threads, " << numberOfCacheErrors << " errors" << endl;
+
+    return (numberOfDifferences == 0 && numberOfCacheErrors == 0) ? 0 : 1;
+}
\ No newline at end of file
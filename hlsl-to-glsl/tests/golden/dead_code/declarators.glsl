@@ -0,0 +1,16 @@
+#version 420
+
+// Names declared after a comma are definitions, main only uses the second one of each declaration
+layout(std140, binding = 0) uniform Params
+{
+float a;
+float b;
+vec4 c;
+};
+const float g1= 1.0, g2= 2.0;
+out vec4 color;
+
+void main() { 
+float l1= 0.5, l2= 0.25;
+color= vec4 ( b, g2, l1, l2);
+}
\ No newline at end of file
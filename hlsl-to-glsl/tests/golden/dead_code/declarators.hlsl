@@ -0,0 +1,27 @@
+// Names declared after a comma are definitions, main only uses the second one of each declaration
+cbuffer Params : register(b0)
+{
+    float a, b;
+    float4 c;
+};
+
+cbuffer Unused : register(b1)
+{
+    float4 d, e;
+};
+
+static const float g1 = 1.0, g2 = 2.0;
+static const float h1 = 3.0, h2 = float2(4.0, 5.0).x;
+
+struct PS_OUTPUT
+{
+    float4 color : SV_TARGET0;
+};
+
+PS_OUTPUT main()
+{
+    PS_OUTPUT output;
+    float l1 = 0.5, l2 = 0.25;
+    output.color = float4(b, g2, l1, l2);
+    return output;
+}
\ No newline at end of file
@@ -0,0 +1,16 @@
+#version 420
+
+void clip(float x) { if (x < 0.0) discard; }
+void clip(vec2 x) { if (any(lessThan(x, vec2(0.0)))) discard; }
+void clip(vec3 x) { if (any(lessThan(x, vec3(0.0)))) discard; }
+void clip(vec4 x) { if (any(lessThan(x, vec4(0.0)))) discard; }
+
+// clip
+in vec2 uv;
+
+out vec4 color;
+
+void main() { 
+ clip(uv.x - 0.5);
+color= vec4 ( uv, 0.0, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,19 @@
+// clip
+struct PS_INPUT
+{
+    float4 position : SV_POSITION;
+    float2 uv : TEXCOORD0;
+};
+
+struct PS_OUTPUT
+{
+    float4 color : SV_TARGET0;
+};
+
+PS_OUTPUT main(PS_INPUT input)
+{
+    PS_OUTPUT output;
+    clip(input.uv.x - 0.5);
+    output.color = float4(input.uv, 0.0, 1.0);
+    return output;
+}
\ No newline at end of file
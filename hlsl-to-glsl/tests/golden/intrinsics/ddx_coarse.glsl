@@ -0,0 +1,10 @@
+#version 420
+
+// ddx_coarse
+in vec2 uv;
+
+out vec4 color;
+
+void main() { 
+color= vec4 (  dFdx(uv), 0.0, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,10 @@
+#version 450
+
+// ddx_fine
+in vec2 uv;
+
+out vec4 color;
+
+void main() { 
+color= vec4 (  dFdxFine(uv), 0.0, 1.0);
+}
\ No newline at end of file
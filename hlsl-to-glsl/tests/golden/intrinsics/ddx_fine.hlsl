@@ -0,0 +1,18 @@
+// ddx_fine
+struct PS_INPUT
+{
+    float4 position : SV_POSITION;
+    float2 uv : TEXCOORD0;
+};
+
+struct PS_OUTPUT
+{
+    float4 color : SV_TARGET0;
+};
+
+PS_OUTPUT main(PS_INPUT input)
+{
+    PS_OUTPUT output;
+    output.color = float4(ddx_fine(input.uv), 0.0, 1.0);
+    return output;
+}
\ No newline at end of file
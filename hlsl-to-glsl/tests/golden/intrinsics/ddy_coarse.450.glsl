@@ -0,0 +1,10 @@
+#version 450
+
+// ddy_coarse
+in vec2 uv;
+
+out vec4 color;
+
+void main() { 
+color= vec4 (  dFdyCoarse(uv), 0.0, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,18 @@
+// ddy_coarse
+struct PS_INPUT
+{
+    float4 position : SV_POSITION;
+    float2 uv : TEXCOORD0;
+};
+
+struct PS_OUTPUT
+{
+    float4 color : SV_TARGET0;
+};
+
+PS_OUTPUT main(PS_INPUT input)
+{
+    PS_OUTPUT output;
+    output.color = float4(ddy_coarse(input.uv), 0.0, 1.0);
+    return output;
+}
\ No newline at end of file
@@ -0,0 +1,10 @@
+#version 420
+
+// ddy_fine
+in vec2 uv;
+
+out vec4 color;
+
+void main() { 
+color= vec4 (  dFdy(uv), 0.0, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,10 @@
+#version 420
+
+// fma
+in vec2 uv;
+
+out vec4 color;
+
+void main() { 
+color= vec4 (  fma(uv, uv.yx + 1.0, uv), 0.0, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,10 @@
+#version 420
+
+// fmod
+in vec2 uv;
+
+out vec4 color;
+
+void main() { 
+color= vec4 (  ((uv * 3.0) - 1.5 * trunc((uv * 3.0) / 1.5)), 0.0, 1.0);
+}
\ No newline at end of file
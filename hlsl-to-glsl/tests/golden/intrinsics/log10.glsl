@@ -0,0 +1,10 @@
+#version 420
+
+// log10
+in vec2 uv;
+
+out vec4 color;
+
+void main() { 
+color= vec4 (  (log2(uv + 1.0) * 0.301029996), 0.0, 1.0);
+}
\ No newline at end of file
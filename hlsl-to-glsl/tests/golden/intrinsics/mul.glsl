@@ -0,0 +1,14 @@
+#version 420
+
+// mul
+layout(std140, binding = 0) uniform Transform
+{
+mat4 transform;
+};
+in vec2 uv;
+
+out vec4 color;
+
+void main() { 
+color=  (vec4 ( uv, 0.0, 1.0) * transform);
+}
\ No newline at end of file
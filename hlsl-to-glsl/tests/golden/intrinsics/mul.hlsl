@@ -0,0 +1,23 @@
+// mul
+cbuffer Transform : register(b0)
+{
+    float4x4 transform;
+};
+
+struct PS_INPUT
+{
+    float4 position : SV_POSITION;
+    float2 uv : TEXCOORD0;
+};
+
+struct PS_OUTPUT
+{
+    float4 color : SV_TARGET0;
+};
+
+PS_OUTPUT main(PS_INPUT input)
+{
+    PS_OUTPUT output;
+    output.color = mul(float4(input.uv, 0.0, 1.0), transform);
+    return output;
+}
\ No newline at end of file
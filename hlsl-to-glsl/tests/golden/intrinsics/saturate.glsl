@@ -0,0 +1,10 @@
+#version 420
+
+// saturate
+in vec2 uv;
+
+out vec4 color;
+
+void main() { 
+color= vec4 (  clamp(uv * 2.0 - 0.5, 0.0, 1.0), 0.0, 1.0);
+}
\ No newline at end of file
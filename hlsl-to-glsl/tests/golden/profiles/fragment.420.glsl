@@ -0,0 +1,22 @@
+#version 420
+layout(binding = 0) uniform sampler2D texture_1_02;
+
+// Uniform block, combined sampler, reduced precision and inputs and outputs, which each profile declares its own way
+layout(std140, binding = 3) uniform Material
+{
+vec4 tint;
+float exposure;
+};
+in vec3 worldNormal;
+in vec2 texcoord;
+
+out vec4 color;
+
+void main() { 
+vec2 inv_texcoord = texcoord;
+inv_texcoord.y = 1.0 - texcoord.y;
+
+vec3 n=  normalize( worldNormal);
+vec4 albedo= texture(texture_1_02, inv_texcoord);
+color= vec4 ( albedo.rgb * tint.rgb *  clamp(n.y, 0.0, 1.0), albedo.a) * exposure;
+}
\ No newline at end of file
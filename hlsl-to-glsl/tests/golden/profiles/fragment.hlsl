@@ -0,0 +1,30 @@
+// Uniform block, combined sampler, reduced precision and inputs and outputs, which each profile declares its own way
+Texture2D albedoTexture : register(t2);
+SamplerState linearSampler : register(s1);
+
+cbuffer Material : register(b3)
+{
+    float4 tint;
+    float exposure;
+};
+
+struct PS_INPUT
+{
+    float4 position : SV_POSITION;
+    float3 worldNormal : NORMAL;
+    float2 texcoord : TEXCOORD0;
+};
+
+struct PS_OUTPUT
+{
+    float4 color : SV_TARGET0;
+};
+
+PS_OUTPUT main(PS_INPUT input)
+{
+    PS_OUTPUT output;
+    half3 n = normalize(input.worldNormal);
+    float4 albedo = albedoTexture.Sample(linearSampler, input.texcoord);
+    output.color = float4(albedo.rgb * tint.rgb * saturate(n.y), albedo.a) * exposure;
+    return output;
+}
\ No newline at end of file
@@ -0,0 +1,22 @@
+#version 450
+layout(set = 1, binding = 0) uniform sampler2D texture_1_02;
+
+// Uniform block, combined sampler, reduced precision and inputs and outputs, which each profile declares its own way
+layout(std140, set = 0, binding = 3) uniform Material
+{
+vec4 tint;
+float exposure;
+};
+layout (location=0) in vec3 worldNormal;
+layout (location=1) in vec2 texcoord;
+
+layout (location=0) out vec4 color;
+
+void main() { 
+vec2 inv_texcoord = texcoord;
+inv_texcoord.y = 1.0 - texcoord.y;
+
+vec3 n=  normalize( worldNormal);
+vec4 albedo= texture(texture_1_02, inv_texcoord);
+color= vec4 ( albedo.rgb * tint.rgb *  clamp(n.y, 0.0, 1.0), albedo.a) * exposure;
+}
\ No newline at end of file
@@ -0,0 +1,20 @@
+#version 450
+
+// Uniform block and inputs and outputs, which each profile declares its own way
+layout(std140, binding = 0) uniform Transforms
+{
+mat4 worldViewProjection;
+};
+layout (location=0) in vec3 position;
+layout (location=1) in vec3 normal;
+layout (location=2) in vec2 uv;
+
+// Members are flattened into variables of the same name, so the outputs can't share the names of the inputs
+out vec3 worldNormal;
+out vec2 texcoord;
+
+void main() { 
+gl_Position=  (vec4 ( position, 1.0) * worldViewProjection);
+worldNormal= normal;
+texcoord= uv;
+}
\ No newline at end of file
@@ -0,0 +1,29 @@
+// Uniform block and inputs and outputs, which each profile declares its own way
+cbuffer Transforms : register(b0)
+{
+    float4x4 worldViewProjection;
+};
+
+struct VS_INPUT
+{
+    float3 position : POSITION;
+    float3 normal : NORMAL;
+    float2 uv : TEXCOORD0;
+};
+
+// Members are flattened into variables of the same name, so the outputs can't share the names of the inputs
+struct VS_OUTPUT
+{
+    float4 position : SV_POSITION;
+    float3 worldNormal : NORMAL;
+    float2 texcoord : TEXCOORD0;
+};
+
+VS_OUTPUT main(VS_INPUT input)
+{
+    VS_OUTPUT output;
+    output.position = mul(float4(input.position, 1.0), worldViewProjection);
+    output.worldNormal = input.normal;
+    output.texcoord = input.uv;
+    return output;
+}
\ No newline at end of file
@@ -0,0 +1,18 @@
+#version 420
+layout(binding = 0) uniform sampler2D texture_0_00;
+layout(binding = 1) uniform sampler2D texture_0_01;
+
+// Only the inputs main samples get an inverted copy: a helper samples with its own parameter, as it is
+in vec2 texcoord;
+
+out vec4 color;
+
+vec4 SampleDetail( vec2 uv){
+return texture(texture_0_01, uv * 4.0);
+}void main() { 
+vec2 inv_texcoord = texcoord;
+inv_texcoord.y = 1.0 - texcoord.y;
+
+vec4 albedo= texture(texture_0_00, inv_texcoord);
+color= albedo * SampleDetail( texcoord);
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+// Only the inputs main samples get an inverted copy: a helper samples with its own parameter, as it is
+Texture2D albedoTexture : register(t0);
+Texture2D detailTexture : register(t1);
+SamplerState linearSampler : register(s0);
+
+struct PS_INPUT
+{
+    float4 position : SV_POSITION;
+    float2 texcoord : TEXCOORD0;
+};
+
+struct PS_OUTPUT
+{
+    float4 color : SV_TARGET0;
+};
+
+float4 SampleDetail(float2 uv)
+{
+    return detailTexture.Sample(linearSampler, uv * 4.0);
+}
+
+PS_OUTPUT main(PS_INPUT input)
+{
+    PS_OUTPUT output;
+    float4 albedo = albedoTexture.Sample(linearSampler, input.texcoord);
+    output.color = albedo * SampleDetail(input.texcoord);
+    return output;
+}
\ No newline at end of file
@@ -0,0 +1,20 @@
+#version 420
+
+// packoffset leaves gaps, which std140 gets as padding floats
+layout(std140, binding = 1) uniform Explicit
+{
+vec4 g;
+float Explicit_padding0;
+float Explicit_padding1;
+float Explicit_padding2;
+float Explicit_padding3;
+float Explicit_padding4;
+float h;
+vec3 i;
+float j;
+};
+out vec4 color;
+
+void main() { 
+color= g + h + vec4 ( i, j);
+}
\ No newline at end of file
@@ -0,0 +1,20 @@
+// packoffset leaves gaps, which std140 gets as padding floats
+cbuffer Explicit : register(b1)
+{
+    float4 g : packoffset(c0);
+    float h : packoffset(c2.y);
+    float3 i : packoffset(c3);
+    float j : packoffset(c3.w);
+};
+
+struct PS_OUTPUT
+{
+    float4 color : SV_TARGET0;
+};
+
+PS_OUTPUT main()
+{
+    PS_OUTPUT output;
+    output.color = g + h + float4(i, j);
+    return output;
+}
\ No newline at end of file
@@ -0,0 +1,17 @@
+#version 420
+
+// b, d and f follow members std140 would place later than HLSL. d shares the last register of the array c and f
+// the last register of the matrix e, so both of them are read from vec4 arrays, with c and e
+layout(std140, binding = 0) uniform Misaligned
+{
+vec4 Misaligned_register0;
+vec4 Misaligned_register1[2];
+vec4 Misaligned_register3[3];
+vec4 Misaligned_register6[3];
+};
+out vec4 color;
+
+void main() { 
+int i= (floatBitsToInt(Misaligned_register6[(floatBitsToInt(Misaligned_register6[0].xy)).x].xy)).y;
+color= vec4 ( (Misaligned_register0.x), (Misaligned_register0.yz), (Misaligned_register1[i + 1].x)) + (Misaligned_register1[1].y) * mat3(Misaligned_register3[0].xyz, Misaligned_register3[1].xyz, Misaligned_register3[2].xyz)[ 0].x + (Misaligned_register3[2].w) + ( (floatBitsToUint(Misaligned_register6[2].z) != 0u) ?1.0: 0.0) *  (vec3 ( 1.0, 0.0, 0.0) * mat3(Misaligned_register3[0].xyz, Misaligned_register3[1].xyz, Misaligned_register3[2].xyz)).y;
+}
\ No newline at end of file
@@ -0,0 +1,26 @@
+// b, d and f follow members std140 would place later than HLSL. d shares the last register of the array c and f
+// the last register of the matrix e, so both of them are read from vec4 arrays, with c and e
+cbuffer Misaligned : register(b0)
+{
+    float a;
+    float2 b;
+    float c[2];
+    float d;
+    float3x3 e;
+    float f;
+    int2 g[3];
+    bool h;
+};
+
+struct PS_OUTPUT
+{
+    float4 color : SV_TARGET0;
+};
+
+PS_OUTPUT main()
+{
+    PS_OUTPUT output;
+    int i = g[g[0].x].y;
+    output.color = float4(a, b, c[i + 1]) + d * e[0].x + f + (h ? 1.0 : 0.0) * mul(float3(1.0, 0.0, 0.0), e).y;
+    return output;
+}
\ No newline at end of file
@@ -0,0 +1,20 @@
+#version 420
+
+// std140 would place scale and flags after their HLSL offsets, so both of their registers are vec4s and every use
+// of their members reads from them
+layout(std140, binding = 0) uniform Material
+{
+vec4 Material_register0;
+vec4 Material_register1;
+vec4 tint;
+};
+out vec4 color;
+
+float Shade( float metallic){
+if ( notEqual(floatBitsToUint(Material_register1.yz), uvec2(0u)).y){
+return metallic * (Material_register1.x);
+}return (Material_register0.x) * metallic + (Material_register0.yz).x;
+}void main() { 
+float s= Shade( 0.5);
+color= tint * s * vec4 ( (Material_register0.yz).y, (Material_register0.x), (floatBitsToInt(Material_register0.w)), (floatBitsToUint(Material_register1.w)));
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+// std140 would place scale and flags after their HLSL offsets, so both of their registers are vec4s and every use
+// of their members reads from them
+cbuffer Material : register(b0)
+{
+    float roughness;
+    float2 scale;
+    int mode;
+    float exposure;
+    bool2 flags;
+    uint layer;
+    float4 tint;
+};
+
+struct PS_OUTPUT
+{
+    float4 color : SV_TARGET0;
+};
+
+float Shade(float metallic)
+{
+    if (flags.y)
+    {
+        return metallic * exposure;
+    }
+    return roughness * metallic + scale.x;
+}
+
+PS_OUTPUT main()
+{
+    PS_OUTPUT output;
+    float s = Shade(0.5);
+    output.color = tint * s * float4(scale.y, roughness, mode, layer);
+    return output;
+}
\ No newline at end of file
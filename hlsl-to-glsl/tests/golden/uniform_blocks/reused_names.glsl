@@ -0,0 +1,17 @@
+#version 420
+
+// roughness would be read from a register, but a parameter has the same name: the block is declared as is rather
+// than replacing the parameter
+layout(std140, binding = 0) uniform Material
+{
+float roughness;
+vec2 scale;
+vec4 tint;
+};
+out vec4 color;
+
+float Shade( float roughness){
+return roughness * scale.x;
+}void main() { 
+color= tint * Shade( roughness);
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+// roughness would be read from a register, but a parameter has the same name: the block is declared as is rather
+// than replacing the parameter
+cbuffer Material : register(b0)
+{
+    float roughness;
+    float2 scale;
+    float4 tint;
+};
+
+struct PS_OUTPUT
+{
+    float4 color : SV_TARGET0;
+};
+
+float Shade(float roughness)
+{
+    return roughness * scale.x;
+}
+
+PS_OUTPUT main()
+{
+    PS_OUTPUT output;
+    output.color = tint * Shade(roughness);
+    return output;
+}
\ No newline at end of file
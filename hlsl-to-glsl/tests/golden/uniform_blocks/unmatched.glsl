@@ -0,0 +1,14 @@
+#version 420
+
+// k shares the last register of the array of matrices m, whose columns can't be read from vec4s with the index
+// of the matrix: the block is declared as is, and std140 places k elsewhere than HLSL
+layout(std140, binding = 0) uniform Misaligned
+{
+mat2 m[2];
+float k;
+};
+out vec4 color;
+
+void main() { 
+color= vec4 ( m[ 1][ 0], m[ 0][ 1]) * k;
+}
\ No newline at end of file
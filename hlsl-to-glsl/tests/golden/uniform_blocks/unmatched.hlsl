@@ -0,0 +1,19 @@
+// k shares the last register of the array of matrices m, whose columns can't be read from vec4s with the index
+// of the matrix: the block is declared as is, and std140 places k elsewhere than HLSL
+cbuffer Misaligned : register(b0)
+{
+    float2x2 m[2];
+    float k;
+};
+
+struct PS_OUTPUT
+{
+    float4 color : SV_TARGET0;
+};
+
+PS_OUTPUT main()
+{
+    PS_OUTPUT output;
+    output.color = float4(m[1][0], m[0][1]) * k;
+    return output;
+}
\ No newline at end of file